@@ -0,0 +1,92 @@
+#ifndef __AlignedAllocator_h
+#define __AlignedAllocator_h
+
+
+/**
+********************************************************************************
+*
+*   @file       AlignedAllocator.h
+*
+*   @brief      Allocator whose memory is aligned on a given boundary, e.g. a
+*               cache line, whichever the C++ standard.
+*
+*   @version    1.0
+*
+*   @date       19/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//  Include
+//******************************************************************************
+#include <cstddef> // Header file for size_t
+#include <cstdint> // Header file for uintptr_t
+#include <memory>
+#include <new>
+
+
+//==============================================================================
+/**
+*   @class  AlignedAllocator
+*   @brief  AlignedAllocator is std::allocator, except that the first element
+*           is aligned on anAlignment bytes (a power of two). Before C++17,
+*           std::allocator ignores the alignment of over-aligned types, e.g.
+*           a struct declared with alignas(64) may start anywhere in a
+*           std::vector. The memory is allocated with one more block of
+*           anAlignment bytes, and the address given by operator new is kept
+*           just before the first element to free it.
+*/
+//==============================================================================
+template<typename T, std::size_t anAlignment>
+class AlignedAllocator: public std::allocator<T>
+//------------------------------------------------------------------------------
+{
+//******************************************************************************
+public:
+    template<typename U>
+    struct rebind
+    {
+        typedef AlignedAllocator<U, anAlignment> other;
+    };
+
+
+    AlignedAllocator() {}
+
+
+    template<typename U>
+    AlignedAllocator(const AlignedAllocator<U, anAlignment>& anAllocator):
+            std::allocator<T>(anAllocator)
+    {}
+
+
+    /// Allocate aNumberOfElements elements, the first one is aligned
+    T* allocate(std::size_t aNumberOfElements, const void* = nullptr)
+    {
+        std::size_t size = aNumberOfElements * sizeof(T) + anAlignment + sizeof(void*);
+        char* p_memory = static_cast<char*>(::operator new(size));
+
+        // Room for the address of the memory, then the next boundary
+        std::uintptr_t address = reinterpret_cast<std::uintptr_t>(p_memory + sizeof(void*));
+        address = (address + anAlignment - 1) & ~std::uintptr_t(anAlignment - 1);
+
+        void** p_aligned = reinterpret_cast<void**>(address);
+        p_aligned[-1] = p_memory;
+
+        return reinterpret_cast<T*>(p_aligned);
+    }
+
+
+    /// Free the memory of allocate()
+    void deallocate(T* apElement, std::size_t)
+    {
+        ::operator delete(reinterpret_cast<void**>(apElement)[-1]);
+    }
+};
+
+
+#endif
@@ -0,0 +1,180 @@
+#ifndef __AsciiParser_h
+#define __AsciiParser_h
+
+
+/**
+********************************************************************************
+*
+*   @file       AsciiParser.h
+*
+*   @brief      Parser of the numbers of a text file, e.g. the pixels of an
+*               ASCII image or of an ASCII PGM file. The characters are
+*               classified with SIMD comparisons and the digits are converted
+*               eight at a time.
+*
+*   @version    1.0
+*
+*   @date       19/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//  Include
+//******************************************************************************
+#include <cstdint>
+#include <istream>
+#include <vector>
+
+#include "DefaultInitAllocator.h"
+
+
+//==============================================================================
+/**
+*   @class  AsciiParser
+*   @brief  AsciiParser reads the rest of a stream, then parses it line by
+*           line. A line is parsed as with std::stringstream and >> float:
+*           the numbers separated by spaces are read until the end of the
+*           line or the first invalid number, the rest of the line is
+*           ignored. The integers and the decimals without an exponent
+*           (e.g. "255", "-12.5") are converted directly, with the same
+*           result as std::strtof(); the other numbers (e.g. "1e-3",
+*           "-inf") are converted by std::strtof().
+*
+*           The text is processed in windows of WINDOW_SIZE characters:
+*           the classifyCharacters kernel (see ImageKernels) gives one bit
+*           per character for the digits, the spaces and the new lines, the
+*           spaces and the digits are then skipped a word of 64 bits at a
+*           time, and up to eight digits are converted at once, in a 64-bit
+*           integer.
+*/
+//==============================================================================
+class AsciiParser
+//------------------------------------------------------------------------------
+{
+//******************************************************************************
+public:
+    /// Container of the values, the same as Image::PixelVector
+    typedef std::vector<float, DefaultInitAllocator<float> > ValueVector;
+
+
+    /// Number of characters classified at once
+    static const unsigned int WINDOW_SIZE = 4096;
+
+
+    //--------------------------------------------------------------------------
+    /// Constructor. The rest of the stream, from its current position, is
+    /// read in memory.
+    /**
+    * @param anInputStream: the stream to parse, e.g. an open file
+    */
+    //--------------------------------------------------------------------------
+    AsciiParser(std::istream& anInputStream);
+
+
+    //--------------------------------------------------------------------------
+    /// Check if the whole text has been parsed.
+    /**
+    * @return true if there is no line left
+    */
+    //--------------------------------------------------------------------------
+    bool isEnd() const;
+
+
+    //--------------------------------------------------------------------------
+    /// First character of the next line.
+    /**
+    * @return the character, or '\0' at the end of the text
+    */
+    //--------------------------------------------------------------------------
+    char getNextCharacter() const;
+
+
+    //--------------------------------------------------------------------------
+    /// Skip the next line, e.g. a comment.
+    //--------------------------------------------------------------------------
+    void skipLine();
+
+
+    //--------------------------------------------------------------------------
+    /// Parse the numbers of the next line.
+    /**
+    * @param aValueSet: the container the values are appended to
+    * @return the number of values of the line
+    */
+    //--------------------------------------------------------------------------
+    unsigned int parseLine(ValueVector& aValueSet);
+
+
+//******************************************************************************
+private:
+    //--------------------------------------------------------------------------
+    /// Classify the characters from aPosition if the window does not hold
+    /// enough of them to parse a number.
+    /**
+    * @param aPosition: the position of the next character to parse
+    */
+    //--------------------------------------------------------------------------
+    void updateWindow(std::size_t aPosition);
+
+
+    //--------------------------------------------------------------------------
+    /// Number of consecutive characters of a class from a position of the
+    /// window.
+    /**
+    * @param apMask: the mask of the class in the window
+    * @param aPosition: the position of the first character
+    * @return the number of characters
+    */
+    //--------------------------------------------------------------------------
+    std::size_t getRunLength(const std::uint64_t* apMask, std::size_t aPosition) const;
+
+
+    //--------------------------------------------------------------------------
+    /// Parse a number from the current position.
+    /**
+    * @param aValue: the number
+    * @return false if there is no valid number
+    */
+    //--------------------------------------------------------------------------
+    bool parseNumber(float& aValue);
+
+
+    /// The text, followed by PADDING null characters
+    std::vector<char> m_text;
+
+
+    /// Number of characters of the text
+    std::size_t m_length;
+
+
+    /// Position of the next character to parse
+    std::size_t m_position;
+
+
+    /// Position of the first character of the window
+    std::size_t m_window_start;
+
+
+    /// Position after the last character of the window
+    std::size_t m_window_end;
+
+
+    /// Digits of the window, one bit per character
+    std::uint64_t m_p_digit_mask[WINDOW_SIZE / 64];
+
+
+    /// Spaces of the window, except the new lines
+    std::uint64_t m_p_space_mask[WINDOW_SIZE / 64];
+
+
+    /// New lines of the window
+    std::uint64_t m_p_new_line_mask[WINDOW_SIZE / 64];
+};
+
+
+#endif
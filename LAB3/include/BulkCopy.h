@@ -0,0 +1,74 @@
+#ifndef __BulkCopy_h
+#define __BulkCopy_h
+
+
+/**
+********************************************************************************
+*
+*   @file       BulkCopy.h
+*
+*   @brief      Copy of large pixel arrays, e.g. by the copy constructors and
+*               the assignment operators of the images. Above a threshold,
+*               the array is split between several threads and copied with
+*               non-temporal stores, which bypass the caches.
+*
+*   @version    1.0
+*
+*   @date       19/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//  Include
+//******************************************************************************
+#include <cstddef>
+
+
+//------------------------------------------------------------------------------
+/// Copy aNumberOfPixels pixels. Below the threshold (see
+/// getBulkCopyThreshold()), std::copy is used: the output stays in the
+/// caches, ready for the next filter. Above it, the output would not fit
+/// anyway and would only evict useful data: every thread copies one part
+/// of the array with the streamCopy kernel (see ImageKernels).
+/**
+* @param apInput: the pixels to copy
+* @param apOutput: where to copy them, the arrays must not overlap
+* @param aNumberOfPixels: the number of pixels
+* @param aNumberOfThreads: the number of threads above the threshold,
+*        0 for as many as allowed CPUs (see CpuTopology)
+*/
+//------------------------------------------------------------------------------
+void bulkCopy(const float* apInput,
+              float* apOutput,
+              std::size_t aNumberOfPixels,
+              unsigned int aNumberOfThreads = 0);
+
+
+//------------------------------------------------------------------------------
+/// Number of pixels from which bulkCopy() is parallel and bypasses the
+/// caches. By default, the number of pixels of an array that, with its
+/// copy, fills the last-level cache.
+/**
+* @return the threshold
+*/
+//------------------------------------------------------------------------------
+std::size_t getBulkCopyThreshold();
+
+
+//------------------------------------------------------------------------------
+/// Set the number of pixels from which bulkCopy() is parallel and bypasses
+/// the caches, e.g. 0 to always do it, or to benchmark both copies. It must
+/// be called before the images are copied by several threads.
+/**
+* @param aNumberOfPixels: the new threshold
+*/
+//------------------------------------------------------------------------------
+void setBulkCopyThreshold(std::size_t aNumberOfPixels);
+
+
+#endif
@@ -0,0 +1,193 @@
+#ifndef __CpuTopology_h
+#define __CpuTopology_h
+
+
+/**
+********************************************************************************
+*
+*   @file       CpuTopology.h
+*
+*   @brief      Class to discover the CPU topology of the node (sockets,
+*               physical cores, SMT siblings) and the CPUs the process is
+*               allowed to use (affinity mask, cgroup quota, SLURM).
+*
+*   @version    1.0
+*
+*   @date       19/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//  Include
+//******************************************************************************
+#include <string>
+#include <vector>
+
+
+//==============================================================================
+/**
+*   @class  CpuTopology
+*   @brief  CpuTopology describes the logical CPUs of the node and resolves
+*           a requested number of threads against them.
+*/
+//==============================================================================
+class CpuTopology
+//------------------------------------------------------------------------------
+{
+//******************************************************************************
+public:
+    //--------------------------------------------------------------------------
+    /// Topology of the node the process runs on, discovered once.
+    /**
+    * @return the topology
+    */
+    //--------------------------------------------------------------------------
+    static const CpuTopology& getInstance();
+
+
+    //------------------------------------------------------------------------
+    /// Number of sockets (physical packages).
+    /**
+    * @return the number of sockets
+    */
+    //------------------------------------------------------------------------
+    unsigned int getNumberOfSockets() const;
+
+
+    //------------------------------------------------------------------------
+    /// Number of physical cores of the node.
+    /**
+    * @return the number of physical cores
+    */
+    //------------------------------------------------------------------------
+    unsigned int getNumberOfPhysicalCores() const;
+
+
+    //------------------------------------------------------------------------
+    /// Number of logical CPUs of the node (physical cores x SMT siblings).
+    /**
+    * @return the number of logical CPUs
+    */
+    //------------------------------------------------------------------------
+    unsigned int getNumberOfLogicalCPUs() const;
+
+
+    //------------------------------------------------------------------------
+    /// Number of logical CPUs the process is allowed to use. It takes into
+    /// account the affinity mask (cpuset cgroup, SLURM binding), the cgroup
+    /// CPU quota and SLURM_CPUS_PER_TASK.
+    /**
+    * @return the number of allowed logical CPUs
+    */
+    //------------------------------------------------------------------------
+    unsigned int getNumberOfAllowedCPUs() const;
+
+
+    //------------------------------------------------------------------------
+    /// Number of physical cores that have at least one allowed logical CPU.
+    /**
+    * @return the number of allowed physical cores
+    */
+    //------------------------------------------------------------------------
+    unsigned int getNumberOfAllowedPhysicalCores() const;
+
+
+    //------------------------------------------------------------------------
+    /// Resolve a requested number of threads against the topology.
+    /// 0 means as many threads as allowed CPUs (or allowed physical cores).
+    /// A warning is printed if the number is larger than the number of
+    /// allowed CPUs. If only physical cores are used, the number is capped
+    /// to the number of allowed physical cores.
+    /**
+    * @param aNumberOfThreads: the requested number of threads
+    * @param aPhysicalCoresOnlyFlag: use one thread per physical core at most
+    * @return the number of threads to use
+    */
+    //------------------------------------------------------------------------
+    unsigned int resolveNumberOfThreads(unsigned int aNumberOfThreads,
+                                        bool aPhysicalCoresOnlyFlag = false) const;
+
+
+    //------------------------------------------------------------------------
+    /// Restrict the affinity of the process to one logical CPU per allowed
+    /// physical core, so that the threads created afterwards do not share
+    /// a core with an SMT sibling.
+    /**
+    * @return true if the affinity has been changed, false otherwise
+    */
+    //------------------------------------------------------------------------
+    bool bindToPhysicalCores() const;
+
+
+    //------------------------------------------------------------------------
+    /// Human readable description of the topology.
+    /**
+    * @return the description
+    */
+    //------------------------------------------------------------------------
+    std::string toString() const;
+
+
+    //------------------------------------------------------------------------
+    /// Topology as CSV fields:
+    /// sockets,physical_cores,logical_cpus,allowed_cpus
+    /**
+    * @return the CSV fields
+    */
+    //------------------------------------------------------------------------
+    std::string toCSV() const;
+
+
+    //------------------------------------------------------------------------
+    /// Header of the CSV fields returned by toCSV().
+    /**
+    * @return the CSV header
+    */
+    //------------------------------------------------------------------------
+    static std::string getCSVHeader();
+
+
+//******************************************************************************
+private:
+    //--------------------------------------------------------------------------
+    /// Default constructor. Discover the topology.
+    //--------------------------------------------------------------------------
+    CpuTopology();
+
+
+    /// Logical CPU as seen in /sys/devices/system/cpu
+    struct LogicalCPU
+    {
+        unsigned int id;
+        int socket_id;
+        int core_id;
+        bool is_allowed;
+    };
+
+
+    /// All the logical CPUs of the node
+    std::vector<LogicalCPU> m_logical_cpu_set;
+
+
+    /// Number of sockets
+    unsigned int m_number_of_sockets;
+
+
+    /// Number of physical cores
+    unsigned int m_number_of_physical_cores;
+
+
+    /// Number of allowed physical cores
+    unsigned int m_number_of_allowed_physical_cores;
+
+
+    /// Number of allowed logical CPUs
+    unsigned int m_number_of_allowed_cpus;
+};
+
+#endif
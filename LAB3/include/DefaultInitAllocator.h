@@ -0,0 +1,85 @@
+#ifndef __DefaultInitAllocator_h
+#define __DefaultInitAllocator_h
+
+
+/**
+********************************************************************************
+*
+*   @file       DefaultInitAllocator.h
+*
+*   @brief      Allocator whose elements are default-initialised instead of
+*               value-initialised, e.g. std::vector<float>(n) does not write
+*               n zeros.
+*
+*   @version    1.0
+*
+*   @date       19/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//  Include
+//******************************************************************************
+#include <memory>
+#include <new>
+#include <utility>
+
+
+//==============================================================================
+/**
+*   @class  DefaultInitAllocator
+*   @brief  DefaultInitAllocator is std::allocator, except that the elements
+*           constructed without a value are default-initialised: for a
+*           number, the memory is not written at all. The pages of the
+*           memory are then placed (first touch) by the threads that write
+*           the elements first, e.g. the threads of a filter, not by the
+*           thread that allocates the memory. The elements constructed with
+*           a value (e.g. std::vector(n, 0.0f), resize(n, 0.0f)) or copied
+*           are initialised as usual.
+*/
+//==============================================================================
+template<typename T>
+class DefaultInitAllocator: public std::allocator<T>
+//------------------------------------------------------------------------------
+{
+//******************************************************************************
+public:
+    template<typename U>
+    struct rebind
+    {
+        typedef DefaultInitAllocator<U> other;
+    };
+
+
+    DefaultInitAllocator() {}
+
+
+    template<typename U>
+    DefaultInitAllocator(const DefaultInitAllocator<U>& anAllocator):
+            std::allocator<T>(anAllocator)
+    {}
+
+
+    /// Default-initialise an element
+    template<typename U>
+    void construct(U* apElement)
+    {
+        ::new(static_cast<void*>(apElement)) U;
+    }
+
+
+    /// Construct an element from a value, or from several arguments
+    template<typename U, typename... Args>
+    void construct(U* apElement, Args&&... anArgumentSet)
+    {
+        ::new(static_cast<void*>(apElement)) U(std::forward<Args>(anArgumentSet)...);
+    }
+};
+
+
+#endif
@@ -0,0 +1,290 @@
+#ifndef __HalfImage_h
+#define __HalfImage_h
+
+
+/**
+********************************************************************************
+*
+*   @file       HalfImage.h
+*
+*   @brief      Greyscale image stored with 16-bit floating-point numbers
+*               (FP16 or BF16), e.g. for intermediate results that are only
+*               visualised. The filters compute in single precision.
+*
+*   @version    1.0
+*
+*   @date       19/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//  Include
+//******************************************************************************
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Image.h"
+#include "DefaultInitAllocator.h"
+
+
+//==============================================================================
+/**
+*   @class  HalfImage
+*   @brief  HalfImage stores every pixel on 16 bits instead of 32, which
+*           halves the memory and the bandwidth of every pass. The filters
+*           convert blocks of pixels to float (F16C or AVX-512 instructions
+*           when available, see ImageKernels), apply the same kernels as
+*           Image, and round the results back to 16 bits.
+*/
+//==============================================================================
+class HalfImage
+//------------------------------------------------------------------------------
+{
+//******************************************************************************
+public:
+    /// Storage format of the pixels
+    enum Format
+    {
+        /// IEEE 754 half precision: 11 significant bits, up to 65504
+        FP16,
+
+        /// bfloat16: 8 significant bits, same range as float
+        BF16
+    };
+
+
+    //--------------------------------------------------------------------------
+    /// Name of a format.
+    /**
+    * @param aFormat: the format
+    * @return "fp16" or "bf16"
+    */
+    //--------------------------------------------------------------------------
+    static std::string getFormatName(Format aFormat);
+
+
+    //--------------------------------------------------------------------------
+    /// Format from its name.
+    /**
+    * @param aName: "fp16" or "bf16" (the case does not matter)
+    * @return the format
+    */
+    //--------------------------------------------------------------------------
+    static Format getFormat(const std::string& aName);
+
+
+    //--------------------------------------------------------------------------
+    /// Default constructor.
+    /**
+    * @param aFormat: the storage format
+    */
+    //--------------------------------------------------------------------------
+    HalfImage(Format aFormat = FP16);
+
+
+    //--------------------------------------------------------------------------
+    /// Constructor from a single-precision image, every pixel is rounded to
+    /// the nearest 16-bit value.
+    /**
+    * @param anImage: the image to convert
+    * @param aFormat: the storage format
+    */
+    //--------------------------------------------------------------------------
+    HalfImage(const Image& anImage, Format aFormat = FP16);
+
+
+    //--------------------------------------------------------------------------
+    /// Convert to a single-precision image, exactly.
+    /**
+    * @return the new image
+    */
+    //--------------------------------------------------------------------------
+    Image toImage() const;
+
+
+    //--------------------------------------------------------------------------
+    /// Number of pixels along the horizontal axis
+    /**
+    * @return the width
+    */
+    //--------------------------------------------------------------------------
+    unsigned int getWidth() const;
+
+
+    //--------------------------------------------------------------------------
+    /// Number of pixels along the vertical axis
+    /**
+    * @return the height
+    */
+    //--------------------------------------------------------------------------
+    unsigned int getHeight() const;
+
+
+    //--------------------------------------------------------------------------
+    /// Storage format of the pixels
+    /**
+    * @return the format
+    */
+    //--------------------------------------------------------------------------
+    Format getFormat() const;
+
+
+    //--------------------------------------------------------------------------
+    /// Compute the minimum and the maximum pixel values in one pass
+    /**
+    * @param aMinValue: the minimum pixel
+    * @param aMaxValue: the maximum pixel
+    */
+    //--------------------------------------------------------------------------
+    void getMinMaxValues(float& aMinValue, float& aMaxValue) const;
+
+
+    //--------------------------------------------------------------------------
+    /// Largest errors of the pixel values with respect to a reference,
+    /// e.g. the same image computed in single precision. Pixels that are
+    /// equal (including infinities) or both NaN have no error.
+    /**
+    * @param aReference: the reference image, of the same size
+    * @param aMaxAbsoluteError: the largest |pixel - reference|
+    * @param aMaxRelativeError: the largest |pixel - reference| / |reference|
+    *        for the finite, non-zero reference values
+    */
+    //--------------------------------------------------------------------------
+    void getError(const Image& aReference,
+                  float& aMaxAbsoluteError,
+                  float& aMaxRelativeError) const;
+
+
+    //--------------------------------------------------------------------------
+    /// Save the image in an ASCII file
+    /**
+    * @param aFileName: the name of the file to write
+    */
+    //--------------------------------------------------------------------------
+    void saveASCII(const std::string& aFileName) const;
+
+
+    //--------------------------------------------------------------------------
+    /// Negation operator (see Image::operator!()).
+    /**
+    * @return the negative image
+    */
+    //--------------------------------------------------------------------------
+    HalfImage operator!() const;
+
+
+    //--------------------------------------------------------------------------
+    /// Add aShiftValue to every pixel, then multiply every pixel
+    /// by aScaleValue
+    /**
+    * @param aShiftValue: the shift parameter of the filter
+    * @param aScaleValue: the scale parameter of the filter
+    * @return the new image
+    */
+    //--------------------------------------------------------------------------
+    HalfImage shiftScaleFilter(float aShiftValue, float aScaleValue) const;
+
+
+    //--------------------------------------------------------------------------
+    /// Normalise the image between 0 and 1
+    /**
+    * @return the new image
+    */
+    //--------------------------------------------------------------------------
+    HalfImage getNormalised() const;
+
+
+    //--------------------------------------------------------------------------
+    /// Apply a log filter on the image (see Image::getLogMode())
+    /**
+    * @return the new image
+    */
+    //--------------------------------------------------------------------------
+    HalfImage logFilter() const;
+
+
+    //--------------------------------------------------------------------------
+    /// Flip the image horizontally, the pixels are not converted
+    /**
+    * @return the new image
+    */
+    //--------------------------------------------------------------------------
+    HalfImage flipHorizontally() const;
+
+
+    //--------------------------------------------------------------------------
+    /// Flip the image vertically, the pixels are not converted
+    /**
+    * @return the new image
+    */
+    //--------------------------------------------------------------------------
+    HalfImage flipVertically() const;
+
+
+//******************************************************************************
+private:
+    //--------------------------------------------------------------------------
+    /// Constructor of an image whose pixels are not initialised, e.g. the
+    /// output of a filter.
+    /**
+    * @param aWidth: the width of the image
+    * @param aHeight: the height of the image
+    * @param aFormat: the storage format
+    * @param aTag: Image::NO_INIT
+    */
+    //--------------------------------------------------------------------------
+    HalfImage(unsigned int aWidth,
+              unsigned int aHeight,
+              Format aFormat,
+              Image::NoInit aTag);
+
+
+    //--------------------------------------------------------------------------
+    /// Apply a point operator to every pixel: blocks of pixels are converted
+    /// to float, processed by anOperation(input, output, size), and
+    /// converted back.
+    /**
+    * @param anOperation: the operator
+    * @return the new image
+    */
+    //--------------------------------------------------------------------------
+    template<typename BlockOperation>
+    HalfImage applyPointOperator(BlockOperation anOperation) const;
+
+
+    //--------------------------------------------------------------------------
+    /// Convert pixels to float
+    //--------------------------------------------------------------------------
+    void toFloat(const std::uint16_t* apInput, float* apOutput, unsigned int aNumberOfPixels) const;
+
+
+    //--------------------------------------------------------------------------
+    /// Convert pixels from float
+    //--------------------------------------------------------------------------
+    void fromFloat(const float* apInput, std::uint16_t* apOutput, unsigned int aNumberOfPixels) const;
+
+
+    /// Number of pixel along the horizontal axis
+    unsigned int m_width;
+
+
+    /// Number of pixel along the vertical axis
+    unsigned int m_height;
+
+
+    /// Storage format of the pixels
+    Format m_format;
+
+
+    /// The pixel data, not initialised unless a value is given
+    std::vector<std::uint16_t, DefaultInitAllocator<std::uint16_t> > m_p_image;
+};
+
+
+#endif
@@ -28,6 +28,11 @@
 #include <string>
 #include <vector>
 
+#include "DefaultInitAllocator.h"
+
+
+class PointLUT;
+
 
 //==============================================================================
 /**
@@ -40,6 +45,100 @@ class Image
 {
 //******************************************************************************
 public:
+    /// How getSum(), getAverage() and getVariance() add the pixel values
+    enum SummationMode
+    {
+        /// Float accumulation, the result depends on the number of threads
+        FAST_SUMMATION,
+
+        /// Exact accumulation (see ReproducibleAccumulator), the result is
+        /// bit-identical whatever the number of threads or processes
+        REPRODUCIBLE_SUMMATION
+    };
+
+
+    /// How logFilter() computes the logarithm, and applyPointFunction()
+    /// the logarithm, the exponential and the power
+    enum LogMode
+    {
+        /// std::log, std::exp and std::pow of the C++ library (libm), in
+        /// double precision
+        EXACT_LOG,
+
+        /// SIMD kernels in single precision (see ImageKernels::fastLog,
+        /// fastExp and fastPow), at most FAST_LOG_MAX_ULP_ERROR,
+        /// FAST_EXP_MAX_ULP_ERROR and FAST_POW_MAX_ULP_ERROR ULP away from
+        /// the exact results
+        FAST_LOG
+    };
+
+
+    /// Functions of applyPointFunction()
+    enum PointFunction
+    {
+        /// log(x), the same as logFilter()
+        LOG_FUNCTION,
+
+        /// exp(x)
+        EXP_FUNCTION,
+
+        /// pow(x, p), e.g. a gamma correction of a normalised image
+        POW_FUNCTION,
+
+        /// sqrt(x), correctly rounded whatever the log mode
+        SQRT_FUNCTION
+    };
+
+
+    /// Tag of the constructors that do not initialise the pixels, e.g. for
+    /// the output of a filter that writes every pixel straight away
+    enum NoInit
+    {
+        NO_INIT
+    };
+
+
+    /// Container of the pixels. The pixels are not initialised unless a
+    /// value is given (see DefaultInitAllocator).
+    typedef std::vector<float, DefaultInitAllocator<float> > PixelVector;
+
+
+    //--------------------------------------------------------------------------
+    /// Set the summation mode of all the images (default: FAST_SUMMATION).
+    /**
+    * @param aMode: the summation mode
+    */
+    //--------------------------------------------------------------------------
+    static void setSummationMode(SummationMode aMode);
+
+
+    //--------------------------------------------------------------------------
+    /// Get the summation mode of all the images.
+    /**
+    * @return the summation mode
+    */
+    //--------------------------------------------------------------------------
+    static SummationMode getSummationMode();
+
+
+    //--------------------------------------------------------------------------
+    /// Set the log mode of all the images (default: EXACT_LOG).
+    /**
+    * @param aMode: the log mode
+    */
+    //--------------------------------------------------------------------------
+    static void setLogMode(LogMode aMode);
+
+
+    //--------------------------------------------------------------------------
+    /// Get the log mode of all the images.
+    /**
+    * @return the log mode
+    */
+    //--------------------------------------------------------------------------
+    static LogMode getLogMode();
+
+
     //--------------------------------------------------------------------------
     /// Default constructor.
     //--------------------------------------------------------------------------
@@ -80,6 +179,20 @@ public:
                 float aDefaultValue = 0.0);
 
 
+    //------------------------------------------------------------------------
+    /// Constructor to build an image whose pixels are not initialised. Every
+    /// pixel must be written before it is read.
+    /**
+    * @param aWidth: the width of the image
+    * @param aHeight: the height of the image
+    * @param aTag: NO_INIT
+    */
+    //------------------------------------------------------------------------
+    Image(unsigned int aWidth,
+          unsigned int aHeight,
+          NoInit aTag);
+
+
     //------------------------------------------------------------------------
     /// Destructor.
     //------------------------------------------------------------------------
@@ -167,6 +280,16 @@ public:
     float getMaxValue() const;
 
 
+    //------------------------------------------------------------------------
+    /// Compute the minimum and the maximum pixel values in one pass
+    /**
+    * @param aMinValue: the minimum pixel
+    * @param aMaxValue: the maximum pixel
+    */
+    //------------------------------------------------------------------------
+    void getMinMaxValues(float& aMinValue, float& aMaxValue) const;
+
+
     //------------------------------------------------------------------------
     /// Compute the sum of all the pixel values of the image
     /**
@@ -306,6 +429,23 @@ public:
     bool operator!=(const Image& anImage) const;
 
 
+    //------------------------------------------------------------------------
+    /// Compare with an image of the same size, pixel by pixel, and stop at
+    /// the first pixel that differs by more than aTolerance (or is NaN)
+    /**
+    * @param anImage: the image to compare with
+    * @param aTolerance: the largest difference between similar pixels
+    * @param aMaxDifference: the largest difference of the pixels up to the
+    *        first mismatch (included)
+    * @return the index of the first mismatch, or the number of pixels if
+    *         the images are similar
+    */
+    //------------------------------------------------------------------------
+    unsigned int findFirstMismatch(const Image& anImage,
+                                   float aTolerance,
+                                   float& aMaxDifference) const;
+
+
     //------------------------------------------------------------------------
     /// Negation operator. Compute the negative of the current image.
     /**
@@ -354,6 +494,30 @@ public:
     Image logFilter() const;
 
 
+    //------------------------------------------------------------------------
+    /// Apply a function to every pixel, with the SIMD kernels of the
+    /// image kernels (see getLogMode() for the accuracy)
+    /**
+    * @param aFunction: the function
+    * @param aParameter: the parameter of the function, i.e. the exponent
+    *        p of POW_FUNCTION, unused otherwise
+    * @return the new image
+    */
+    //------------------------------------------------------------------------
+    Image applyPointFunction(PointFunction aFunction, float aParameter = 1.0) const;
+
+
+    //------------------------------------------------------------------------
+    /// Apply a lookup table on the image, e.g. a chain of point operators
+    /// on an 8-bit image (see PointLUT)
+    /**
+    * @param aLUT: the lookup table
+    * @return the new image
+    */
+    //------------------------------------------------------------------------
+    Image applyLUT(const PointLUT& aLUT) const;
+
+
     //------------------------------------------------------------------------
     /// Flip the image horizonatally
     /**
@@ -372,8 +536,44 @@ public:
     Image flipVertically() const;
 
 
+    //------------------------------------------------------------------------
+    /// Flip the image horizonatally without creating a new image
+    /**
+    * @return the updated version of the current image
+    */
+    //------------------------------------------------------------------------
+    Image& flipHorizontallyInPlace();
+
+
+    //------------------------------------------------------------------------
+    /// Flip the image vertically without creating a new image
+    /**
+    * @return the updated version of the current image
+    */
+    //------------------------------------------------------------------------
+    Image& flipVerticallyInPlace();
+
+
 //******************************************************************************
 protected:
+    //------------------------------------------------------------------------
+    /// Apply a function to a range of pixels with the kernel of the log
+    /// mode, e.g. the range of a thread
+    /**
+    * @param aFunction: the function
+    * @param aParameter: the parameter of the function
+    * @param apInput: the input pixels
+    * @param apOutput: the output pixels
+    * @param aNumberOfPixels: the number of pixels
+    */
+    //------------------------------------------------------------------------
+    static void applyPointFunction(PointFunction aFunction,
+                                   float aParameter,
+                                   const float* apInput,
+                                   float* apOutput,
+                                   unsigned int aNumberOfPixels);
+
+
     /// Number of pixel along the horizontal axis
     unsigned int m_width;
 
@@ -383,7 +583,15 @@ protected:
 
 
     /// The pixel data
-    std::vector<float> m_p_image;
+    PixelVector m_p_image;
+
+
+    /// The summation mode of all the images
+    static SummationMode m_summation_mode;
+
+
+    /// The log mode of all the images
+    static LogMode m_log_mode;
 };
 
 #endif
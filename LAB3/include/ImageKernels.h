@@ -0,0 +1,254 @@
+#ifndef __ImageKernels_h
+#define __ImageKernels_h
+
+
+/**
+********************************************************************************
+*
+*   @file       ImageKernels.h
+*
+*   @brief      Per-pixel, per-row and reduction kernels shared by all the
+*               implementations (serial, Pthread, OpenMP, MPI, etc.). Every
+*               kernel is compiled once per instruction set (scalar, AVX2,
+*               AVX-512), and the best variant supported by the CPU is
+*               selected when the program starts.
+*
+*   @version    1.0
+*
+*   @date       19/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//  Include
+//******************************************************************************
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ReproducibleAccumulator.h"
+
+
+//------------------------------------------------------------------------------
+/// Maximum error of the fastLog kernel in units in the last place (ULP). The
+/// largest error measured on every positive float, against the logarithm
+/// computed in double precision, is 0.83 ULP.
+//------------------------------------------------------------------------------
+#define FAST_LOG_MAX_ULP_ERROR 1
+
+
+//------------------------------------------------------------------------------
+/// Maximum error of the fastExp kernel in ULP. The largest error measured on
+/// every float in [-104, 89], against the exponential computed in double
+/// precision, is 0.99 ULP.
+//------------------------------------------------------------------------------
+#define FAST_EXP_MAX_ULP_ERROR 1
+
+
+//------------------------------------------------------------------------------
+/// Maximum error of the fastPow kernel in ULP, for the exponents in
+/// [-FAST_POW_MAX_EXPONENT, FAST_POW_MAX_EXPONENT]. The largest error
+/// measured on every positive float, for the exponents 0.1, 1/2.2, 0.5, 1.5,
+/// 2.2, 3, -1 and -2.5, is 1.51 ULP. The error of the logarithm is
+/// multiplied by the exponent: about 0.4 * |exponent| ULP above (4.4 ULP
+/// for 10, 40 ULP for 100).
+//------------------------------------------------------------------------------
+#define FAST_POW_MAX_ULP_ERROR 2
+#define FAST_POW_MAX_EXPONENT 3
+
+
+//==============================================================================
+/**
+*   @struct ImageKernels
+*   @brief  Kernels of one instruction set. They work on a contiguous range
+*           of pixels (or on one row): the implementations only decide which
+*           range every thread or process processes. All the variants give
+*           bit-identical results, floating-point contractions (FMA) are
+*           disabled.
+*/
+//==============================================================================
+struct ImageKernels
+{
+    /// Name of the instruction set: "scalar", "avx2" or "avx512"
+    const char* isa;
+
+
+    /// apOutput[i] = aMin + aRange * (1 - (apInput[i] - aMin) / aRange)
+    void (*negate)(const float* apInput, float* apOutput, unsigned int aNumberOfPixels,
+                   float aMin, float aRange);
+
+
+    /// apOutput[i] = (apInput[i] + aShift) * aScale
+    void (*shiftScale)(const float* apInput, float* apOutput, unsigned int aNumberOfPixels,
+                       float aShift, float aScale);
+
+
+    /// apOutput[i] = log(apInput[i]) with the C library, in double precision
+    void (*log)(const float* apInput, float* apOutput, unsigned int aNumberOfPixels);
+
+
+    /// apOutput[i] = log(apInput[i]) in single precision, at most
+    /// FAST_LOG_MAX_ULP_ERROR ULP of error. log(+/-0) = -inf,
+    /// log(x < 0) = NaN, log(+inf) = +inf, log(NaN) = NaN, subnormal
+    /// inputs are supported.
+    void (*fastLog)(const float* apInput, float* apOutput, unsigned int aNumberOfPixels);
+
+
+    /// apOutput[i] = exp(apInput[i]) with the C library, in double precision
+    void (*exp)(const float* apInput, float* apOutput, unsigned int aNumberOfPixels);
+
+
+    /// apOutput[i] = exp(apInput[i]) in single precision, at most
+    /// FAST_EXP_MAX_ULP_ERROR ULP of error. exp(-inf) = 0, exp(+inf) = +inf,
+    /// exp(NaN) = NaN, the subnormal results are supported.
+    void (*fastExp)(const float* apInput, float* apOutput, unsigned int aNumberOfPixels);
+
+
+    /// apOutput[i] = pow(apInput[i], aExponent) with the C library, in
+    /// double precision
+    void (*pow)(const float* apInput, float* apOutput, unsigned int aNumberOfPixels,
+                float aExponent);
+
+
+    /// apOutput[i] = pow(apInput[i], aExponent), at most
+    /// FAST_POW_MAX_ULP_ERROR ULP of error for the exponents in
+    /// [-FAST_POW_MAX_EXPONENT, FAST_POW_MAX_EXPONENT]. The special values
+    /// are the ones of the C library. The exponents 0 and 1, and the ones
+    /// that are not finite, use the C library.
+    void (*fastPow)(const float* apInput, float* apOutput, unsigned int aNumberOfPixels,
+                    float aExponent);
+
+
+    /// apOutput[i] = sqrt(apInput[i]), correctly rounded
+    void (*sqrt)(const float* apInput, float* apOutput, unsigned int aNumberOfPixels);
+
+
+    /// apOutput[i] = apTable[apInput[i]]: every value is clamped to
+    /// [0, aTableSize - 1] (NaN to 0), then truncated to get the index
+    void (*applyLUT)(const float* apInput, float* apOutput, unsigned int aNumberOfPixels,
+                     const float* apTable, unsigned int aTableSize);
+
+
+    /// Convert to IEEE 754 half precision (FP16), rounded to the nearest
+    /// even value. Values of 65520 or more become infinity.
+    void (*floatToHalf)(const float* apInput, std::uint16_t* apOutput, unsigned int aNumberOfPixels);
+
+
+    /// Convert from IEEE 754 half precision (FP16), exactly
+    void (*halfToFloat)(const std::uint16_t* apInput, float* apOutput, unsigned int aNumberOfPixels);
+
+
+    /// Convert to bfloat16 (BF16, the 16 upper bits of a float), rounded to
+    /// the nearest even value
+    void (*floatToBFloat16)(const float* apInput, std::uint16_t* apOutput, unsigned int aNumberOfPixels);
+
+
+    /// Convert from bfloat16 (BF16), exactly
+    void (*bfloat16ToFloat)(const std::uint16_t* apInput, float* apOutput, unsigned int aNumberOfPixels);
+
+
+    /// apOutput[i] = apInput[aWidth - i - 1], the rows must not overlap
+    void (*reverseRow)(const float* apInput, float* apOutput, unsigned int aWidth);
+
+
+    /// Reverse a row in place
+    void (*reverseRowInPlace)(float* apRow, unsigned int aWidth);
+
+
+    /// apOutput[i] = apInput[i] with non-temporal stores, which bypass the
+    /// caches (see bulkCopy() in BulkCopy.h), the ranges must not overlap
+    void (*streamCopy)(const float* apInput, float* apOutput, unsigned int aNumberOfPixels);
+
+
+    /// Smallest and largest values of the range in one pass, NaN values
+    /// are ignored (+infinity and -infinity if the range is empty)
+    void (*getMinMax)(const float* apInput, unsigned int aNumberOfPixels,
+                      float& aMin, float& aMax);
+
+
+    /// Sum of the values of the range, with 32 interleaved partial sums
+    /// (see ImageKernelsImpl.h for the order of the additions)
+    float (*getSum)(const float* apInput, unsigned int aNumberOfPixels);
+
+
+    /// Sum of (apInput[i] - aMean)^2, in the same order as getSum
+    float (*getSumOfSquaredDifferences)(const float* apInput, unsigned int aNumberOfPixels,
+                                        float aMean);
+
+
+    /// Add every value of the range to an exact accumulator
+    void (*accumulate)(const float* apInput, unsigned int aNumberOfPixels,
+                       ReproducibleAccumulator& anAccumulator);
+
+
+    /// Add every (apInput[i] - aMean)^2 to an exact accumulator
+    void (*accumulateSquaredDifferences)(const float* apInput, unsigned int aNumberOfPixels,
+                                         float aMean,
+                                         ReproducibleAccumulator& anAccumulator);
+
+
+    /// Index of the first pixel such that |apInput1[i] - apInput2[i]| is
+    /// greater than aTolerance or NaN (aNumberOfPixels if there is none).
+    /// The search stops there: aMaxDifference is the largest difference of
+    /// the pixels up to this one (included).
+    unsigned int (*compare)(const float* apInput1, const float* apInput2,
+                            unsigned int aNumberOfPixels,
+                            float aTolerance, float& aMaxDifference);
+
+
+    /// Classify the characters of a text (see AsciiParser): bit j of
+    /// apDigitMask[k] is set if apText[64 * k + j] is a digit, bit j of
+    /// apSpaceMask[k] if it is ' ', '\t', '\v', '\f' or '\r', and bit j of
+    /// apNewLineMask[k] if it is '\n'. Every mask has (aLength + 63) / 64
+    /// words, the bits after aLength are 0.
+    void (*classifyCharacters)(const char* apText, unsigned int aLength,
+                               std::uint64_t* apDigitMask,
+                               std::uint64_t* apSpaceMask,
+                               std::uint64_t* apNewLineMask);
+};
+
+
+//------------------------------------------------------------------------------
+/// Kernels of the selected instruction set. By default, the widest one
+/// supported by both the binary and the CPU.
+/**
+* @return the kernels
+*/
+//------------------------------------------------------------------------------
+const ImageKernels& getImageKernels();
+
+
+//------------------------------------------------------------------------------
+/// Select the instruction set of the kernels, e.g. to benchmark every
+/// variant. It must be called before the kernels are used by several threads.
+/**
+* @param anISA: "scalar", "avx2", "avx512", or "auto" for the widest one
+*/
+//------------------------------------------------------------------------------
+void setImageKernelISA(const std::string& anISA);
+
+
+//------------------------------------------------------------------------------
+/// Name of the instruction set of the selected kernels.
+/**
+* @return "scalar", "avx2" or "avx512"
+*/
+//------------------------------------------------------------------------------
+std::string getImageKernelISA();
+
+
+//------------------------------------------------------------------------------
+/// Instruction sets supported by both the binary and the CPU.
+/**
+* @return the names of the instruction sets, from the narrowest to the widest
+*/
+//------------------------------------------------------------------------------
+std::vector<std::string> getAvailableImageKernelISAs();
+
+
+#endif
@@ -0,0 +1,1890 @@
+/**
+********************************************************************************
+*
+*   @file       ImageKernelsImpl.h
+*
+*   @brief      Bodies of the image kernels. This file is included by one
+*               translation unit per instruction set, after defining:
+*                 - IMAGE_KERNELS_NAMESPACE: the namespace of the variant,
+*                 - IMAGE_KERNELS_ISA: the name of the variant,
+*                 - IMAGE_KERNELS_USE_AVX2 or IMAGE_KERNELS_USE_AVX512
+*                   (optional): to use the intrinsics of the variant.
+*               The plain loops are vectorised by the compiler. Only the
+*               functions of this file are compiled for the instruction set
+*               of the variant (#pragma GCC target), and they are in an
+*               anonymous namespace: the inline functions of the headers
+*               (e.g. std::min, ReproducibleAccumulator::add) keep the flags
+*               of the project, so the copy the linker keeps runs on every
+*               CPU. Do not include it anywhere else.
+*
+*   @version    1.0
+*
+*   @date       19/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//  Include
+//******************************************************************************
+#include <cmath> // Header file for abs and log
+#include <cstdint>
+#include <cstring> // Header file for memcpy
+#include <algorithm> // Header file for min and max
+#include <limits>
+
+#if defined(IMAGE_KERNELS_USE_AVX2) || defined(IMAGE_KERNELS_USE_AVX512)
+#include <immintrin.h> // Header file for the AVX2 and AVX-512 intrinsics
+#endif
+
+#include "ImageKernels.h"
+
+
+//******************************************************************************
+//  Instruction set of the variant, from here to the end of the file
+//******************************************************************************
+#pragma GCC push_options
+
+#if defined(IMAGE_KERNELS_USE_AVX512)
+#pragma GCC target("avx512f")
+#elif defined(IMAGE_KERNELS_USE_AVX2)
+#pragma GCC target("avx2,f16c")
+#endif
+
+
+//******************************************************************************
+//  Function declarations
+//******************************************************************************
+namespace IMAGE_KERNELS_NAMESPACE
+{
+namespace
+{
+    //--------------------------------------------------------------------------
+    /// Point operators
+    //--------------------------------------------------------------------------
+    void negate(const float* apInput, float* apOutput, unsigned int aNumberOfPixels,
+                float aMin, float aRange)
+    {
+        for (unsigned int i = 0; i < aNumberOfPixels; ++i)
+        {
+            // Take care to preserve the dynamic of the image
+            apOutput[i] = aMin + aRange * (1.0 - (apInput[i] - aMin) / aRange);
+        }
+    }
+
+
+    void shiftScale(const float* apInput, float* apOutput, unsigned int aNumberOfPixels,
+                    float aShift, float aScale)
+    {
+        for (unsigned int i = 0; i < aNumberOfPixels; ++i)
+        {
+            apOutput[i] = (apInput[i] + aShift) * aScale;
+        }
+    }
+
+
+    void log(const float* apInput, float* apOutput, unsigned int aNumberOfPixels)
+    {
+        for (unsigned int i = 0; i < aNumberOfPixels; ++i)
+        {
+            apOutput[i] = std::log(double(apInput[i]));
+        }
+    }
+
+
+    //--------------------------------------------------------------------------
+    /// Fast logarithm. The algorithm is the one of Cephes' logf:
+    /// x = m * 2^e with m in [sqrt(1/2), sqrt(2)), then
+    /// log(x) = log(m) + e * log(2), where log(m) is approximated by a
+    /// polynomial of degree 9 in (m - 1), and log(2) is split in two parts
+    /// to limit the rounding error. All the variants perform the same
+    /// operations in the same order, hence give the same results.
+    //--------------------------------------------------------------------------
+    const float SQRTHF = 0.707106781186547524f;
+
+    const float P0 =  7.0376836292E-2f;
+    const float P1 = -1.1514610310E-1f;
+    const float P2 =  1.1676998740E-1f;
+    const float P3 = -1.2420140846E-1f;
+    const float P4 =  1.4249322787E-1f;
+    const float P5 = -1.6668057665E-1f;
+    const float P6 =  2.0000714765E-1f;
+    const float P7 = -2.4999993993E-1f;
+    const float P8 =  3.3333331174E-1f;
+
+    const float LOG2_HI =  0.693359375f;
+    const float LOG2_LO = -2.12194440e-4f;
+
+    // 2^23, to scale the subnormal numbers
+    const float TWO_POW_23 = 8388608.0f;
+
+    const std::int32_t MANTISSA_MASK = 0x007FFFFF;
+    const std::int32_t HALF_EXPONENT = 0x3F000000;
+
+
+#if !defined(IMAGE_KERNELS_USE_AVX512)
+    // One value at a time, for the scalar variant and the last pixels of AVX2
+    float fastLog(float aValue)
+    {
+        if (aValue == 0.0f) return -std::numeric_limits<float>::infinity();
+        if (!(aValue >= 0.0f)) return std::numeric_limits<float>::quiet_NaN();
+        if (aValue == std::numeric_limits<float>::infinity()) return aValue;
+
+        int exponent_offset = -126;
+        if (aValue < std::numeric_limits<float>::min())
+        {
+            aValue *= TWO_POW_23;
+            exponent_offset -= 23;
+        }
+
+        std::int32_t bits;
+        std::memcpy(&bits, &aValue, sizeof(bits));
+
+        float e = float((bits >> 23) + exponent_offset);
+        bits = (bits & MANTISSA_MASK) | HALF_EXPONENT;
+
+        float m;
+        std::memcpy(&m, &bits, sizeof(m));
+
+        if (m < SQRTHF)
+        {
+            e -= 1.0f;
+            m = m + m;
+        }
+        m -= 1.0f;
+
+        float z = m * m;
+        float y = P0;
+        y = y * m + P1;
+        y = y * m + P2;
+        y = y * m + P3;
+        y = y * m + P4;
+        y = y * m + P5;
+        y = y * m + P6;
+        y = y * m + P7;
+        y = y * m + P8;
+        y = y * m * z;
+
+        y += e * LOG2_LO;
+        y -= 0.5f * z;
+
+        return m + y + e * LOG2_HI;
+    }
+#endif
+
+
+#if defined(IMAGE_KERNELS_USE_AVX512)
+    //--------------------------------------------------------------------------
+    /// AVX-512: 16 values at once
+    //--------------------------------------------------------------------------
+    inline __m512 fastLog(__m512 x)
+    {
+        const __m512 one = _mm512_set1_ps(1.0f);
+
+        // Scale the subnormal numbers
+        __mmask16 is_subnormal = _mm512_cmp_ps_mask(x, _mm512_set1_ps(std::numeric_limits<float>::min()), _CMP_LT_OQ);
+        __m512 scaled_x = _mm512_mask_mul_ps(x, is_subnormal, x, _mm512_set1_ps(TWO_POW_23));
+
+        // Split the exponent and the mantissa
+        __m512i bits = _mm512_castps_si512(scaled_x);
+        __m512i exponent = _mm512_sub_epi32(_mm512_srli_epi32(bits, 23), _mm512_set1_epi32(126));
+        exponent = _mm512_mask_sub_epi32(exponent, is_subnormal, exponent, _mm512_set1_epi32(23));
+
+        __m512 m = _mm512_castsi512_ps(_mm512_or_si512(_mm512_and_si512(bits, _mm512_set1_epi32(MANTISSA_MASK)),
+                                                       _mm512_set1_epi32(HALF_EXPONENT)));
+        __m512 e = _mm512_cvtepi32_ps(exponent);
+
+        // m in [sqrt(1/2), sqrt(2)) - 1
+        __mmask16 is_small = _mm512_cmp_ps_mask(m, _mm512_set1_ps(SQRTHF), _CMP_LT_OQ);
+        e = _mm512_mask_sub_ps(e, is_small, e, one);
+        m = _mm512_sub_ps(_mm512_mask_add_ps(m, is_small, m, m), one);
+
+        // Polynomial
+        __m512 z = _mm512_mul_ps(m, m);
+        __m512 y = _mm512_set1_ps(P0);
+        y = _mm512_add_ps(_mm512_mul_ps(y, m), _mm512_set1_ps(P1));
+        y = _mm512_add_ps(_mm512_mul_ps(y, m), _mm512_set1_ps(P2));
+        y = _mm512_add_ps(_mm512_mul_ps(y, m), _mm512_set1_ps(P3));
+        y = _mm512_add_ps(_mm512_mul_ps(y, m), _mm512_set1_ps(P4));
+        y = _mm512_add_ps(_mm512_mul_ps(y, m), _mm512_set1_ps(P5));
+        y = _mm512_add_ps(_mm512_mul_ps(y, m), _mm512_set1_ps(P6));
+        y = _mm512_add_ps(_mm512_mul_ps(y, m), _mm512_set1_ps(P7));
+        y = _mm512_add_ps(_mm512_mul_ps(y, m), _mm512_set1_ps(P8));
+        y = _mm512_mul_ps(_mm512_mul_ps(y, m), z);
+
+        y = _mm512_add_ps(y, _mm512_mul_ps(e, _mm512_set1_ps(LOG2_LO)));
+        y = _mm512_sub_ps(y, _mm512_mul_ps(z, _mm512_set1_ps(0.5f)));
+
+        __m512 result = _mm512_add_ps(_mm512_add_ps(m, y), _mm512_mul_ps(e, _mm512_set1_ps(LOG2_HI)));
+
+        // Special cases
+        const __m512 zero = _mm512_setzero_ps();
+        result = _mm512_mask_blend_ps(_mm512_cmp_ps_mask(x, _mm512_set1_ps(std::numeric_limits<float>::infinity()), _CMP_EQ_OQ), result, x);
+        result = _mm512_mask_blend_ps(_mm512_cmp_ps_mask(x, zero, _CMP_NGE_UQ), result, _mm512_set1_ps(std::numeric_limits<float>::quiet_NaN()));
+        result = _mm512_mask_blend_ps(_mm512_cmp_ps_mask(x, zero, _CMP_EQ_OQ), result, _mm512_set1_ps(-std::numeric_limits<float>::infinity()));
+
+        return result;
+    }
+
+
+    void fastLog(const float* apInput, float* apOutput, unsigned int aNumberOfPixels)
+    {
+        unsigned int i = 0;
+        for (; i + 16 <= aNumberOfPixels; i += 16)
+        {
+            _mm512_storeu_ps(apOutput + i, fastLog(_mm512_loadu_ps(apInput + i)));
+        }
+
+        // Masked load/store of the remaining values, the other lanes hold 1
+        if (i < aNumberOfPixels)
+        {
+            __mmask16 mask = (1u << (aNumberOfPixels - i)) - 1;
+            __m512 x = _mm512_mask_loadu_ps(_mm512_set1_ps(1.0f), mask, apInput + i);
+            _mm512_mask_storeu_ps(apOutput + i, mask, fastLog(x));
+        }
+    }
+#elif defined(IMAGE_KERNELS_USE_AVX2)
+    //--------------------------------------------------------------------------
+    /// AVX2: 8 values at once
+    //--------------------------------------------------------------------------
+    inline __m256 fastLog(__m256 x)
+    {
+        const __m256 one = _mm256_set1_ps(1.0f);
+
+        // Scale the subnormal numbers
+        __m256 is_subnormal = _mm256_cmp_ps(x, _mm256_set1_ps(std::numeric_limits<float>::min()), _CMP_LT_OQ);
+        __m256 scaled_x = _mm256_blendv_ps(x, _mm256_mul_ps(x, _mm256_set1_ps(TWO_POW_23)), is_subnormal);
+
+        // Split the exponent and the mantissa
+        __m256i bits = _mm256_castps_si256(scaled_x);
+        __m256i exponent = _mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(126));
+        exponent = _mm256_sub_epi32(exponent, _mm256_and_si256(_mm256_castps_si256(is_subnormal), _mm256_set1_epi32(23)));
+
+        __m256 m = _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(MANTISSA_MASK)),
+                                                       _mm256_set1_epi32(HALF_EXPONENT)));
+        __m256 e = _mm256_cvtepi32_ps(exponent);
+
+        // m in [sqrt(1/2), sqrt(2)) - 1
+        __m256 is_small = _mm256_cmp_ps(m, _mm256_set1_ps(SQRTHF), _CMP_LT_OQ);
+        e = _mm256_sub_ps(e, _mm256_and_ps(is_small, one));
+        m = _mm256_sub_ps(_mm256_add_ps(m, _mm256_and_ps(is_small, m)), one);
+
+        // Polynomial
+        __m256 z = _mm256_mul_ps(m, m);
+        __m256 y = _mm256_set1_ps(P0);
+        y = _mm256_add_ps(_mm256_mul_ps(y, m), _mm256_set1_ps(P1));
+        y = _mm256_add_ps(_mm256_mul_ps(y, m), _mm256_set1_ps(P2));
+        y = _mm256_add_ps(_mm256_mul_ps(y, m), _mm256_set1_ps(P3));
+        y = _mm256_add_ps(_mm256_mul_ps(y, m), _mm256_set1_ps(P4));
+        y = _mm256_add_ps(_mm256_mul_ps(y, m), _mm256_set1_ps(P5));
+        y = _mm256_add_ps(_mm256_mul_ps(y, m), _mm256_set1_ps(P6));
+        y = _mm256_add_ps(_mm256_mul_ps(y, m), _mm256_set1_ps(P7));
+        y = _mm256_add_ps(_mm256_mul_ps(y, m), _mm256_set1_ps(P8));
+        y = _mm256_mul_ps(_mm256_mul_ps(y, m), z);
+
+        y = _mm256_add_ps(y, _mm256_mul_ps(e, _mm256_set1_ps(LOG2_LO)));
+        y = _mm256_sub_ps(y, _mm256_mul_ps(z, _mm256_set1_ps(0.5f)));
+
+        __m256 result = _mm256_add_ps(_mm256_add_ps(m, y), _mm256_mul_ps(e, _mm256_set1_ps(LOG2_HI)));
+
+        // Special cases
+        const __m256 zero = _mm256_setzero_ps();
+        result = _mm256_blendv_ps(result, x, _mm256_cmp_ps(x, _mm256_set1_ps(std::numeric_limits<float>::infinity()), _CMP_EQ_OQ));
+        result = _mm256_blendv_ps(result, _mm256_set1_ps(std::numeric_limits<float>::quiet_NaN()), _mm256_cmp_ps(x, zero, _CMP_NGE_UQ));
+        result = _mm256_blendv_ps(result, _mm256_set1_ps(-std::numeric_limits<float>::infinity()), _mm256_cmp_ps(x, zero, _CMP_EQ_OQ));
+
+        return result;
+    }
+
+
+    void fastLog(const float* apInput, float* apOutput, unsigned int aNumberOfPixels)
+    {
+        unsigned int i = 0;
+        for (; i + 8 <= aNumberOfPixels; i += 8)
+        {
+            _mm256_storeu_ps(apOutput + i, fastLog(_mm256_loadu_ps(apInput + i)));
+        }
+
+        // The remaining values go through the scalar version, which gives
+        // the same results
+        for (; i < aNumberOfPixels; ++i)
+        {
+            apOutput[i] = fastLog(apInput[i]);
+        }
+    }
+#else
+    //--------------------------------------------------------------------------
+    /// Scalar: one value at a time
+    //--------------------------------------------------------------------------
+    void fastLog(const float* apInput, float* apOutput, unsigned int aNumberOfPixels)
+    {
+        for (unsigned int i = 0; i < aNumberOfPixels; ++i)
+        {
+            apOutput[i] = fastLog(apInput[i]);
+        }
+    }
+#endif
+
+
+    //--------------------------------------------------------------------------
+    /// Lookup table. The clamping gives the same index with all the variants,
+    /// even for NaN and out-of-range values: max(NaN, 0) is 0.
+    //--------------------------------------------------------------------------
+    void applyLUTScalar(const float* apInput, float* apOutput, unsigned int aNumberOfPixels,
+                        const float* apTable, unsigned int aTableSize)
+    {
+        const float max_index = float(aTableSize - 1);
+
+        for (unsigned int i = 0; i < aNumberOfPixels; ++i)
+        {
+            float index = (apInput[i] > 0.0f) ? apInput[i] : 0.0f;
+            index = (index < max_index) ? index : max_index;
+            apOutput[i] = apTable[(unsigned int)index];
+        }
+    }
+
+
+#if defined(IMAGE_KERNELS_USE_AVX512)
+    void applyLUT(const float* apInput, float* apOutput, unsigned int aNumberOfPixels,
+                  const float* apTable, unsigned int aTableSize)
+    {
+        const __m512 zero = _mm512_setzero_ps();
+        const __m512 max_index = _mm512_set1_ps(float(aTableSize - 1));
+
+        // Clamp and truncate 16 pixels, then gather their entries
+        unsigned int i = 0;
+        for (; i + 16 <= aNumberOfPixels; i += 16)
+        {
+            __m512 index = _mm512_min_ps(_mm512_max_ps(_mm512_loadu_ps(apInput + i), zero), max_index);
+            _mm512_storeu_ps(apOutput + i, _mm512_i32gather_ps(_mm512_cvttps_epi32(index), apTable, 4));
+        }
+
+        applyLUTScalar(apInput + i, apOutput + i, aNumberOfPixels - i, apTable, aTableSize);
+    }
+#elif defined(IMAGE_KERNELS_USE_AVX2)
+    void applyLUT(const float* apInput, float* apOutput, unsigned int aNumberOfPixels,
+                  const float* apTable, unsigned int aTableSize)
+    {
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 max_index = _mm256_set1_ps(float(aTableSize - 1));
+
+        // Clamp and truncate 8 pixels, then gather their entries
+        unsigned int i = 0;
+        for (; i + 8 <= aNumberOfPixels; i += 8)
+        {
+            __m256 index = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(apInput + i), zero), max_index);
+            _mm256_storeu_ps(apOutput + i, _mm256_i32gather_ps(apTable, _mm256_cvttps_epi32(index), 4));
+        }
+
+        applyLUTScalar(apInput + i, apOutput + i, aNumberOfPixels - i, apTable, aTableSize);
+    }
+#else
+    void applyLUT(const float* apInput, float* apOutput, unsigned int aNumberOfPixels,
+                  const float* apTable, unsigned int aTableSize)
+    {
+        applyLUTScalar(apInput, apOutput, aNumberOfPixels, apTable, aTableSize);
+    }
+#endif
+
+
+    //--------------------------------------------------------------------------
+    /// Conversions to and from 16-bit floating-point numbers, rounded to the
+    /// nearest even value: IEEE 754 half precision (FP16: 5-bit exponent,
+    /// 10-bit mantissa) and bfloat16 (BF16: the 16 upper bits of a float).
+    /// The scalar versions give the same bits as the F16C and AVX-512
+    /// instructions, NaN values stay NaN.
+    //--------------------------------------------------------------------------
+    std::uint16_t floatToHalf(float aValue)
+    {
+        std::uint32_t bits;
+        std::memcpy(&bits, &aValue, sizeof(bits));
+
+        std::uint32_t sign = bits & 0x80000000u;
+        bits ^= sign;
+
+        std::uint32_t half;
+
+        // Too large (65520 or more rounds to infinity), infinity or NaN
+        if (bits >= 0x47800000u)
+        {
+            half = (bits > 0x7F800000u) ? 0x7E00u | ((bits >> 13) & 0x3FFu) : 0x7C00u;
+        }
+        // Subnormal or zero: let the FPU round the mantissa, adding 0.5
+        // aligns it on the last bit of the subnormal numbers
+        else if (bits < 0x38800000u)
+        {
+            float value;
+            std::memcpy(&value, &bits, sizeof(value));
+            value += 0.5f;
+            std::memcpy(&bits, &value, sizeof(bits));
+
+            half = bits - 0x3F000000u;
+        }
+        // Normal: change the bias of the exponent, and round the mantissa
+        else
+        {
+            std::uint32_t odd_mantissa = (bits >> 13) & 1u;
+            bits += 0xC8000FFFu + odd_mantissa;
+            half = bits >> 13;
+        }
+
+        return std::uint16_t(half | (sign >> 16));
+    }
+
+
+    float halfToFloat(std::uint16_t aValue)
+    {
+        const std::uint32_t EXPONENT_MASK = 0x7C00u << 13;
+
+        std::uint32_t bits = std::uint32_t(aValue & 0x7FFFu) << 13;
+        std::uint32_t exponent = bits & EXPONENT_MASK;
+
+        // Change the bias of the exponent
+        bits += (127 - 15) << 23;
+
+        float value;
+
+        // Infinity or NaN, NaN values are quietened as by F16C
+        if (exponent == EXPONENT_MASK)
+        {
+            bits += (128 - 16) << 23;
+            if (bits & 0x007FFFFFu) bits |= 0x00400000u;
+            std::memcpy(&value, &bits, sizeof(value));
+        }
+        // Subnormal or zero: renormalise with the FPU
+        else if (exponent == 0)
+        {
+            bits += 1 << 23;
+            std::memcpy(&value, &bits, sizeof(value));
+            value -= 6.103515625e-05f; // 2^-14
+        }
+        else
+        {
+            std::memcpy(&value, &bits, sizeof(value));
+        }
+
+        std::uint32_t sign = std::uint32_t(aValue & 0x8000u) << 16;
+        std::memcpy(&bits, &value, sizeof(bits));
+        bits |= sign;
+        std::memcpy(&value, &bits, sizeof(value));
+
+        return value;
+    }
+
+
+    std::uint16_t floatToBFloat16(float aValue)
+    {
+        std::uint32_t bits;
+        std::memcpy(&bits, &aValue, sizeof(bits));
+
+        // Quiet NaN
+        if ((bits & 0x7FFFFFFFu) > 0x7F800000u)
+        {
+            return std::uint16_t((bits >> 16) | 0x40u);
+        }
+
+        // Round to the nearest even value, large values become infinity
+        bits += 0x7FFFu + ((bits >> 16) & 1u);
+        return std::uint16_t(bits >> 16);
+    }
+
+
+    float bfloat16ToFloat(std::uint16_t aValue)
+    {
+        std::uint32_t bits = std::uint32_t(aValue) << 16;
+
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+
+    void floatToHalfScalar(const float* apInput, std::uint16_t* apOutput, unsigned int aNumberOfPixels)
+    {
+        for (unsigned int i = 0; i < aNumberOfPixels; ++i)
+        {
+            apOutput[i] = floatToHalf(apInput[i]);
+        }
+    }
+
+
+    void halfToFloatScalar(const std::uint16_t* apInput, float* apOutput, unsigned int aNumberOfPixels)
+    {
+        for (unsigned int i = 0; i < aNumberOfPixels; ++i)
+        {
+            apOutput[i] = halfToFloat(apInput[i]);
+        }
+    }
+
+
+    void floatToBFloat16Scalar(const float* apInput, std::uint16_t* apOutput, unsigned int aNumberOfPixels)
+    {
+        for (unsigned int i = 0; i < aNumberOfPixels; ++i)
+        {
+            apOutput[i] = floatToBFloat16(apInput[i]);
+        }
+    }
+
+
+    void bfloat16ToFloatScalar(const std::uint16_t* apInput, float* apOutput, unsigned int aNumberOfPixels)
+    {
+        for (unsigned int i = 0; i < aNumberOfPixels; ++i)
+        {
+            apOutput[i] = bfloat16ToFloat(apInput[i]);
+        }
+    }
+
+
+#if defined(IMAGE_KERNELS_USE_AVX512)
+    void floatToHalf(const float* apInput, std::uint16_t* apOutput, unsigned int aNumberOfPixels)
+    {
+        unsigned int i = 0;
+        for (; i + 16 <= aNumberOfPixels; i += 16)
+        {
+            _mm256_storeu_si256((__m256i*)(apOutput + i),
+                                _mm512_cvtps_ph(_mm512_loadu_ps(apInput + i), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+        }
+
+        floatToHalfScalar(apInput + i, apOutput + i, aNumberOfPixels - i);
+    }
+
+
+    void halfToFloat(const std::uint16_t* apInput, float* apOutput, unsigned int aNumberOfPixels)
+    {
+        unsigned int i = 0;
+        for (; i + 16 <= aNumberOfPixels; i += 16)
+        {
+            _mm512_storeu_ps(apOutput + i, _mm512_cvtph_ps(_mm256_loadu_si256((const __m256i*)(apInput + i))));
+        }
+
+        halfToFloatScalar(apInput + i, apOutput + i, aNumberOfPixels - i);
+    }
+
+
+    void floatToBFloat16(const float* apInput, std::uint16_t* apOutput, unsigned int aNumberOfPixels)
+    {
+        const __m512i one = _mm512_set1_epi32(1);
+        const __m512i rounding_bias = _mm512_set1_epi32(0x7FFF);
+        const __m512i quiet_bit = _mm512_set1_epi32(0x40);
+
+        unsigned int i = 0;
+        for (; i + 16 <= aNumberOfPixels; i += 16)
+        {
+            __m512 value = _mm512_loadu_ps(apInput + i);
+            __m512i bits = _mm512_castps_si512(value);
+
+            // Same rounding as the scalar version, NaN values are only quietened
+            __m512i rounded = _mm512_add_epi32(bits, _mm512_add_epi32(rounding_bias,
+                                                                      _mm512_and_si512(_mm512_srli_epi32(bits, 16), one)));
+            __mmask16 is_nan = _mm512_cmp_ps_mask(value, value, _CMP_UNORD_Q);
+            __m512i result = _mm512_mask_or_epi32(_mm512_srli_epi32(rounded, 16), is_nan,
+                                                  _mm512_srli_epi32(bits, 16), quiet_bit);
+
+            _mm256_storeu_si256((__m256i*)(apOutput + i), _mm512_cvtepi32_epi16(result));
+        }
+
+        floatToBFloat16Scalar(apInput + i, apOutput + i, aNumberOfPixels - i);
+    }
+
+
+    void bfloat16ToFloat(const std::uint16_t* apInput, float* apOutput, unsigned int aNumberOfPixels)
+    {
+        unsigned int i = 0;
+        for (; i + 16 <= aNumberOfPixels; i += 16)
+        {
+            __m512i bits = _mm512_cvtepu16_epi32(_mm256_loadu_si256((const __m256i*)(apInput + i)));
+            _mm512_storeu_ps(apOutput + i, _mm512_castsi512_ps(_mm512_slli_epi32(bits, 16)));
+        }
+
+        bfloat16ToFloatScalar(apInput + i, apOutput + i, aNumberOfPixels - i);
+    }
+#elif defined(IMAGE_KERNELS_USE_AVX2)
+    void floatToHalf(const float* apInput, std::uint16_t* apOutput, unsigned int aNumberOfPixels)
+    {
+        unsigned int i = 0;
+        for (; i + 8 <= aNumberOfPixels; i += 8)
+        {
+            _mm_storeu_si128((__m128i*)(apOutput + i),
+                             _mm256_cvtps_ph(_mm256_loadu_ps(apInput + i), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+        }
+
+        floatToHalfScalar(apInput + i, apOutput + i, aNumberOfPixels - i);
+    }
+
+
+    void halfToFloat(const std::uint16_t* apInput, float* apOutput, unsigned int aNumberOfPixels)
+    {
+        unsigned int i = 0;
+        for (; i + 8 <= aNumberOfPixels; i += 8)
+        {
+            _mm256_storeu_ps(apOutput + i, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(apInput + i))));
+        }
+
+        halfToFloatScalar(apInput + i, apOutput + i, aNumberOfPixels - i);
+    }
+
+
+    void floatToBFloat16(const float* apInput, std::uint16_t* apOutput, unsigned int aNumberOfPixels)
+    {
+        const __m256i one = _mm256_set1_epi32(1);
+        const __m256i rounding_bias = _mm256_set1_epi32(0x7FFF);
+        const __m256i quiet_bit = _mm256_set1_epi32(0x40);
+
+        unsigned int i = 0;
+        for (; i + 8 <= aNumberOfPixels; i += 8)
+        {
+            __m256 value = _mm256_loadu_ps(apInput + i);
+            __m256i bits = _mm256_castps_si256(value);
+
+            // Same rounding as the scalar version, NaN values are only quietened
+            __m256i rounded = _mm256_add_epi32(bits, _mm256_add_epi32(rounding_bias,
+                                                                      _mm256_and_si256(_mm256_srli_epi32(bits, 16), one)));
+            __m256i is_nan = _mm256_castps_si256(_mm256_cmp_ps(value, value, _CMP_UNORD_Q));
+            __m256i result = _mm256_blendv_epi8(_mm256_srli_epi32(rounded, 16),
+                                                _mm256_or_si256(_mm256_srli_epi32(bits, 16), quiet_bit),
+                                                is_nan);
+
+            // Pack the 32-bit lanes into 16-bit lanes (the values fit, there
+            // is no saturation), then put the two 128-bit halves together
+            __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(result, result), 0xD8);
+            _mm_storeu_si128((__m128i*)(apOutput + i), _mm256_castsi256_si128(packed));
+        }
+
+        floatToBFloat16Scalar(apInput + i, apOutput + i, aNumberOfPixels - i);
+    }
+
+
+    void bfloat16ToFloat(const std::uint16_t* apInput, float* apOutput, unsigned int aNumberOfPixels)
+    {
+        unsigned int i = 0;
+        for (; i + 8 <= aNumberOfPixels; i += 8)
+        {
+            __m256i bits = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(apInput + i)));
+            _mm256_storeu_ps(apOutput + i, _mm256_castsi256_ps(_mm256_slli_epi32(bits, 16)));
+        }
+
+        bfloat16ToFloatScalar(apInput + i, apOutput + i, aNumberOfPixels - i);
+    }
+#else
+    void floatToHalf(const float* apInput, std::uint16_t* apOutput, unsigned int aNumberOfPixels)
+    {
+        floatToHalfScalar(apInput, apOutput, aNumberOfPixels);
+    }
+
+
+    void halfToFloat(const std::uint16_t* apInput, float* apOutput, unsigned int aNumberOfPixels)
+    {
+        halfToFloatScalar(apInput, apOutput, aNumberOfPixels);
+    }
+
+
+    void floatToBFloat16(const float* apInput, std::uint16_t* apOutput, unsigned int aNumberOfPixels)
+    {
+        floatToBFloat16Scalar(apInput, apOutput, aNumberOfPixels);
+    }
+
+
+    void bfloat16ToFloat(const std::uint16_t* apInput, float* apOutput, unsigned int aNumberOfPixels)
+    {
+        bfloat16ToFloatScalar(apInput, apOutput, aNumberOfPixels);
+    }
+#endif
+
+
+    //--------------------------------------------------------------------------
+    /// Row reversal. Whole vectors are loaded, their lanes permuted and
+    /// stored, the tail is processed one pixel at a time. In place, vectors
+    /// are swapped from both ends of the row. The vector helpers below are
+    /// also used by the reductions.
+    //--------------------------------------------------------------------------
+    void reverseRowScalar(const float* apInput, float* apOutput, unsigned int aWidth)
+    {
+        for (unsigned int i = 0; i < aWidth; ++i)
+        {
+            apOutput[aWidth - i - 1] = apInput[i];
+        }
+    }
+
+
+    void reverseRowInPlaceScalar(float* apRow, unsigned int aWidth)
+    {
+        for (unsigned int left = 0, right = aWidth; right - left >= 2; ++left, --right)
+        {
+            float temp = apRow[left];
+            apRow[left] = apRow[right - 1];
+            apRow[right - 1] = temp;
+        }
+    }
+
+
+#if defined(IMAGE_KERNELS_USE_AVX512)
+    const unsigned int VECTOR_SIZE = 16;
+
+    typedef __m512 Vector;
+
+    inline Vector load(const float* apData) { return _mm512_loadu_ps(apData); }
+
+    inline void store(float* apData, Vector aVector) { _mm512_storeu_ps(apData, aVector); }
+
+    // Non-temporal store, apData must be aligned on 64 bytes
+    inline void stream(float* apData, Vector aVector) { _mm512_stream_ps(apData, aVector); }
+
+    inline Vector reverse(Vector aVector)
+    {
+        return _mm512_permutexvar_ps(_mm512_setr_epi32(15, 14, 13, 12, 11, 10, 9, 8,
+                                                       7, 6, 5, 4, 3, 2, 1, 0),
+                                     aVector);
+    }
+
+    inline Vector set1(float aValue) { return _mm512_set1_ps(aValue); }
+
+    inline Vector add(Vector a, Vector b) { return _mm512_add_ps(a, b); }
+
+    inline Vector sub(Vector a, Vector b) { return _mm512_sub_ps(a, b); }
+
+    inline Vector mul(Vector a, Vector b) { return _mm512_mul_ps(a, b); }
+
+    // Return b if a or b is NaN
+    inline Vector min(Vector a, Vector b) { return _mm512_min_ps(a, b); }
+
+    inline Vector max(Vector a, Vector b) { return _mm512_max_ps(a, b); }
+
+    inline Vector abs(Vector aVector) { return _mm512_abs_ps(aVector); }
+
+    // true if !(a[i] <= b[i]) for any lane, i.e. if a[i] > b[i] or is NaN
+    inline bool isAnyGreater(Vector a, Vector b) { return _mm512_cmp_ps_mask(a, b, _CMP_NLE_UQ) != 0; }
+#elif defined(IMAGE_KERNELS_USE_AVX2)
+    const unsigned int VECTOR_SIZE = 8;
+
+    typedef __m256 Vector;
+
+    inline Vector load(const float* apData) { return _mm256_loadu_ps(apData); }
+
+    inline void store(float* apData, Vector aVector) { _mm256_storeu_ps(apData, aVector); }
+
+    // Non-temporal store, apData must be aligned on 32 bytes
+    inline void stream(float* apData, Vector aVector) { _mm256_stream_ps(apData, aVector); }
+
+    inline Vector reverse(Vector aVector)
+    {
+        return _mm256_permutevar8x32_ps(aVector, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+    }
+
+    inline Vector set1(float aValue) { return _mm256_set1_ps(aValue); }
+
+    inline Vector add(Vector a, Vector b) { return _mm256_add_ps(a, b); }
+
+    inline Vector sub(Vector a, Vector b) { return _mm256_sub_ps(a, b); }
+
+    inline Vector mul(Vector a, Vector b) { return _mm256_mul_ps(a, b); }
+
+    // Return b if a or b is NaN
+    inline Vector min(Vector a, Vector b) { return _mm256_min_ps(a, b); }
+
+    inline Vector max(Vector a, Vector b) { return _mm256_max_ps(a, b); }
+
+    inline Vector abs(Vector aVector)
+    {
+        return _mm256_and_ps(aVector, _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF)));
+    }
+
+    // true if !(a[i] <= b[i]) for any lane, i.e. if a[i] > b[i] or is NaN
+    inline bool isAnyGreater(Vector a, Vector b) { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_NLE_UQ)) != 0; }
+#endif
+
+
+#if defined(IMAGE_KERNELS_USE_AVX2) || defined(IMAGE_KERNELS_USE_AVX512)
+    void reverseRow(const float* apInput, float* apOutput, unsigned int aWidth)
+    {
+        unsigned int i = 0;
+        for (; i + VECTOR_SIZE <= aWidth; i += VECTOR_SIZE)
+        {
+            store(apOutput + aWidth - i - VECTOR_SIZE, reverse(load(apInput + i)));
+        }
+
+        reverseRowScalar(apInput + i, apOutput, aWidth - i);
+    }
+
+
+    void reverseRowInPlace(float* apRow, unsigned int aWidth)
+    {
+        unsigned int left = 0;
+        unsigned int right = aWidth;
+        for (; right - left >= 2 * VECTOR_SIZE; left += VECTOR_SIZE, right -= VECTOR_SIZE)
+        {
+            Vector left_vector = load(apRow + left);
+            Vector right_vector = load(apRow + right - VECTOR_SIZE);
+            store(apRow + left, reverse(right_vector));
+            store(apRow + right - VECTOR_SIZE, reverse(left_vector));
+        }
+
+        reverseRowInPlaceScalar(apRow + left, right - left);
+    }
+#else
+    void reverseRow(const float* apInput, float* apOutput, unsigned int aWidth)
+    {
+        reverseRowScalar(apInput, apOutput, aWidth);
+    }
+
+
+    void reverseRowInPlace(float* apRow, unsigned int aWidth)
+    {
+        reverseRowInPlaceScalar(apRow, aWidth);
+    }
+#endif
+
+
+    //--------------------------------------------------------------------------
+    /// Copy with non-temporal stores: the output is written to memory
+    /// without being loaded in the caches first, and does not evict what is
+    /// there. The pixels are copied one at a time until the output is
+    /// aligned on a vector. The scalar variant uses memcpy.
+    //--------------------------------------------------------------------------
+#if defined(IMAGE_KERNELS_USE_AVX2) || defined(IMAGE_KERNELS_USE_AVX512)
+    void streamCopy(const float* apInput, float* apOutput, unsigned int aNumberOfPixels)
+    {
+        unsigned int i = 0;
+        for (; i < aNumberOfPixels &&
+                reinterpret_cast<std::uintptr_t>(apOutput + i) % (VECTOR_SIZE * sizeof(float)); ++i)
+        {
+            apOutput[i] = apInput[i];
+        }
+
+        for (; i + 2 * VECTOR_SIZE <= aNumberOfPixels; i += 2 * VECTOR_SIZE)
+        {
+            stream(apOutput + i, load(apInput + i));
+            stream(apOutput + i + VECTOR_SIZE, load(apInput + i + VECTOR_SIZE));
+        }
+
+        for (; i < aNumberOfPixels; ++i)
+        {
+            apOutput[i] = apInput[i];
+        }
+
+        // The non-temporal stores are weakly ordered, make them visible
+        // before the stores that follow (e.g. the end of the thread)
+        _mm_sfence();
+    }
+#else
+    void streamCopy(const float* apInput, float* apOutput, unsigned int aNumberOfPixels)
+    {
+        std::memcpy(apOutput, apInput, aNumberOfPixels * sizeof(float));
+    }
+#endif
+
+
+    //--------------------------------------------------------------------------
+    /// Exponential, power and square root. exp and pow use the C library, in
+    /// double precision, like log. The fast exponential is the one of
+    /// Cephes' expf: exp(x) = 2^n * exp(r), with n = floor(x * log2(e) + 0.5)
+    /// and r = x - n * log(2) in [-log(2) / 2, log(2) / 2] (log(2) is split
+    /// in the same two parts as for the log), then exp(r) = 1 + r + r^2 * Q(r),
+    /// where Q is a polynomial of degree 5. 2^n is applied in two steps, so
+    /// that the subnormal or infinite results are rounded once. x is first
+    /// clamped to [EXP_MIN, EXP_MAX]: exp(x) is 0 below, and infinite above.
+    /// The fast power computes x^p = exp(p * log(x)) with the polynomials of
+    /// fastLog and fastExp, but p * log(x) and its reduction r are computed
+    /// in double precision: in single precision, the error of p * log(x)
+    /// would be multiplied by |p * log(x)|. All the variants perform the same
+    /// operations in the same order, hence give the same results.
+    //--------------------------------------------------------------------------
+    const float LOG2E = 1.44269504088896341f;
+
+    const float Q0 = 1.9875691500E-4f;
+    const float Q1 = 1.3981999507E-3f;
+    const float Q2 = 8.3334519073E-3f;
+    const float Q3 = 4.1665795894E-2f;
+    const float Q4 = 1.6666665459E-1f;
+    const float Q5 = 5.0000001201E-1f;
+
+    // exp(EXP_MIN) is 0, exp(EXP_MAX) is infinite
+    const float EXP_MIN = -104.0f;
+    const float EXP_MAX = 89.0f;
+
+    const double LN2_DOUBLE = 0.693147180559945309417232121458;
+    const double LOG2E_DOUBLE = 1.44269504088896340735992468100;
+
+    const std::int32_t FLOAT_EXPONENT_BIAS = 127;
+
+
+    void exp(const float* apInput, float* apOutput, unsigned int aNumberOfPixels)
+    {
+        for (unsigned int i = 0; i < aNumberOfPixels; ++i)
+        {
+            apOutput[i] = std::exp(double(apInput[i]));
+        }
+    }
+
+
+    void pow(const float* apInput, float* apOutput, unsigned int aNumberOfPixels,
+             float aExponent)
+    {
+        for (unsigned int i = 0; i < aNumberOfPixels; ++i)
+        {
+            apOutput[i] = std::pow(double(apInput[i]), double(aExponent));
+        }
+    }
+
+
+    // 2^n for n in [-126, 127]
+    inline float powerOfTwo(std::int32_t n)
+    {
+        std::int32_t bits = (n + FLOAT_EXPONENT_BIAS) << 23;
+
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+
+    // exp(r) * 2^n, for r in [-log(2) / 2, log(2) / 2] and n in [-150, 128]
+    inline float expReduced(float r, float n)
+    {
+        float z = r * r;
+        float y = Q0;
+        y = y * r + Q1;
+        y = y * r + Q2;
+        y = y * r + Q3;
+        y = y * r + Q4;
+        y = y * r + Q5;
+        y = y * z + r + 1.0f;
+
+        std::int32_t n1 = std::int32_t(n) >> 1;
+        std::int32_t n2 = std::int32_t(n) - n1;
+        return y * powerOfTwo(n1) * powerOfTwo(n2);
+    }
+
+
+    float fastExp(float aValue)
+    {
+        if (std::isnan(aValue)) return aValue;
+
+        float x = std::min(std::max(aValue, EXP_MIN), EXP_MAX);
+        float n = std::floor(x * LOG2E + 0.5f);
+        float r = x - n * LOG2_HI;
+        r = r - n * LOG2_LO;
+
+        return expReduced(r, n);
+    }
+
+
+    // x = 2^e * (1 + m), then log(x) = e * log(2) + lm, for a positive
+    // finite x (see fastLog)
+    void logParts(float aValue, float& e, float& lm)
+    {
+        int exponent_offset = -126;
+        if (aValue < std::numeric_limits<float>::min())
+        {
+            aValue *= TWO_POW_23;
+            exponent_offset -= 23;
+        }
+
+        std::int32_t bits;
+        std::memcpy(&bits, &aValue, sizeof(bits));
+
+        e = float((bits >> 23) + exponent_offset);
+        bits = (bits & MANTISSA_MASK) | HALF_EXPONENT;
+
+        float m;
+        std::memcpy(&m, &bits, sizeof(m));
+
+        if (m < SQRTHF)
+        {
+            e -= 1.0f;
+            m = m + m;
+        }
+        m -= 1.0f;
+
+        float z = m * m;
+        float y = P0;
+        y = y * m + P1;
+        y = y * m + P2;
+        y = y * m + P3;
+        y = y * m + P4;
+        y = y * m + P5;
+        y = y * m + P6;
+        y = y * m + P7;
+        y = y * m + P8;
+        y = y * m * z;
+        y -= 0.5f * z;
+
+        lm = m + y;
+    }
+
+
+    // Reduction of p * log(x) in double precision: p * log(x) = n * log(2) + r
+    inline void reducePow(float e, float lm, float aExponent, float& r, float& n)
+    {
+        double y = double(aExponent) * (double(e) * LN2_DOUBLE + double(lm));
+        y = std::min(std::max(y, double(EXP_MIN)), double(EXP_MAX));
+
+        double n_double = std::nearbyint(y * LOG2E_DOUBLE);
+        r = float(y - n_double * LN2_DOUBLE);
+        n = float(n_double);
+    }
+
+
+    float fastPow(float aValue, float aExponent, bool anIsInteger, bool anIsOdd)
+    {
+        const float infinity = std::numeric_limits<float>::infinity();
+
+        float abs_value = std::abs(aValue);
+        float result;
+
+        if (abs_value == 0.0f)
+        {
+            result = (aExponent > 0.0f) ? 0.0f : infinity;
+        }
+        else if (abs_value == infinity)
+        {
+            result = (aExponent > 0.0f) ? infinity : 0.0f;
+        }
+        else
+        {
+            float e, lm, r, n;
+            logParts(abs_value, e, lm);
+            reducePow(e, lm, aExponent, r, n);
+            result = expReduced(r, n);
+        }
+
+        // Negative values: odd integer exponents keep the sign, the other
+        // integer exponents do not, and the other exponents give NaN
+        if (anIsOdd && std::signbit(aValue)) result = -result;
+        if (!anIsInteger && aValue < 0.0f && aValue != -infinity) result = std::numeric_limits<float>::quiet_NaN();
+        if (std::isnan(aValue)) result = aValue;
+
+        return result;
+    }
+
+
+    // The exponents handled by the C library: 0 and 1 (exact results), and
+    // the exponents that are not finite
+    inline bool isSpecialExponent(float aExponent)
+    {
+        return (aExponent == 0.0f || aExponent == 1.0f || !std::isfinite(aExponent));
+    }
+
+
+#if defined(IMAGE_KERNELS_USE_AVX512)
+    //--------------------------------------------------------------------------
+    /// AVX-512: 16 values at once
+    //--------------------------------------------------------------------------
+    inline __m512 floor(__m512 x) { return _mm512_roundscale_ps(x, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+
+    inline __m512 sqrt(__m512 x) { return _mm512_sqrt_ps(x); }
+
+
+    inline __m512 powerOfTwo(__m512i n)
+    {
+        return _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_add_epi32(n, _mm512_set1_epi32(FLOAT_EXPONENT_BIAS)), 23));
+    }
+
+
+    inline __m512 expReduced(__m512 r, __m512 n)
+    {
+        __m512 z = mul(r, r);
+        __m512 y = set1(Q0);
+        y = add(mul(y, r), set1(Q1));
+        y = add(mul(y, r), set1(Q2));
+        y = add(mul(y, r), set1(Q3));
+        y = add(mul(y, r), set1(Q4));
+        y = add(mul(y, r), set1(Q5));
+        y = add(add(mul(y, z), r), set1(1.0f));
+
+        __m512i n1 = _mm512_cvttps_epi32(n);
+        __m512i n2 = _mm512_sub_epi32(n1, _mm512_srai_epi32(n1, 1));
+        n1 = _mm512_srai_epi32(n1, 1);
+        return mul(mul(y, powerOfTwo(n1)), powerOfTwo(n2));
+    }
+
+
+    inline __m512 fastExp(__m512 x)
+    {
+        __m512 clamped_x = min(max(x, set1(EXP_MIN)), set1(EXP_MAX));
+        __m512 n = floor(add(mul(clamped_x, set1(LOG2E)), set1(0.5f)));
+        __m512 r = sub(clamped_x, mul(n, set1(LOG2_HI)));
+        r = sub(r, mul(n, set1(LOG2_LO)));
+
+        return _mm512_mask_blend_ps(_mm512_cmp_ps_mask(x, x, _CMP_UNORD_Q), expReduced(r, n), x);
+    }
+
+
+    inline void logParts(__m512 x, __m512& e, __m512& lm)
+    {
+        const __m512 one = set1(1.0f);
+
+        // Scale the subnormal numbers
+        __mmask16 is_subnormal = _mm512_cmp_ps_mask(x, set1(std::numeric_limits<float>::min()), _CMP_LT_OQ);
+        __m512 scaled_x = _mm512_mask_mul_ps(x, is_subnormal, x, set1(TWO_POW_23));
+
+        // Split the exponent and the mantissa
+        __m512i bits = _mm512_castps_si512(scaled_x);
+        __m512i exponent = _mm512_sub_epi32(_mm512_srli_epi32(bits, 23), _mm512_set1_epi32(126));
+        exponent = _mm512_mask_sub_epi32(exponent, is_subnormal, exponent, _mm512_set1_epi32(23));
+
+        __m512 m = _mm512_castsi512_ps(_mm512_or_si512(_mm512_and_si512(bits, _mm512_set1_epi32(MANTISSA_MASK)),
+                                                       _mm512_set1_epi32(HALF_EXPONENT)));
+        e = _mm512_cvtepi32_ps(exponent);
+
+        // m in [sqrt(1/2), sqrt(2)) - 1
+        __mmask16 is_small = _mm512_cmp_ps_mask(m, set1(SQRTHF), _CMP_LT_OQ);
+        e = _mm512_mask_sub_ps(e, is_small, e, one);
+        m = sub(_mm512_mask_add_ps(m, is_small, m, m), one);
+
+        // Polynomial
+        __m512 z = mul(m, m);
+        __m512 y = set1(P0);
+        y = add(mul(y, m), set1(P1));
+        y = add(mul(y, m), set1(P2));
+        y = add(mul(y, m), set1(P3));
+        y = add(mul(y, m), set1(P4));
+        y = add(mul(y, m), set1(P5));
+        y = add(mul(y, m), set1(P6));
+        y = add(mul(y, m), set1(P7));
+        y = add(mul(y, m), set1(P8));
+        y = mul(mul(y, m), z);
+        y = sub(y, mul(z, set1(0.5f)));
+
+        lm = add(m, y);
+    }
+
+
+    // Reduction of 8 values in double precision
+    inline void reducePow(__m256 e, __m256 lm, __m512d anExponent, __m256& r, __m256& n)
+    {
+        const __m512d ln2 = _mm512_set1_pd(LN2_DOUBLE);
+
+        __m512d y = _mm512_mul_pd(anExponent, _mm512_add_pd(_mm512_mul_pd(_mm512_cvtps_pd(e), ln2), _mm512_cvtps_pd(lm)));
+        y = _mm512_min_pd(_mm512_max_pd(y, _mm512_set1_pd(EXP_MIN)), _mm512_set1_pd(EXP_MAX));
+
+        __m512d n_double = _mm512_roundscale_pd(_mm512_mul_pd(y, _mm512_set1_pd(LOG2E_DOUBLE)),
+                                                _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        r = _mm512_cvtpd_ps(_mm512_sub_pd(y, _mm512_mul_pd(n_double, ln2)));
+        n = _mm512_cvtpd_ps(n_double);
+    }
+
+
+    inline __m256 lowHalf(__m512 x) { return _mm512_castps512_ps256(x); }
+
+    inline __m256 highHalf(__m512 x) { return _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(x), 1)); }
+
+    inline __m512 combine(__m256 aLowHalf, __m256 aHighHalf)
+    {
+        return _mm512_castpd_ps(_mm512_insertf64x4(_mm512_castpd256_pd512(_mm256_castps_pd(aLowHalf)),
+                                                   _mm256_castps_pd(aHighHalf), 1));
+    }
+
+
+    inline __m512 fastPow(__m512 x, float aExponent, bool anIsInteger, bool anIsOdd)
+    {
+        const __m512 zero = _mm512_setzero_ps();
+        const __m512 infinity = set1(std::numeric_limits<float>::infinity());
+        const __m512d exponent = _mm512_set1_pd(aExponent);
+
+        __m512 abs_x = abs(x);
+
+        __m512 e, lm;
+        logParts(abs_x, e, lm);
+
+        __m256 r_low, n_low, r_high, n_high;
+        reducePow(lowHalf(e), lowHalf(lm), exponent, r_low, n_low);
+        reducePow(highHalf(e), highHalf(lm), exponent, r_high, n_high);
+
+        __m512 result = expReduced(combine(r_low, r_high), combine(n_low, n_high));
+
+        // Special cases
+        result = _mm512_mask_blend_ps(_mm512_cmp_ps_mask(abs_x, zero, _CMP_EQ_OQ), result,
+                                      (aExponent > 0.0f) ? zero : infinity);
+        result = _mm512_mask_blend_ps(_mm512_cmp_ps_mask(abs_x, infinity, _CMP_EQ_OQ), result,
+                                      (aExponent > 0.0f) ? infinity : zero);
+
+        if (anIsOdd)
+        {
+            __m512i sign = _mm512_and_si512(_mm512_castps_si512(x), _mm512_set1_epi32(0x80000000));
+            result = _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(result), sign));
+        }
+
+        if (!anIsInteger)
+        {
+            __mmask16 is_negative = _mm512_cmp_ps_mask(x, zero, _CMP_LT_OQ) &
+                                    _mm512_cmp_ps_mask(x, sub(zero, infinity), _CMP_NEQ_OQ);
+            result = _mm512_mask_blend_ps(is_negative, result, set1(std::numeric_limits<float>::quiet_NaN()));
+        }
+
+        return _mm512_mask_blend_ps(_mm512_cmp_ps_mask(x, x, _CMP_UNORD_Q), result, x);
+    }
+#elif defined(IMAGE_KERNELS_USE_AVX2)
+    //--------------------------------------------------------------------------
+    /// AVX2: 8 values at once
+    //--------------------------------------------------------------------------
+    inline __m256 floor(__m256 x) { return _mm256_floor_ps(x); }
+
+    inline __m256 sqrt(__m256 x) { return _mm256_sqrt_ps(x); }
+
+
+    inline __m256 powerOfTwo(__m256i n)
+    {
+        return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(n, _mm256_set1_epi32(FLOAT_EXPONENT_BIAS)), 23));
+    }
+
+
+    inline __m256 expReduced(__m256 r, __m256 n)
+    {
+        __m256 z = mul(r, r);
+        __m256 y = set1(Q0);
+        y = add(mul(y, r), set1(Q1));
+        y = add(mul(y, r), set1(Q2));
+        y = add(mul(y, r), set1(Q3));
+        y = add(mul(y, r), set1(Q4));
+        y = add(mul(y, r), set1(Q5));
+        y = add(add(mul(y, z), r), set1(1.0f));
+
+        __m256i n1 = _mm256_cvttps_epi32(n);
+        __m256i n2 = _mm256_sub_epi32(n1, _mm256_srai_epi32(n1, 1));
+        n1 = _mm256_srai_epi32(n1, 1);
+        return mul(mul(y, powerOfTwo(n1)), powerOfTwo(n2));
+    }
+
+
+    inline __m256 fastExp(__m256 x)
+    {
+        __m256 clamped_x = min(max(x, set1(EXP_MIN)), set1(EXP_MAX));
+        __m256 n = floor(add(mul(clamped_x, set1(LOG2E)), set1(0.5f)));
+        __m256 r = sub(clamped_x, mul(n, set1(LOG2_HI)));
+        r = sub(r, mul(n, set1(LOG2_LO)));
+
+        return _mm256_blendv_ps(expReduced(r, n), x, _mm256_cmp_ps(x, x, _CMP_UNORD_Q));
+    }
+
+
+    inline void logParts(__m256 x, __m256& e, __m256& lm)
+    {
+        const __m256 one = set1(1.0f);
+
+        // Scale the subnormal numbers
+        __m256 is_subnormal = _mm256_cmp_ps(x, set1(std::numeric_limits<float>::min()), _CMP_LT_OQ);
+        __m256 scaled_x = _mm256_blendv_ps(x, mul(x, set1(TWO_POW_23)), is_subnormal);
+
+        // Split the exponent and the mantissa
+        __m256i bits = _mm256_castps_si256(scaled_x);
+        __m256i exponent = _mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(126));
+        exponent = _mm256_sub_epi32(exponent, _mm256_and_si256(_mm256_castps_si256(is_subnormal), _mm256_set1_epi32(23)));
+
+        __m256 m = _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(MANTISSA_MASK)),
+                                                       _mm256_set1_epi32(HALF_EXPONENT)));
+        e = _mm256_cvtepi32_ps(exponent);
+
+        // m in [sqrt(1/2), sqrt(2)) - 1
+        __m256 is_small = _mm256_cmp_ps(m, set1(SQRTHF), _CMP_LT_OQ);
+        e = sub(e, _mm256_and_ps(is_small, one));
+        m = sub(add(m, _mm256_and_ps(is_small, m)), one);
+
+        // Polynomial
+        __m256 z = mul(m, m);
+        __m256 y = set1(P0);
+        y = add(mul(y, m), set1(P1));
+        y = add(mul(y, m), set1(P2));
+        y = add(mul(y, m), set1(P3));
+        y = add(mul(y, m), set1(P4));
+        y = add(mul(y, m), set1(P5));
+        y = add(mul(y, m), set1(P6));
+        y = add(mul(y, m), set1(P7));
+        y = add(mul(y, m), set1(P8));
+        y = mul(mul(y, m), z);
+        y = sub(y, mul(z, set1(0.5f)));
+
+        lm = add(m, y);
+    }
+
+
+    // Reduction of 4 values in double precision
+    inline void reducePow(__m128 e, __m128 lm, __m256d anExponent, __m128& r, __m128& n)
+    {
+        const __m256d ln2 = _mm256_set1_pd(LN2_DOUBLE);
+
+        __m256d y = _mm256_mul_pd(anExponent, _mm256_add_pd(_mm256_mul_pd(_mm256_cvtps_pd(e), ln2), _mm256_cvtps_pd(lm)));
+        y = _mm256_min_pd(_mm256_max_pd(y, _mm256_set1_pd(EXP_MIN)), _mm256_set1_pd(EXP_MAX));
+
+        __m256d n_double = _mm256_round_pd(_mm256_mul_pd(y, _mm256_set1_pd(LOG2E_DOUBLE)),
+                                           _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        r = _mm256_cvtpd_ps(_mm256_sub_pd(y, _mm256_mul_pd(n_double, ln2)));
+        n = _mm256_cvtpd_ps(n_double);
+    }
+
+
+    inline __m128 lowHalf(__m256 x) { return _mm256_castps256_ps128(x); }
+
+    inline __m128 highHalf(__m256 x) { return _mm256_extractf128_ps(x, 1); }
+
+    inline __m256 combine(__m128 aLowHalf, __m128 aHighHalf)
+    {
+        return _mm256_insertf128_ps(_mm256_castps128_ps256(aLowHalf), aHighHalf, 1);
+    }
+
+
+    inline __m256 fastPow(__m256 x, float aExponent, bool anIsInteger, bool anIsOdd)
+    {
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 infinity = set1(std::numeric_limits<float>::infinity());
+        const __m256d exponent = _mm256_set1_pd(aExponent);
+
+        __m256 abs_x = abs(x);
+
+        __m256 e, lm;
+        logParts(abs_x, e, lm);
+
+        __m128 r_low, n_low, r_high, n_high;
+        reducePow(lowHalf(e), lowHalf(lm), exponent, r_low, n_low);
+        reducePow(highHalf(e), highHalf(lm), exponent, r_high, n_high);
+
+        __m256 result = expReduced(combine(r_low, r_high), combine(n_low, n_high));
+
+        // Special cases
+        result = _mm256_blendv_ps(result, (aExponent > 0.0f) ? zero : infinity,
+                                  _mm256_cmp_ps(abs_x, zero, _CMP_EQ_OQ));
+        result = _mm256_blendv_ps(result, (aExponent > 0.0f) ? infinity : zero,
+                                  _mm256_cmp_ps(abs_x, infinity, _CMP_EQ_OQ));
+
+        if (anIsOdd)
+        {
+            result = _mm256_xor_ps(result, _mm256_and_ps(x, set1(-0.0f)));
+        }
+
+        if (!anIsInteger)
+        {
+            __m256 is_negative = _mm256_and_ps(_mm256_cmp_ps(x, zero, _CMP_LT_OQ),
+                                               _mm256_cmp_ps(x, sub(zero, infinity), _CMP_NEQ_OQ));
+            result = _mm256_blendv_ps(result, set1(std::numeric_limits<float>::quiet_NaN()), is_negative);
+        }
+
+        return _mm256_blendv_ps(result, x, _mm256_cmp_ps(x, x, _CMP_UNORD_Q));
+    }
+#endif
+
+
+#if defined(IMAGE_KERNELS_USE_AVX2) || defined(IMAGE_KERNELS_USE_AVX512)
+    void fastExp(const float* apInput, float* apOutput, unsigned int aNumberOfPixels)
+    {
+        unsigned int i = 0;
+        for (; i + VECTOR_SIZE <= aNumberOfPixels; i += VECTOR_SIZE)
+        {
+            store(apOutput + i, fastExp(load(apInput + i)));
+        }
+
+        // The remaining values go through the scalar version, which gives
+        // the same results
+        for (; i < aNumberOfPixels; ++i)
+        {
+            apOutput[i] = fastExp(apInput[i]);
+        }
+    }
+
+
+    void fastPow(const float* apInput, float* apOutput, unsigned int aNumberOfPixels,
+                 float aExponent)
+    {
+        if (isSpecialExponent(aExponent))
+        {
+            pow(apInput, apOutput, aNumberOfPixels, aExponent);
+            return;
+        }
+
+        bool is_integer = (aExponent == std::trunc(aExponent));
+        bool is_odd = is_integer && (std::fmod(aExponent, 2.0f) != 0.0f);
+
+        unsigned int i = 0;
+        for (; i + VECTOR_SIZE <= aNumberOfPixels; i += VECTOR_SIZE)
+        {
+            store(apOutput + i, fastPow(load(apInput + i), aExponent, is_integer, is_odd));
+        }
+
+        for (; i < aNumberOfPixels; ++i)
+        {
+            apOutput[i] = fastPow(apInput[i], aExponent, is_integer, is_odd);
+        }
+    }
+
+
+    void sqrt(const float* apInput, float* apOutput, unsigned int aNumberOfPixels)
+    {
+        unsigned int i = 0;
+        for (; i + VECTOR_SIZE <= aNumberOfPixels; i += VECTOR_SIZE)
+        {
+            store(apOutput + i, sqrt(load(apInput + i)));
+        }
+
+        for (; i < aNumberOfPixels; ++i)
+        {
+            apOutput[i] = std::sqrt(apInput[i]);
+        }
+    }
+#else
+    void fastExp(const float* apInput, float* apOutput, unsigned int aNumberOfPixels)
+    {
+        for (unsigned int i = 0; i < aNumberOfPixels; ++i)
+        {
+            apOutput[i] = fastExp(apInput[i]);
+        }
+    }
+
+
+    void fastPow(const float* apInput, float* apOutput, unsigned int aNumberOfPixels,
+                 float aExponent)
+    {
+        if (isSpecialExponent(aExponent))
+        {
+            pow(apInput, apOutput, aNumberOfPixels, aExponent);
+            return;
+        }
+
+        bool is_integer = (aExponent == std::trunc(aExponent));
+        bool is_odd = is_integer && (std::fmod(aExponent, 2.0f) != 0.0f);
+
+        for (unsigned int i = 0; i < aNumberOfPixels; ++i)
+        {
+            apOutput[i] = fastPow(apInput[i], aExponent, is_integer, is_odd);
+        }
+    }
+
+
+    void sqrt(const float* apInput, float* apOutput, unsigned int aNumberOfPixels)
+    {
+        for (unsigned int i = 0; i < aNumberOfPixels; ++i)
+        {
+            apOutput[i] = std::sqrt(apInput[i]);
+        }
+    }
+#endif
+
+
+    //--------------------------------------------------------------------------
+    /// Reductions. The sums use SUM_LANES partial sums: the value i is added
+    /// to the partial sum i % SUM_LANES, the partial sums are added pairwise
+    /// (lane j and lane j + 16, then lane j and lane j + 8, etc.), then the
+    /// values after the last multiple of SUM_LANES are added from left to
+    /// right. All the variants perform the same additions in the same order,
+    /// hence give the same results, and the independent partial sums hide
+    /// the latency of the additions.
+    //--------------------------------------------------------------------------
+    const unsigned int SUM_LANES = 32;
+
+
+    float addLanes(float* apLaneSet)
+    {
+        for (unsigned int stride = SUM_LANES / 2; stride > 0; stride /= 2)
+        {
+            for (unsigned int i = 0; i < stride; ++i)
+            {
+                apLaneSet[i] += apLaneSet[i + stride];
+            }
+        }
+
+        return apLaneSet[0];
+    }
+
+
+    void getMinMaxScalar(const float* apInput, unsigned int aNumberOfPixels,
+                         float& aMin, float& aMax)
+    {
+        for (unsigned int i = 0; i < aNumberOfPixels; ++i)
+        {
+            if (aMin > apInput[i]) aMin = apInput[i];
+            if (aMax < apInput[i]) aMax = apInput[i];
+        }
+    }
+
+
+    unsigned int compareScalar(const float* apInput1, const float* apInput2,
+                               unsigned int aNumberOfPixels,
+                               float aTolerance, float& aMaxDifference)
+    {
+        for (unsigned int i = 0; i < aNumberOfPixels; ++i)
+        {
+            float difference = std::abs(apInput1[i] - apInput2[i]);
+
+            // NaN is a mismatch
+            if (!(difference <= aMaxDifference)) aMaxDifference = difference;
+            if (!(difference <= aTolerance)) return i;
+        }
+
+        return aNumberOfPixels;
+    }
+
+
+#if defined(IMAGE_KERNELS_USE_AVX2) || defined(IMAGE_KERNELS_USE_AVX512)
+    void getMinMax(const float* apInput, unsigned int aNumberOfPixels,
+                   float& aMin, float& aMax)
+    {
+        Vector min_vector = set1(std::numeric_limits<float>::infinity());
+        Vector max_vector = set1(-std::numeric_limits<float>::infinity());
+
+        // The NaN values are ignored, as in the scalar version
+        unsigned int i = 0;
+        for (; i + VECTOR_SIZE <= aNumberOfPixels; i += VECTOR_SIZE)
+        {
+            Vector value = load(apInput + i);
+            min_vector = min(value, min_vector);
+            max_vector = max(value, max_vector);
+        }
+
+        float min_set[VECTOR_SIZE];
+        float max_set[VECTOR_SIZE];
+        store(min_set, min_vector);
+        store(max_set, max_vector);
+
+        aMin = std::numeric_limits<float>::infinity();
+        aMax = -std::numeric_limits<float>::infinity();
+        for (unsigned int j = 0; j < VECTOR_SIZE; ++j)
+        {
+            if (aMin > min_set[j]) aMin = min_set[j];
+            if (aMax < max_set[j]) aMax = max_set[j];
+        }
+
+        getMinMaxScalar(apInput + i, aNumberOfPixels - i, aMin, aMax);
+    }
+
+
+    float getSum(const float* apInput, unsigned int aNumberOfPixels)
+    {
+        const unsigned int NUMBER_OF_VECTORS = SUM_LANES / VECTOR_SIZE;
+
+        Vector sum_set[NUMBER_OF_VECTORS];
+        for (unsigned int j = 0; j < NUMBER_OF_VECTORS; ++j)
+        {
+            sum_set[j] = set1(0.0f);
+        }
+
+        unsigned int i = 0;
+        for (; i + SUM_LANES <= aNumberOfPixels; i += SUM_LANES)
+        {
+            for (unsigned int j = 0; j < NUMBER_OF_VECTORS; ++j)
+            {
+                sum_set[j] = add(sum_set[j], load(apInput + i + j * VECTOR_SIZE));
+            }
+        }
+
+        float lane_set[SUM_LANES];
+        for (unsigned int j = 0; j < NUMBER_OF_VECTORS; ++j)
+        {
+            store(lane_set + j * VECTOR_SIZE, sum_set[j]);
+        }
+
+        float sum = addLanes(lane_set);
+        for (; i < aNumberOfPixels; ++i)
+        {
+            sum += apInput[i];
+        }
+
+        return sum;
+    }
+
+
+    float getSumOfSquaredDifferences(const float* apInput, unsigned int aNumberOfPixels,
+                                     float aMean)
+    {
+        const unsigned int NUMBER_OF_VECTORS = SUM_LANES / VECTOR_SIZE;
+        const Vector mean = set1(aMean);
+
+        Vector sum_set[NUMBER_OF_VECTORS];
+        for (unsigned int j = 0; j < NUMBER_OF_VECTORS; ++j)
+        {
+            sum_set[j] = set1(0.0f);
+        }
+
+        unsigned int i = 0;
+        for (; i + SUM_LANES <= aNumberOfPixels; i += SUM_LANES)
+        {
+            for (unsigned int j = 0; j < NUMBER_OF_VECTORS; ++j)
+            {
+                Vector difference = sub(load(apInput + i + j * VECTOR_SIZE), mean);
+                sum_set[j] = add(sum_set[j], mul(difference, difference));
+            }
+        }
+
+        float lane_set[SUM_LANES];
+        for (unsigned int j = 0; j < NUMBER_OF_VECTORS; ++j)
+        {
+            store(lane_set + j * VECTOR_SIZE, sum_set[j]);
+        }
+
+        float sum = addLanes(lane_set);
+        for (; i < aNumberOfPixels; ++i)
+        {
+            sum += (apInput[i] - aMean) * (apInput[i] - aMean);
+        }
+
+        return sum;
+    }
+
+
+    unsigned int compare(const float* apInput1, const float* apInput2,
+                         unsigned int aNumberOfPixels,
+                         float aTolerance, float& aMaxDifference)
+    {
+        const Vector tolerance = set1(aTolerance);
+        Vector max_vector = set1(0.0f);
+
+        // Stop at the first vector that holds a mismatch
+        unsigned int i = 0;
+        for (; i + VECTOR_SIZE <= aNumberOfPixels; i += VECTOR_SIZE)
+        {
+            Vector difference = abs(sub(load(apInput1 + i), load(apInput2 + i)));
+            if (isAnyGreater(difference, tolerance)) break;
+
+            max_vector = max(difference, max_vector);
+        }
+
+        float max_set[VECTOR_SIZE];
+        store(max_set, max_vector);
+
+        aMaxDifference = 0.0f;
+        for (unsigned int j = 0; j < VECTOR_SIZE; ++j)
+        {
+            if (aMaxDifference < max_set[j]) aMaxDifference = max_set[j];
+        }
+
+        // Find the mismatch in this vector, or process the remaining values
+        return i + compareScalar(apInput1 + i, apInput2 + i, aNumberOfPixels - i,
+                                 aTolerance, aMaxDifference);
+    }
+#else
+    void getMinMax(const float* apInput, unsigned int aNumberOfPixels,
+                   float& aMin, float& aMax)
+    {
+        aMin = std::numeric_limits<float>::infinity();
+        aMax = -std::numeric_limits<float>::infinity();
+        getMinMaxScalar(apInput, aNumberOfPixels, aMin, aMax);
+    }
+
+
+    float getSum(const float* apInput, unsigned int aNumberOfPixels)
+    {
+        float lane_set[SUM_LANES] = {};
+
+        unsigned int i = 0;
+        for (; i + SUM_LANES <= aNumberOfPixels; i += SUM_LANES)
+        {
+            for (unsigned int j = 0; j < SUM_LANES; ++j)
+            {
+                lane_set[j] += apInput[i + j];
+            }
+        }
+
+        float sum = addLanes(lane_set);
+        for (; i < aNumberOfPixels; ++i)
+        {
+            sum += apInput[i];
+        }
+
+        return sum;
+    }
+
+
+    float getSumOfSquaredDifferences(const float* apInput, unsigned int aNumberOfPixels,
+                                     float aMean)
+    {
+        float lane_set[SUM_LANES] = {};
+
+        unsigned int i = 0;
+        for (; i + SUM_LANES <= aNumberOfPixels; i += SUM_LANES)
+        {
+            for (unsigned int j = 0; j < SUM_LANES; ++j)
+            {
+                lane_set[j] += (apInput[i + j] - aMean) * (apInput[i + j] - aMean);
+            }
+        }
+
+        float sum = addLanes(lane_set);
+        for (; i < aNumberOfPixels; ++i)
+        {
+            sum += (apInput[i] - aMean) * (apInput[i] - aMean);
+        }
+
+        return sum;
+    }
+
+
+    unsigned int compare(const float* apInput1, const float* apInput2,
+                         unsigned int aNumberOfPixels,
+                         float aTolerance, float& aMaxDifference)
+    {
+        aMaxDifference = 0.0f;
+        return compareScalar(apInput1, apInput2, aNumberOfPixels, aTolerance, aMaxDifference);
+    }
+#endif
+
+
+    void accumulate(const float* apInput, unsigned int aNumberOfPixels,
+                    ReproducibleAccumulator& anAccumulator)
+    {
+        for (unsigned int i = 0; i < aNumberOfPixels; ++i)
+        {
+            anAccumulator.add(apInput[i]);
+        }
+    }
+
+
+    void accumulateSquaredDifferences(const float* apInput, unsigned int aNumberOfPixels,
+                                      float aMean,
+                                      ReproducibleAccumulator& anAccumulator)
+    {
+        for (unsigned int i = 0; i < aNumberOfPixels; ++i)
+        {
+            anAccumulator.add((apInput[i] - aMean) * (apInput[i] - aMean));
+        }
+    }
+
+
+    //--------------------------------------------------------------------------
+    /// Text parsing (see AsciiParser): one bit per character in three masks,
+    /// digits, spaces (' ', '\t', '\v', '\f', '\r') and new lines
+    //--------------------------------------------------------------------------
+    void classifyCharactersScalar(const char* apText, unsigned int aLength,
+                                  std::uint64_t* apDigitMask,
+                                  std::uint64_t* apSpaceMask,
+                                  std::uint64_t* apNewLineMask)
+    {
+        for (unsigned int i = 0; i < aLength; ++i)
+        {
+            unsigned char c = apText[i];
+            std::uint64_t bit = std::uint64_t(1) << (i % 64);
+
+            if (i % 64 == 0)
+            {
+                apDigitMask[i / 64] = 0;
+                apSpaceMask[i / 64] = 0;
+                apNewLineMask[i / 64] = 0;
+            }
+
+            if (c >= '0' && c <= '9') apDigitMask[i / 64] |= bit;
+            if (c == ' ' || (c >= '\t' && c <= '\r' && c != '\n')) apSpaceMask[i / 64] |= bit;
+            if (c == '\n') apNewLineMask[i / 64] |= bit;
+        }
+    }
+
+
+#if defined(IMAGE_KERNELS_USE_AVX2) || defined(IMAGE_KERNELS_USE_AVX512)
+    // The byte comparisons of AVX-512 need AVX512BW, which the AVX-512
+    // variant does not require: both variants compare 32 bytes at once
+    inline std::uint64_t getMask(__m256i aMask)
+    {
+        return std::uint32_t(_mm256_movemask_epi8(aMask));
+    }
+
+
+    void classifyCharacters(const char* apText, unsigned int aLength,
+                            std::uint64_t* apDigitMask,
+                            std::uint64_t* apSpaceMask,
+                            std::uint64_t* apNewLineMask)
+    {
+        const __m256i before_zero = _mm256_set1_epi8('0' - 1);
+        const __m256i after_nine = _mm256_set1_epi8('9' + 1);
+        const __m256i space = _mm256_set1_epi8(' ');
+        const __m256i before_tab = _mm256_set1_epi8('\t' - 1);
+        const __m256i after_carriage_return = _mm256_set1_epi8('\r' + 1);
+        const __m256i new_line = _mm256_set1_epi8('\n');
+
+        unsigned int i = 0;
+        for (; i + 32 <= aLength; i += 32)
+        {
+            // Signed comparisons: the bytes above 127 are negative, hence
+            // neither digits nor spaces
+            __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(apText + i));
+
+            __m256i is_digit = _mm256_and_si256(_mm256_cmpgt_epi8(c, before_zero),
+                                                _mm256_cmpgt_epi8(after_nine, c));
+
+            __m256i is_new_line = _mm256_cmpeq_epi8(c, new_line);
+
+            __m256i is_space = _mm256_and_si256(_mm256_cmpgt_epi8(c, before_tab),
+                                                _mm256_cmpgt_epi8(after_carriage_return, c));
+            is_space = _mm256_or_si256(_mm256_andnot_si256(is_new_line, is_space),
+                                       _mm256_cmpeq_epi8(c, space));
+
+            // Two blocks of 32 characters per word
+            unsigned int shift = i % 64;
+            if (!shift)
+            {
+                apDigitMask[i / 64] = getMask(is_digit);
+                apSpaceMask[i / 64] = getMask(is_space);
+                apNewLineMask[i / 64] = getMask(is_new_line);
+            }
+            else
+            {
+                apDigitMask[i / 64] |= getMask(is_digit) << shift;
+                apSpaceMask[i / 64] |= getMask(is_space) << shift;
+                apNewLineMask[i / 64] |= getMask(is_new_line) << shift;
+            }
+        }
+
+        // The last characters
+        if (i < aLength)
+        {
+            std::uint64_t digit_mask, space_mask, new_line_mask;
+            classifyCharactersScalar(apText + i, aLength - i, &digit_mask, &space_mask, &new_line_mask);
+
+            unsigned int shift = i % 64;
+            if (!shift)
+            {
+                apDigitMask[i / 64] = digit_mask;
+                apSpaceMask[i / 64] = space_mask;
+                apNewLineMask[i / 64] = new_line_mask;
+            }
+            else
+            {
+                apDigitMask[i / 64] |= digit_mask << shift;
+                apSpaceMask[i / 64] |= space_mask << shift;
+                apNewLineMask[i / 64] |= new_line_mask << shift;
+            }
+        }
+    }
+#else
+    void classifyCharacters(const char* apText, unsigned int aLength,
+                            std::uint64_t* apDigitMask,
+                            std::uint64_t* apSpaceMask,
+                            std::uint64_t* apNewLineMask)
+    {
+        classifyCharactersScalar(apText, aLength, apDigitMask, apSpaceMask, apNewLineMask);
+    }
+#endif
+}
+
+
+    //--------------------------------------------------------------------------
+    /// The kernels of the variant
+    //--------------------------------------------------------------------------
+    const ImageKernels KERNELS =
+    {
+        IMAGE_KERNELS_ISA,
+        negate,
+        shiftScale,
+        log,
+        fastLog,
+        exp,
+        fastExp,
+        pow,
+        fastPow,
+        sqrt,
+        applyLUT,
+        floatToHalf,
+        halfToFloat,
+        floatToBFloat16,
+        bfloat16ToFloat,
+        reverseRow,
+        reverseRowInPlace,
+        streamCopy,
+        getMinMax,
+        getSum,
+        getSumOfSquaredDifferences,
+        accumulate,
+        accumulateSquaredDifferences,
+        compare,
+        classifyCharacters
+    };
+}
+
+#pragma GCC pop_options
@@ -0,0 +1,196 @@
+#ifndef __ParallelReduction_h
+#define __ParallelReduction_h
+
+
+/**
+********************************************************************************
+*
+*   @file       ParallelReduction.h
+*
+*   @brief      Per-thread partial results padded to a cache line, combined
+*               with a deterministic tree.
+*
+*   @version    1.0
+*
+*   @date       19/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//  Include
+//******************************************************************************
+#include <algorithm> // Header file for min and max
+#include <vector>
+
+#include "AlignedAllocator.h"
+
+
+//******************************************************************************
+//  Define
+//******************************************************************************
+#define CACHE_LINE_SIZE 64
+
+
+//------------------------------------------------------------------------------
+/// Range of elements processed by a task. The elements are split as evenly
+/// as possible, the first tasks get one more element if needed.
+/**
+* @param aNumberOfElements: the total number of elements
+* @param aNumberOfTasks: the number of tasks
+* @param aTaskID: the task
+* @param aStartID: the first element of the task
+* @param anEndID: the element after the last one of the task
+*/
+//------------------------------------------------------------------------------
+inline void getTaskRange(unsigned int aNumberOfElements,
+                         unsigned int aNumberOfTasks,
+                         unsigned int aTaskID,
+                         unsigned int& aStartID,
+                         unsigned int& anEndID)
+{
+    unsigned int element_per_task = aNumberOfElements / aNumberOfTasks;
+    unsigned int remainder = aNumberOfElements % aNumberOfTasks;
+
+    aStartID = aTaskID * element_per_task + std::min(aTaskID, remainder);
+    anEndID = aStartID + element_per_task + (aTaskID < remainder ? 1 : 0);
+}
+
+
+//==============================================================================
+/**
+*   @class  ParallelReduction
+*   @brief  ParallelReduction stores one partial result per task. Each slot
+*           is aligned on its own cache line, so that threads updating their
+*           partial results do not invalidate each other's cache lines
+*           (false sharing). The partial results are combined with a pairwise
+*           tree whose shape only depends on the number of tasks, so that the
+*           result is bit-identical from one run to another for a given
+*           number of tasks, whichever thread processed which task.
+*/
+//==============================================================================
+template<typename T> class ParallelReduction
+//------------------------------------------------------------------------------
+{
+//******************************************************************************
+public:
+    //--------------------------------------------------------------------------
+    /// Constructor.
+    /**
+    * @param aNumberOfTasks: the number of partial results (at least 1)
+    * @param anIdentity: the initial value of every partial result
+    */
+    //--------------------------------------------------------------------------
+    ParallelReduction(unsigned int aNumberOfTasks, const T& anIdentity):
+            m_slot_set(std::max(1u, aNumberOfTasks))
+    {
+        for (unsigned int i = 0; i < m_slot_set.size(); ++i)
+        {
+            m_slot_set[i].value = anIdentity;
+        }
+    }
+
+
+    //--------------------------------------------------------------------------
+    /// Number of partial results.
+    /**
+    * @return the number of tasks
+    */
+    //--------------------------------------------------------------------------
+    unsigned int size() const
+    {
+        return m_slot_set.size();
+    }
+
+
+    //--------------------------------------------------------------------------
+    /// Accessor on the partial result of a task.
+    /**
+    * @param aTaskID: the task
+    * @return the partial result
+    */
+    //--------------------------------------------------------------------------
+    T& operator[](unsigned int aTaskID)
+    {
+        return m_slot_set[aTaskID].value;
+    }
+
+
+    //--------------------------------------------------------------------------
+    /// Accessor on the partial result of a task.
+    /**
+    * @param aTaskID: the task
+    * @return the partial result
+    */
+    //--------------------------------------------------------------------------
+    const T& operator[](unsigned int aTaskID) const
+    {
+        return m_slot_set[aTaskID].value;
+    }
+
+
+    //--------------------------------------------------------------------------
+    /// Range of elements processed by a task (see getTaskRange()).
+    /**
+    * @param aNumberOfElements: the total number of elements
+    * @param aTaskID: the task
+    * @param aStartID: the first element of the task
+    * @param anEndID: the element after the last one of the task
+    */
+    //--------------------------------------------------------------------------
+    void getRange(unsigned int aNumberOfElements,
+                  unsigned int aTaskID,
+                  unsigned int& aStartID,
+                  unsigned int& anEndID) const
+    {
+        getTaskRange(aNumberOfElements, size(), aTaskID, aStartID, anEndID);
+    }
+
+
+    //--------------------------------------------------------------------------
+    /// Combine the partial results with a pairwise tree:
+    /// ((0 1) (2 3)) ((4 5) (6 7)) ...
+    /**
+    * @param anOperation: the binary operation, e.g. std::plus<T>()
+    * @return the result of the reduction
+    */
+    //--------------------------------------------------------------------------
+    template<typename BinaryOperation> T combine(BinaryOperation anOperation) const
+    {
+        std::vector<T> temp(size());
+        for (unsigned int i = 0; i < size(); ++i)
+        {
+            temp[i] = m_slot_set[i].value;
+        }
+
+        for (unsigned int stride = 1; stride < size(); stride *= 2)
+        {
+            for (unsigned int i = 0; i + stride < size(); i += 2 * stride)
+            {
+                temp[i] = anOperation(temp[i], temp[i + stride]);
+            }
+        }
+
+        return temp[0];
+    }
+
+
+//******************************************************************************
+private:
+    /// A partial result on its own cache line
+    struct alignas(CACHE_LINE_SIZE) Slot
+    {
+        T value;
+    };
+
+
+    /// The partial results, the allocator keeps the slots on their cache
+    /// lines before C++17
+    std::vector<Slot, AlignedAllocator<Slot, CACHE_LINE_SIZE> > m_slot_set;
+};
+
+#endif
@@ -0,0 +1,191 @@
+#ifndef __PointLUT_h
+#define __PointLUT_h
+
+
+/**
+********************************************************************************
+*
+*   @file       PointLUT.h
+*
+*   @brief      Lookup table (LUT) to apply a chain of point operators to an
+*               image whose pixel values are integers in [0, 255] or
+*               [0, 65535], e.g. an 8-bit or a 16-bit scene.
+*
+*   @version    1.0
+*
+*   @date       19/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//  Include
+//******************************************************************************
+#include <vector>
+
+#include "Image.h"
+
+
+//==============================================================================
+/**
+*   @class  PointLUT
+*   @brief  PointLUT stores the output of a chain of point operators for
+*           every possible input value. The operators are applied to the
+*           table, not to the image, with the same kernels as the image
+*           filters, so that Image::applyLUT() gives exactly the same pixel
+*           values as the chain of filters, e.g.
+*           image.applyLUT(PointLUT(image).shiftScaleFilter(a, b).logFilter())
+*           is equal to image.shiftScaleFilter(a, b).logFilter(), but the
+*           pixels are read and written only once.
+*/
+//==============================================================================
+class PointLUT
+//------------------------------------------------------------------------------
+{
+//******************************************************************************
+public:
+    /// Number of entries for 8-bit inputs
+    static const unsigned int UINT8_SIZE = 256;
+
+
+    /// Number of entries for 16-bit inputs
+    static const unsigned int UINT16_SIZE = 65536;
+
+
+    //--------------------------------------------------------------------------
+    /// Constructor. The number of entries is detected from the pixel values:
+    /// 256 if they are all in [0, 255], 65536 otherwise. The values that
+    /// occur in the image are recorded, so that getMinValue() and
+    /// getMaxValue() are the ones of the filtered image.
+    /**
+    * @param anImage: the image the table will be applied to
+    */
+    //--------------------------------------------------------------------------
+    PointLUT(const Image& anImage);
+
+
+    //--------------------------------------------------------------------------
+    /// Constructor from the input values that occur, e.g. the values of the
+    /// blocks of several MPI processes combined. The number of entries is
+    /// detected as from an image.
+    /**
+    * @param anOccurrenceSet: 1 if the input value occurs, 0 otherwise
+    *        (at most UINT16_SIZE values, see getOccurrenceSet())
+    */
+    //--------------------------------------------------------------------------
+    PointLUT(const std::vector<char>& anOccurrenceSet);
+
+
+    //--------------------------------------------------------------------------
+    /// Constructor. The number of entries is given: every input value is
+    /// assumed to occur.
+    /**
+    * @param aNumberOfEntries: UINT8_SIZE or UINT16_SIZE
+    */
+    //--------------------------------------------------------------------------
+    PointLUT(unsigned int aNumberOfEntries = UINT8_SIZE);
+
+
+    //--------------------------------------------------------------------------
+    /// Record the values of a set of pixels, e.g. a part of an image. An
+    /// exception is thrown if a pixel is not an integer in [0, 65535].
+    /**
+    * @param apPixelSet: the pixels
+    * @param aNumberOfPixels: the number of pixels
+    * @return UINT16_SIZE flags, 1 if the value occurs, 0 otherwise
+    */
+    //--------------------------------------------------------------------------
+    static std::vector<char> getOccurrenceSet(const float* apPixelSet, unsigned int aNumberOfPixels);
+
+
+    //--------------------------------------------------------------------------
+    /// Number of entries of the table.
+    /**
+    * @return UINT8_SIZE or UINT16_SIZE
+    */
+    //--------------------------------------------------------------------------
+    unsigned int getNumberOfEntries() const;
+
+
+    //--------------------------------------------------------------------------
+    /// Accessor on the table.
+    /**
+    * @return the output value of every input value
+    */
+    //--------------------------------------------------------------------------
+    const std::vector<float>& getTable() const;
+
+
+    //--------------------------------------------------------------------------
+    /// Smallest output value of the input values that occur.
+    /**
+    * @return the smallest value
+    */
+    //--------------------------------------------------------------------------
+    float getMinValue() const;
+
+
+    //--------------------------------------------------------------------------
+    /// Largest output value of the input values that occur.
+    /**
+    * @return the largest value
+    */
+    //--------------------------------------------------------------------------
+    float getMaxValue() const;
+
+
+    //--------------------------------------------------------------------------
+    /// Compose with the negative operator (see Image::operator!()).
+    /**
+    * @return the new table
+    */
+    //--------------------------------------------------------------------------
+    PointLUT operator!() const;
+
+
+    //--------------------------------------------------------------------------
+    /// Compose with the shift/scale filter (see Image::shiftScaleFilter()).
+    /**
+    * @param aShiftValue: the shift value
+    * @param aScaleValue: the scale value
+    * @return the new table
+    */
+    //--------------------------------------------------------------------------
+    PointLUT shiftScaleFilter(float aShiftValue, float aScaleValue) const;
+
+
+    //--------------------------------------------------------------------------
+    /// Compose with the normalisation (see Image::getNormalised()).
+    /**
+    * @return the new table
+    */
+    //--------------------------------------------------------------------------
+    PointLUT getNormalised() const;
+
+
+    //--------------------------------------------------------------------------
+    /// Compose with the log filter (see Image::logFilter()). The log mode
+    /// of the images is used.
+    /**
+    * @return the new table
+    */
+    //--------------------------------------------------------------------------
+    PointLUT logFilter() const;
+
+
+//******************************************************************************
+private:
+    /// Output value of every input value
+    std::vector<float> m_table;
+
+
+    /// 1 if the input value occurs in the image, 0 otherwise
+    std::vector<char> m_occurrence_set;
+};
+
+
+#endif
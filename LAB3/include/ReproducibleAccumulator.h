@@ -0,0 +1,186 @@
+#ifndef __ReproducibleAccumulator_h
+#define __ReproducibleAccumulator_h
+
+
+/**
+********************************************************************************
+*
+*   @file       ReproducibleAccumulator.h
+*
+*   @brief      Exact accumulator of single precision values, whose result
+*               does not depend on the order of the additions.
+*
+*   @version    1.0
+*
+*   @date       19/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//  Include
+//******************************************************************************
+#include <cstdint>
+#include <cstring> // Header file for memcpy
+
+
+//==============================================================================
+/**
+*   @class  ReproducibleAccumulator
+*   @brief  ReproducibleAccumulator adds single precision values exactly.
+*           Every finite float is an integer multiple of 2^-149, so the sum
+*           is stored as a 320-bit fixed-point integer split in ten 32-bit
+*           chunks, each chunk being kept in a 64-bit integer so that the
+*           carries only need to be propagated from time to time. Integer
+*           additions are associative, hence the sum is bit-identical
+*           whatever the order of the additions, the number of threads or
+*           the number of MPI processes. The result is rounded only once,
+*           by getSum().
+*/
+//==============================================================================
+class ReproducibleAccumulator
+//------------------------------------------------------------------------------
+{
+//******************************************************************************
+public:
+    /// Number of 32-bit chunks of the fixed-point integer
+    static const unsigned int NUMBER_OF_CHUNKS = 10;
+
+
+    /// Number of 64-bit integers of the state: the chunks, then the number
+    /// of +inf, -inf and NaN values that have been added
+    static const unsigned int STATE_SIZE = NUMBER_OF_CHUNKS + 3;
+
+
+    //--------------------------------------------------------------------------
+    /// Default constructor. The sum is zero.
+    //--------------------------------------------------------------------------
+    ReproducibleAccumulator();
+
+
+    //--------------------------------------------------------------------------
+    /// Add a value.
+    /**
+    * @param aValue: the value to add
+    */
+    //--------------------------------------------------------------------------
+    void add(float aValue)
+    {
+        std::uint32_t bits;
+        std::memcpy(&bits, &aValue, sizeof(bits));
+
+        std::uint32_t exponent = (bits >> 23) & 0xFF;
+        std::int64_t mantissa = bits & 0x7FFFFF;
+
+        // Infinity or NaN
+        if (exponent == 0xFF)
+        {
+            addNonFinite(aValue);
+            return;
+        }
+
+        // aValue = mantissa * 2^(shift - 149)
+        if (exponent)
+        {
+            mantissa |= 0x800000;
+        }
+        else
+        {
+            exponent = 1;
+        }
+
+        unsigned int shift = exponent - 1;
+        std::int64_t shifted_mantissa = mantissa << (shift & 31);
+
+        if (bits >> 31)
+        {
+            shifted_mantissa = -shifted_mantissa;
+        }
+
+        // Spread the value on two consecutive chunks
+        m_state[(shift >> 5)]     += shifted_mantissa & 0xFFFFFFFF;
+        m_state[(shift >> 5) + 1] += shifted_mantissa >> 32;
+
+        // Every chunk grows by less than 2^32 per addition
+        if (++m_number_of_pending_additions == (1u << 30))
+        {
+            normalise();
+        }
+    }
+
+
+    //--------------------------------------------------------------------------
+    /// Add the values of another accumulator.
+    /**
+    * @param anAccumulator: the accumulator to add
+    * @return the updated version of the current accumulator
+    */
+    //--------------------------------------------------------------------------
+    ReproducibleAccumulator& operator+=(const ReproducibleAccumulator& anAccumulator);
+
+
+    //--------------------------------------------------------------------------
+    /// Add two accumulators.
+    /**
+    * @param anAccumulator: the accumulator to add
+    * @return the new accumulator
+    */
+    //--------------------------------------------------------------------------
+    ReproducibleAccumulator operator+(const ReproducibleAccumulator& anAccumulator) const;
+
+
+    //--------------------------------------------------------------------------
+    /// Propagate the carries, so that every chunk but the last one is in
+    /// [0, 2^32). The representation of a given sum is then unique.
+    //--------------------------------------------------------------------------
+    void normalise();
+
+
+    //--------------------------------------------------------------------------
+    /// Sum of all the values that have been added, rounded to a float.
+    /**
+    * @return the sum
+    */
+    //--------------------------------------------------------------------------
+    float getSum() const;
+
+
+    //--------------------------------------------------------------------------
+    /// Accessor on the state, e.g. to reduce the accumulators of several
+    /// MPI processes with MPI_SUM on STATE_SIZE MPI_INT64_T. The accumulators
+    /// must be normalised before.
+    /**
+    * @return the STATE_SIZE integers of the state
+    */
+    //--------------------------------------------------------------------------
+    std::int64_t* getState();
+
+
+    //--------------------------------------------------------------------------
+    /// Accessor on the state.
+    /**
+    * @return the STATE_SIZE integers of the state
+    */
+    //--------------------------------------------------------------------------
+    const std::int64_t* getState() const;
+
+
+//******************************************************************************
+private:
+    /// Count an infinity or a NaN
+    void addNonFinite(float aValue);
+
+
+    /// The chunks, then the number of +inf, -inf and NaN
+    std::int64_t m_state[STATE_SIZE];
+
+
+    /// Number of additions since the last normalisation
+    unsigned int m_number_of_pending_additions;
+};
+
+#endif
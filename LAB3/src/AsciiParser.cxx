@@ -0,0 +1,376 @@
+/**
+********************************************************************************
+*
+*   @file       AsciiParser.cxx
+*
+*   @brief      Parser of the numbers of a text file, e.g. the pixels of an
+*               ASCII image or of an ASCII PGM file. The characters are
+*               classified with SIMD comparisons and the digits are converted
+*               eight at a time.
+*
+*   @version    1.0
+*
+*   @date       19/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//  Include
+//******************************************************************************
+#include <algorithm> // Header file for min
+#include <cerrno>
+#include <cmath> // Header file for isinf
+#include <cstdlib> // Header file for strtof
+#include <cstring> // Header file for memcpy and memchr
+
+#include "AsciiParser.h"
+#include "ImageKernels.h"
+
+
+//******************************************************************************
+//  Constant variables
+//******************************************************************************
+namespace
+{
+    /// Null characters after the text: the digits are loaded 8 bytes at a
+    /// time, and std::strtof() stops there
+    const std::size_t PADDING = 64;
+
+
+    /// The window is classified again when fewer characters are left
+    const std::size_t MIN_WINDOW_LEFT = 64;
+
+
+    /// Size of the blocks read from a stream whose size is unknown (1 MB)
+    const std::size_t READ_BLOCK_SIZE = 1 << 20;
+
+
+    /// Largest number of digits converted directly: 10^19 < 2^64
+    const std::size_t MAX_DIGITS = 19;
+
+
+    /// Largest number of decimals converted directly: 10^10 is exact in
+    /// single precision
+    const std::size_t MAX_DECIMALS = 10;
+
+
+    /// Largest integer of the decimals converted directly, 2^24: the
+    /// integer and 10^n are exact in single precision, and their quotient
+    /// is rounded once, as by std::strtof()
+    const std::uint64_t MAX_DECIMAL_MANTISSA = 1 << 24;
+
+
+    const std::uint64_t POWERS_OF_TEN[] =
+    {
+        1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull,
+        10000000ull, 100000000ull, 1000000000ull, 10000000000ull
+    };
+
+
+    const float FLOAT_POWERS_OF_TEN[] =
+    {
+        1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+    };
+
+
+    //--------------------------------------------------------------------------
+    /// Convert 1 to 8 digits at once. The characters are loaded in a 64-bit
+    /// integer, the first one in the lowest byte, and shifted so that the
+    /// missing digits are leading zeros. The adjacent digits are then
+    /// combined pairwise: 2 digits per 16 bits, 4 per 32 bits, then 8.
+    //--------------------------------------------------------------------------
+    inline std::uint64_t parseEightDigits(const char* apText, std::size_t aNumberOfDigits)
+    {
+        std::uint64_t chunk;
+        std::memcpy(&chunk, apText, sizeof(chunk));
+
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        chunk = __builtin_bswap64(chunk);
+#endif
+
+        chunk <<= 8 * (8 - aNumberOfDigits);
+        chunk &= 0x0F0F0F0F0F0F0F0Full;
+        chunk = (chunk * 10 + (chunk >> 8)) & 0x00FF00FF00FF00FFull;
+        chunk = (chunk * 100 + (chunk >> 16)) & 0x0000FFFF0000FFFFull;
+        chunk = (chunk * 10000 + (chunk >> 32)) & 0x00000000FFFFFFFFull;
+
+        return chunk;
+    }
+
+
+    //--------------------------------------------------------------------------
+    /// Convert 1 to MAX_DIGITS digits
+    //--------------------------------------------------------------------------
+    inline std::uint64_t parseDigits(const char* apText, std::size_t aNumberOfDigits)
+    {
+        std::uint64_t value = 0;
+
+        while (aNumberOfDigits > 8)
+        {
+            value = value * POWERS_OF_TEN[8] + parseEightDigits(apText, 8);
+            apText += 8;
+            aNumberOfDigits -= 8;
+        }
+
+        return value * POWERS_OF_TEN[aNumberOfDigits] + parseEightDigits(apText, aNumberOfDigits);
+    }
+
+
+    //--------------------------------------------------------------------------
+    /// Check the bit of a character in a mask
+    //--------------------------------------------------------------------------
+    inline bool isSet(const std::uint64_t* apMask, std::size_t anIndex)
+    {
+        return (apMask[anIndex / 64] >> (anIndex % 64)) & 1;
+    }
+}
+
+
+//----------------------------------------------------
+AsciiParser::AsciiParser(std::istream& anInputStream):
+//----------------------------------------------------
+        m_length(0),
+        m_position(0),
+        m_window_start(0),
+        m_window_end(0)
+//----------------------------------------------------
+{
+    // Read the rest of the stream at once if its size is known
+    std::istream::pos_type start = anInputStream.tellg();
+    if (start != std::istream::pos_type(-1) && anInputStream.seekg(0, std::ios::end))
+    {
+        std::istream::pos_type end = anInputStream.tellg();
+        anInputStream.seekg(start);
+
+        if (end != std::istream::pos_type(-1) && end > start)
+        {
+            m_text.resize(end - start);
+            anInputStream.read(m_text.data(), m_text.size());
+            m_text.resize(anInputStream.gcount());
+        }
+    }
+    anInputStream.clear();
+
+    // Read what is left, if anything
+    while (anInputStream.good())
+    {
+        std::size_t size = m_text.size();
+        m_text.resize(size + READ_BLOCK_SIZE);
+        anInputStream.read(m_text.data() + size, READ_BLOCK_SIZE);
+        m_text.resize(size + anInputStream.gcount());
+    }
+
+    m_length = m_text.size();
+    m_text.resize(m_length + PADDING, '\0');
+}
+
+
+//-----------------------------
+bool AsciiParser::isEnd() const
+//-----------------------------
+{
+    return (m_position >= m_length);
+}
+
+
+//----------------------------------------
+char AsciiParser::getNextCharacter() const
+//----------------------------------------
+{
+    return (isEnd()) ? '\0' : m_text[m_position];
+}
+
+
+//--------------------------
+void AsciiParser::skipLine()
+//--------------------------
+{
+    if (isEnd())
+    {
+        return;
+    }
+
+    const char* p_new_line = static_cast<const char*>(
+            std::memchr(&m_text[m_position], '\n', m_length - m_position));
+
+    m_position = (p_new_line) ? (p_new_line - m_text.data() + 1) : m_length;
+}
+
+
+//---------------------------------------------------------
+unsigned int AsciiParser::parseLine(ValueVector& aValueSet)
+//---------------------------------------------------------
+{
+    unsigned int number_of_values = 0;
+
+    while (!isEnd())
+    {
+        // Skip the spaces, maybe over several windows
+        do
+        {
+            updateWindow(m_position);
+            m_position += getRunLength(m_p_space_mask, m_position);
+        }
+        while (m_position == m_window_end && m_window_end < m_length);
+
+        // End of the text
+        if (isEnd())
+        {
+            break;
+        }
+
+        // End of the line
+        if (m_text[m_position] == '\n')
+        {
+            ++m_position;
+            break;
+        }
+
+        // The next number is invalid: ignore the rest of the line
+        float value;
+        if (!parseNumber(value))
+        {
+            skipLine();
+            break;
+        }
+
+        aValueSet.push_back(value);
+        ++number_of_values;
+    }
+
+    return number_of_values;
+}
+
+
+//---------------------------------------------------
+void AsciiParser::updateWindow(std::size_t aPosition)
+//---------------------------------------------------
+{
+    // There are enough characters in the window, or the window ends with
+    // the text
+    if (aPosition >= m_window_start &&
+            (aPosition + MIN_WINDOW_LEFT <= m_window_end || m_window_end == m_length))
+    {
+        return;
+    }
+
+    m_window_start = aPosition;
+    m_window_end = std::min(m_length, aPosition + WINDOW_SIZE);
+
+    getImageKernels().classifyCharacters(&m_text[m_window_start],
+                                         m_window_end - m_window_start,
+                                         m_p_digit_mask,
+                                         m_p_space_mask,
+                                         m_p_new_line_mask);
+}
+
+
+//---------------------------------------------------------------------------------------------
+std::size_t AsciiParser::getRunLength(const std::uint64_t* apMask, std::size_t aPosition) const
+//---------------------------------------------------------------------------------------------
+{
+    if (aPosition >= m_window_end)
+    {
+        return 0;
+    }
+
+    std::size_t start = aPosition - m_window_start;
+    std::size_t end = m_window_end - m_window_start;
+
+    // Find the first character that is not in the class, 64 at a time
+    std::size_t i = start;
+    while (i < end)
+    {
+        std::uint64_t word = ~apMask[i / 64] >> (i % 64);
+
+        if (word)
+        {
+            i += __builtin_ctzll(word);
+            break;
+        }
+
+        i += 64 - i % 64;
+    }
+
+    return std::min(i, end) - start;
+}
+
+
+//------------------------------------------
+bool AsciiParser::parseNumber(float& aValue)
+//------------------------------------------
+{
+    const char* p_start = &m_text[m_position];
+
+    // A sign, digits, then a dot and digits
+    std::size_t digit_start = m_position;
+    bool is_negative = (m_text[digit_start] == '-');
+    if (is_negative || m_text[digit_start] == '+')
+    {
+        ++digit_start;
+    }
+
+    const char* p_digits = &m_text[digit_start];
+    std::size_t integer_length = getRunLength(m_p_digit_mask, digit_start);
+    std::size_t end = digit_start + integer_length;
+
+    std::size_t fraction_length = 0;
+    if (m_text[end] == '.')
+    {
+        fraction_length = getRunLength(m_p_digit_mask, end + 1);
+        end += 1 + fraction_length;
+    }
+
+    // The number is followed by a space, a new line or the end of the text
+    bool has_end = (end == m_length) ||
+            (end < m_window_end && (isSet(m_p_space_mask, end - m_window_start) ||
+                                    isSet(m_p_new_line_mask, end - m_window_start)));
+
+    std::size_t number_of_digits = integer_length + fraction_length;
+    if (has_end && number_of_digits && number_of_digits <= MAX_DIGITS && fraction_length <= MAX_DECIMALS)
+    {
+        std::uint64_t mantissa = (integer_length) ? parseDigits(p_digits, integer_length) : 0;
+
+        if (fraction_length)
+        {
+            mantissa = mantissa * POWERS_OF_TEN[fraction_length] +
+                    parseDigits(p_digits + integer_length + 1, fraction_length);
+        }
+
+        // Integer: the conversion is rounded once
+        if (!fraction_length)
+        {
+            aValue = float(mantissa);
+            if (is_negative) aValue = -aValue;
+            m_position = end;
+            return true;
+        }
+        // Simple decimal
+        else if (mantissa <= MAX_DECIMAL_MANTISSA)
+        {
+            aValue = float(mantissa) / FLOAT_POWERS_OF_TEN[fraction_length];
+            if (is_negative) aValue = -aValue;
+            m_position = end;
+            return true;
+        }
+    }
+
+    // Exponent, too many digits, infinity, etc. A number too large for a
+    // float is invalid, as with >> float.
+    char* p_end;
+    errno = 0;
+    aValue = std::strtof(p_start, &p_end);
+
+    if (p_end == p_start || (errno == ERANGE && std::isinf(aValue)))
+    {
+        return false;
+    }
+
+    m_position += p_end - p_start;
+    return true;
+}
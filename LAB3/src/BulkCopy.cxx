@@ -0,0 +1,161 @@
+/**
+********************************************************************************
+*
+*   @file       BulkCopy.cxx
+*
+*   @brief      Copy of large pixel arrays, e.g. by the copy constructors and
+*               the assignment operators of the images. Above a threshold,
+*               the array is split between several threads and copied with
+*               non-temporal stores, which bypass the caches.
+*
+*   @version    1.0
+*
+*   @date       19/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//  Include
+//******************************************************************************
+#include <algorithm> // Header file for min, max and copy
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <unistd.h> // Header file for sysconf
+
+#include "BulkCopy.h"
+#include "CpuTopology.h"
+#include "ImageKernels.h"
+
+
+//******************************************************************************
+//  Function declarations
+//******************************************************************************
+namespace
+{
+    /// Smallest number of pixels copied by a thread (4 MB)
+    const std::size_t MIN_PIXELS_PER_THREAD = 1 << 20;
+
+
+    /// The parts of the threads start on a page boundary (4 KB) of the array
+    const std::size_t PAGE_SIZE_IN_PIXELS = 1024;
+
+
+    /// Size of the last-level cache if it cannot be queried (32 MB)
+    const long DEFAULT_CACHE_SIZE = 32 << 20;
+
+
+    //--------------------------------------------------------------------------
+    /// Default threshold of bulkCopy(): the input and the output fill the
+    /// last-level cache
+    //--------------------------------------------------------------------------
+    std::size_t getDefaultThreshold()
+    {
+        long cache_size = -1;
+
+#ifdef _SC_LEVEL3_CACHE_SIZE
+        cache_size = sysconf(_SC_LEVEL3_CACHE_SIZE);
+#endif
+
+        if (cache_size <= 0)
+        {
+            cache_size = DEFAULT_CACHE_SIZE;
+        }
+
+        return cache_size / (2 * sizeof(float));
+    }
+
+
+    //--------------------------------------------------------------------------
+    /// The threshold of bulkCopy(), initialised the first time it is used
+    //--------------------------------------------------------------------------
+    std::size_t& getThreshold()
+    {
+        static std::size_t threshold = getDefaultThreshold();
+        return threshold;
+    }
+}
+
+
+//------------------------------------------------
+void bulkCopy(const float* apInput,
+              float* apOutput,
+              std::size_t aNumberOfPixels,
+              unsigned int aNumberOfThreads)
+//------------------------------------------------
+{
+    // Small array, or empty
+    if (aNumberOfPixels < std::max<std::size_t>(1, getThreshold()))
+    {
+        std::copy(apInput, apInput + aNumberOfPixels, apOutput);
+        return;
+    }
+
+    void (*stream_copy)(const float*, float*, unsigned int) = getImageKernels().streamCopy;
+
+    if (!aNumberOfThreads)
+    {
+        aNumberOfThreads = CpuTopology::getInstance().getNumberOfAllowedCPUs();
+    }
+
+    // Do not create threads that would copy only a few pixels
+    std::size_t number_of_threads = std::min<std::size_t>(std::max(1u, aNumberOfThreads),
+            std::max<std::size_t>(1, aNumberOfPixels / MIN_PIXELS_PER_THREAD));
+
+    std::size_t part_size = (aNumberOfPixels + number_of_threads - 1) / number_of_threads;
+    part_size = (part_size + PAGE_SIZE_IN_PIXELS - 1) / PAGE_SIZE_IN_PIXELS * PAGE_SIZE_IN_PIXELS;
+
+    // Create the threads for the parts 1, 2, ..., the current thread copies
+    // the first one. If a thread cannot be created, its part, and the ones
+    // after it, are copied by the current thread.
+    std::vector<std::thread> thread_set;
+    std::size_t start_id = part_size;
+
+    try
+    {
+        for (; start_id < aNumberOfPixels; start_id += part_size)
+        {
+            std::size_t size = std::min(part_size, aNumberOfPixels - start_id);
+            thread_set.push_back(std::thread(stream_copy, apInput + start_id, apOutput + start_id, size));
+        }
+    }
+    catch (const std::system_error&)
+    {
+        for (; start_id < aNumberOfPixels; start_id += part_size)
+        {
+            stream_copy(apInput + start_id, apOutput + start_id, std::min(part_size, aNumberOfPixels - start_id));
+        }
+    }
+
+    stream_copy(apInput, apOutput, std::min(part_size, aNumberOfPixels));
+
+    // Wait for the other threads
+    for (std::vector<std::thread>::iterator ite = thread_set.begin();
+            ite != thread_set.end();
+            ++ite)
+    {
+        ite->join();
+    }
+}
+
+
+//--------------------------------
+std::size_t getBulkCopyThreshold()
+//--------------------------------
+{
+    return getThreshold();
+}
+
+
+//----------------------------------------------------
+void setBulkCopyThreshold(std::size_t aNumberOfPixels)
+//----------------------------------------------------
+{
+    getThreshold() = aNumberOfPixels;
+}
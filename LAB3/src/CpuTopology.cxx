@@ -0,0 +1,379 @@
+/**
+********************************************************************************
+*
+*   @file       CpuTopology.cxx
+*
+*   @brief      Class to discover the CPU topology of the node (sockets,
+*               physical cores, SMT siblings) and the CPUs the process is
+*               allowed to use (affinity mask, cgroup quota, SLURM).
+*
+*   @version    1.0
+*
+*   @date       19/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//  Include
+//******************************************************************************
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE // For sched_getaffinity
+#endif
+
+#include <cstdlib>   // Header file for getenv and atoi
+#include <cmath>     // Header file for ceil
+#include <sstream>   // Header file for stringstream
+#include <fstream>   // Header file for filestream
+#include <iostream>  // Header file for cerr
+#include <algorithm> // Header file for min/max
+#include <set>
+#include <utility>
+#include <thread>    // Header file for hardware_concurrency
+
+#ifdef __linux__
+#include <sched.h>   // Header file for the affinity mask
+#endif
+
+#include "CpuTopology.h"
+
+
+//******************************************************************************
+//  Function declarations
+//******************************************************************************
+namespace
+{
+    //--------------------------------------------------------------------------
+    /// Read an integer from a file, return -1 if it does not exist
+    //--------------------------------------------------------------------------
+    int readInteger(const std::string& aFileName)
+    {
+        std::ifstream input_file(aFileName.c_str());
+        int value(-1);
+
+        if (input_file.is_open())
+        {
+            input_file >> value;
+            if (input_file.fail()) value = -1;
+        }
+
+        return value;
+    }
+
+
+    //--------------------------------------------------------------------------
+    /// Parse a CPU list such as "0-3,8-11"
+    //--------------------------------------------------------------------------
+    std::vector<unsigned int> parseCPUList(const std::string& aList)
+    {
+        std::vector<unsigned int> cpu_set;
+        std::stringstream list_parser(aList);
+        std::string range;
+
+        while (std::getline(list_parser, range, ','))
+        {
+            if (range.empty()) continue;
+
+            std::string::size_type dash = range.find('-');
+            unsigned int first = std::atoi(range.substr(0, dash).c_str());
+            unsigned int last = (dash == std::string::npos) ? first : std::atoi(range.substr(dash + 1).c_str());
+
+            for (unsigned int i = first; i <= last; ++i)
+            {
+                cpu_set.push_back(i);
+            }
+        }
+
+        return cpu_set;
+    }
+
+
+    //--------------------------------------------------------------------------
+    /// Number of CPUs allowed by the cgroup quota, 0 if there is no quota
+    //--------------------------------------------------------------------------
+    unsigned int getCgroupQuota()
+    {
+        // cgroup v2: "max 100000" or "200000 100000"
+        std::ifstream cpu_max("/sys/fs/cgroup/cpu.max");
+        if (cpu_max.is_open())
+        {
+            std::string quota;
+            double period(0);
+            cpu_max >> quota >> period;
+
+            if (quota != "max" && period > 0)
+            {
+                return std::max(1.0, std::ceil(std::atof(quota.c_str()) / period));
+            }
+
+            return 0;
+        }
+
+        // cgroup v1
+        int quota = readInteger("/sys/fs/cgroup/cpu/cpu.cfs_quota_us");
+        int period = readInteger("/sys/fs/cgroup/cpu/cpu.cfs_period_us");
+        if (quota > 0 && period > 0)
+        {
+            return std::max(1.0, std::ceil(double(quota) / period));
+        }
+
+        return 0;
+    }
+}
+
+
+//----------------------------------------------------
+const CpuTopology& CpuTopology::getInstance()
+//----------------------------------------------------
+{
+    static CpuTopology topology;
+    return topology;
+}
+
+
+//-------------------------
+CpuTopology::CpuTopology():
+//-------------------------
+        m_number_of_sockets(1),
+        m_number_of_physical_cores(0),
+        m_number_of_allowed_physical_cores(0),
+        m_number_of_allowed_cpus(0)
+//-------------------------
+{
+    // Logical CPUs that are online
+    std::ifstream online_file("/sys/devices/system/cpu/online");
+    std::string online_list;
+    std::vector<unsigned int> cpu_id_set;
+
+    if (online_file.is_open() && std::getline(online_file, online_list))
+    {
+        cpu_id_set = parseCPUList(online_list);
+    }
+
+    // No sysfs, assume one core per hardware thread
+    if (cpu_id_set.empty())
+    {
+        for (unsigned int i = 0; i < std::max(1u, std::thread::hardware_concurrency()); ++i)
+        {
+            cpu_id_set.push_back(i);
+        }
+    }
+
+#ifdef __linux__
+    // Affinity mask (cpuset cgroup, taskset, SLURM binding)
+    cpu_set_t affinity_mask;
+    CPU_ZERO(&affinity_mask);
+    bool has_affinity_mask = (sched_getaffinity(0, sizeof(affinity_mask), &affinity_mask) == 0);
+#endif
+
+    // Socket and core of every logical CPU
+    std::set<int> socket_set;
+    std::set<std::pair<int, int> > core_set;
+    std::set<std::pair<int, int> > allowed_core_set;
+
+    for (std::vector<unsigned int>::const_iterator ite = cpu_id_set.begin();
+            ite != cpu_id_set.end();
+            ++ite)
+    {
+        std::stringstream path;
+        path << "/sys/devices/system/cpu/cpu" << *ite << "/topology/";
+
+        LogicalCPU cpu;
+        cpu.id = *ite;
+        cpu.socket_id = std::max(0, readInteger(path.str() + "physical_package_id"));
+        cpu.core_id = readInteger(path.str() + "core_id");
+        cpu.is_allowed = true;
+
+        // Unknown core, assume no SMT
+        if (cpu.core_id < 0) cpu.core_id = *ite;
+
+#ifdef __linux__
+        if (has_affinity_mask)
+        {
+            cpu.is_allowed = CPU_ISSET(*ite, &affinity_mask);
+        }
+#endif
+
+        socket_set.insert(cpu.socket_id);
+        core_set.insert(std::make_pair(cpu.socket_id, cpu.core_id));
+
+        if (cpu.is_allowed)
+        {
+            ++m_number_of_allowed_cpus;
+            allowed_core_set.insert(std::make_pair(cpu.socket_id, cpu.core_id));
+        }
+
+        m_logical_cpu_set.push_back(cpu);
+    }
+
+    m_number_of_sockets = socket_set.size();
+    m_number_of_physical_cores = core_set.size();
+    m_number_of_allowed_physical_cores = allowed_core_set.size();
+
+    // CPU quota of the cgroup
+    unsigned int quota = getCgroupQuota();
+    if (quota)
+    {
+        m_number_of_allowed_cpus = std::min(m_number_of_allowed_cpus, quota);
+    }
+
+    // CPUs given by SLURM to the task
+    const char* p_slurm_cpus = std::getenv("SLURM_CPUS_PER_TASK");
+    if (p_slurm_cpus && std::atoi(p_slurm_cpus) > 0)
+    {
+        m_number_of_allowed_cpus = std::min(m_number_of_allowed_cpus, (unsigned int)std::atoi(p_slurm_cpus));
+    }
+
+    m_number_of_allowed_cpus = std::max(1u, m_number_of_allowed_cpus);
+    m_number_of_allowed_physical_cores = std::max(1u, std::min(m_number_of_allowed_physical_cores, m_number_of_allowed_cpus));
+}
+
+
+//---------------------------------------------------
+unsigned int CpuTopology::getNumberOfSockets() const
+//---------------------------------------------------
+{
+    return m_number_of_sockets;
+}
+
+
+//---------------------------------------------------------
+unsigned int CpuTopology::getNumberOfPhysicalCores() const
+//---------------------------------------------------------
+{
+    return m_number_of_physical_cores;
+}
+
+
+//-------------------------------------------------------
+unsigned int CpuTopology::getNumberOfLogicalCPUs() const
+//-------------------------------------------------------
+{
+    return m_logical_cpu_set.size();
+}
+
+
+//-------------------------------------------------------
+unsigned int CpuTopology::getNumberOfAllowedCPUs() const
+//-------------------------------------------------------
+{
+    return m_number_of_allowed_cpus;
+}
+
+
+//----------------------------------------------------------------
+unsigned int CpuTopology::getNumberOfAllowedPhysicalCores() const
+//----------------------------------------------------------------
+{
+    return m_number_of_allowed_physical_cores;
+}
+
+
+//-------------------------------------------------------------------------------
+unsigned int CpuTopology::resolveNumberOfThreads(unsigned int aNumberOfThreads,
+                                                 bool aPhysicalCoresOnlyFlag) const
+//-------------------------------------------------------------------------------
+{
+    unsigned int limit = aPhysicalCoresOnlyFlag ?
+            m_number_of_allowed_physical_cores : m_number_of_allowed_cpus;
+
+    // Use all the CPUs available
+    if (!aNumberOfThreads)
+    {
+        return limit;
+    }
+
+    // One thread per physical core at most
+    if (aPhysicalCoresOnlyFlag && aNumberOfThreads > limit)
+    {
+        std::cerr << "Warning: " << aNumberOfThreads <<
+            " threads requested, but only " << limit <<
+            " physical cores are allowed; using " << limit << " threads." <<
+            std::endl;
+
+        return limit;
+    }
+
+    // Oversubscription is allowed, but it is likely to be slower
+    if (aNumberOfThreads > m_number_of_allowed_cpus)
+    {
+        std::cerr << "Warning: " << aNumberOfThreads <<
+            " threads requested, but only " << m_number_of_allowed_cpus <<
+            " CPUs are allowed (" << toString() <<
+            "); the CPUs are oversubscribed." << std::endl;
+    }
+
+    return aNumberOfThreads;
+}
+
+
+//-------------------------------------------------
+bool CpuTopology::bindToPhysicalCores() const
+//-------------------------------------------------
+{
+#ifdef __linux__
+    cpu_set_t affinity_mask;
+    CPU_ZERO(&affinity_mask);
+
+    // Keep the first allowed logical CPU of every physical core
+    std::set<std::pair<int, int> > core_set;
+    for (std::vector<LogicalCPU>::const_iterator ite = m_logical_cpu_set.begin();
+            ite != m_logical_cpu_set.end();
+            ++ite)
+    {
+        if (ite->is_allowed &&
+            core_set.insert(std::make_pair(ite->socket_id, ite->core_id)).second)
+        {
+            CPU_SET(ite->id, &affinity_mask);
+        }
+    }
+
+    return (!core_set.empty() &&
+            sched_setaffinity(0, sizeof(affinity_mask), &affinity_mask) == 0);
+#else
+    return false;
+#endif
+}
+
+
+//------------------------------------------
+std::string CpuTopology::toString() const
+//------------------------------------------
+{
+    std::stringstream description;
+
+    description << m_number_of_sockets << " socket(s), " <<
+        m_number_of_physical_cores << " physical core(s), " <<
+        getNumberOfLogicalCPUs() << " logical CPU(s), " <<
+        m_number_of_allowed_cpus << " allowed CPU(s) on " <<
+        m_number_of_allowed_physical_cores << " physical core(s)";
+
+    return description.str();
+}
+
+
+//---------------------------------------
+std::string CpuTopology::toCSV() const
+//---------------------------------------
+{
+    std::stringstream fields;
+
+    fields << m_number_of_sockets << "," <<
+        m_number_of_physical_cores << "," <<
+        getNumberOfLogicalCPUs() << "," <<
+        m_number_of_allowed_cpus;
+
+    return fields.str();
+}
+
+
+//----------------------------------------
+std::string CpuTopology::getCSVHeader()
+//----------------------------------------
+{
+    return "sockets,physical_cores,logical_cpus,allowed_cpus";
+}
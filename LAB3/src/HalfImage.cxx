@@ -0,0 +1,369 @@
+/**
+********************************************************************************
+*
+*   @file       HalfImage.cxx
+*
+*   @brief      Greyscale image stored with 16-bit floating-point numbers
+*               (FP16 or BF16), e.g. for intermediate results that are only
+*               visualised. The filters compute in single precision.
+*
+*   @version    1.0
+*
+*   @date       19/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//  Include
+//******************************************************************************
+#include <cmath> // Header file for abs and isnan
+#include <cctype> // Header file for tolower
+#include <limits>
+#include <algorithm> // Header file for min, max and reverse_copy
+
+#include "HalfImage.h"
+#include "ImageKernels.h"
+
+
+//******************************************************************************
+//  Constant variables
+//******************************************************************************
+namespace
+{
+    // Number of pixels converted at once, the float blocks stay in the L1 cache
+    const unsigned int BLOCK_SIZE = 1024;
+}
+
+
+//--------------------------------------------------
+std::string HalfImage::getFormatName(Format aFormat)
+//--------------------------------------------------
+{
+    return (aFormat == FP16) ? "fp16" : "bf16";
+}
+
+
+//--------------------------------------------------------------
+HalfImage::Format HalfImage::getFormat(const std::string& aName)
+//--------------------------------------------------------------
+{
+    std::string name(aName);
+    std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+
+    if (name == "fp16") return FP16;
+    if (name == "bf16") return BF16;
+
+    throw std::string("Unknown 16-bit format: ") + aName + " (valid formats are fp16 and bf16)";
+}
+
+
+//-----------------------------------
+HalfImage::HalfImage(Format aFormat):
+//-----------------------------------
+        m_width(0),
+        m_height(0),
+        m_format(aFormat)
+//-----------------------------------
+{}
+
+
+//---------------------------------------------------------
+HalfImage::HalfImage(const Image& anImage, Format aFormat):
+//---------------------------------------------------------
+        m_width(anImage.getWidth()),
+        m_height(anImage.getHeight()),
+        m_format(aFormat),
+        m_p_image(anImage.getWidth() * anImage.getHeight())
+//---------------------------------------------------------
+{
+    if (!m_p_image.empty())
+    {
+        fromFloat(&anImage[0], m_p_image.data(), m_p_image.size());
+    }
+}
+
+
+//-------------------------------------------
+HalfImage::HalfImage(unsigned int aWidth,
+                     unsigned int aHeight,
+                     Format aFormat,
+                     Image::NoInit /*aTag*/):
+//-------------------------------------------
+        m_width(aWidth),
+        m_height(aHeight),
+        m_format(aFormat),
+        m_p_image(aWidth * aHeight)
+//-------------------------------------------
+{}
+
+
+//------------------------------
+Image HalfImage::toImage() const
+//------------------------------
+{
+    Image temp(m_width, m_height, Image::NO_INIT);
+
+    if (!m_p_image.empty())
+    {
+        toFloat(m_p_image.data(), &temp[0], m_p_image.size());
+    }
+
+    return temp;
+}
+
+
+//--------------------------------------
+unsigned int HalfImage::getWidth() const
+//--------------------------------------
+{
+    return m_width;
+}
+
+
+//---------------------------------------
+unsigned int HalfImage::getHeight() const
+//---------------------------------------
+{
+    return m_height;
+}
+
+
+//--------------------------------------------
+HalfImage::Format HalfImage::getFormat() const
+//--------------------------------------------
+{
+    return m_format;
+}
+
+
+//-----------------------------------------------------------------------
+void HalfImage::getMinMaxValues(float& aMinValue, float& aMaxValue) const
+//-----------------------------------------------------------------------
+{
+    // The image is empty
+    if (m_p_image.empty())
+    {
+        throw "Empty image";
+    }
+
+    aMinValue = std::numeric_limits<float>::infinity();
+    aMaxValue = -std::numeric_limits<float>::infinity();
+
+    float block[BLOCK_SIZE];
+    for (unsigned int start_id = 0; start_id < m_p_image.size(); start_id += BLOCK_SIZE)
+    {
+        unsigned int block_size = std::min<unsigned int>(BLOCK_SIZE, m_p_image.size() - start_id);
+        toFloat(&m_p_image[start_id], block, block_size);
+
+        float min_value, max_value;
+        getImageKernels().getMinMax(block, block_size, min_value, max_value);
+
+        aMinValue = std::min(aMinValue, min_value);
+        aMaxValue = std::max(aMaxValue, max_value);
+    }
+}
+
+
+//-------------------------------------------------------
+void HalfImage::getError(const Image& aReference,
+                         float& aMaxAbsoluteError,
+                         float& aMaxRelativeError) const
+//-------------------------------------------------------
+{
+    if (m_width != aReference.getWidth() || m_height != aReference.getHeight())
+    {
+        throw "The images have different sizes";
+    }
+
+    aMaxAbsoluteError = 0.0f;
+    aMaxRelativeError = 0.0f;
+
+    float block[BLOCK_SIZE];
+    for (unsigned int start_id = 0; start_id < m_p_image.size(); start_id += BLOCK_SIZE)
+    {
+        unsigned int block_size = std::min<unsigned int>(BLOCK_SIZE, m_p_image.size() - start_id);
+        toFloat(&m_p_image[start_id], block, block_size);
+
+        for (unsigned int i = 0; i < block_size; ++i)
+        {
+            float value = block[i];
+            float reference = aReference[start_id + i];
+
+            // No error
+            if (value == reference || (std::isnan(value) && std::isnan(reference)))
+            {
+                continue;
+            }
+
+            // A NaN, or an overflow, gives an infinite error
+            float absolute_error = std::abs(value - reference);
+            if (std::isnan(absolute_error))
+            {
+                absolute_error = std::numeric_limits<float>::infinity();
+            }
+
+            aMaxAbsoluteError = std::max(aMaxAbsoluteError, absolute_error);
+
+            if (reference != 0.0f && std::abs(reference) != std::numeric_limits<float>::infinity())
+            {
+                aMaxRelativeError = std::max(aMaxRelativeError, absolute_error / std::abs(reference));
+            }
+        }
+    }
+}
+
+
+//-----------------------------------------------------------
+void HalfImage::saveASCII(const std::string& aFileName) const
+//-----------------------------------------------------------
+{
+    toImage().saveASCII(aFileName);
+}
+
+
+//------------------------------------
+HalfImage HalfImage::operator!() const
+//------------------------------------
+{
+    float min_value, max_value;
+    getMinMaxValues(min_value, max_value);
+    float range(max_value - min_value);
+
+    // Take care to preserve the dynamic of the image
+    void (*negate_kernel)(const float*, float*, unsigned int, float, float) = getImageKernels().negate;
+
+    return applyPointOperator([negate_kernel, min_value, range](const float* apInput, float* apOutput, unsigned int aSize)
+    {
+        negate_kernel(apInput, apOutput, aSize, min_value, range);
+    });
+}
+
+
+//-------------------------------------------------------------------------------
+HalfImage HalfImage::shiftScaleFilter(float aShiftValue, float aScaleValue) const
+//-------------------------------------------------------------------------------
+{
+    void (*shift_scale_kernel)(const float*, float*, unsigned int, float, float) = getImageKernels().shiftScale;
+
+    return applyPointOperator([shift_scale_kernel, aShiftValue, aScaleValue](const float* apInput, float* apOutput, unsigned int aSize)
+    {
+        shift_scale_kernel(apInput, apOutput, aSize, aShiftValue, aScaleValue);
+    });
+}
+
+
+//----------------------------------------
+HalfImage HalfImage::getNormalised() const
+//----------------------------------------
+{
+    float min_value, max_value;
+    getMinMaxValues(min_value, max_value);
+    return shiftScaleFilter(-min_value, 1.0 / (max_value - min_value));
+}
+
+
+//------------------------------------
+HalfImage HalfImage::logFilter() const
+//------------------------------------
+{
+    const ImageKernels& kernels = getImageKernels();
+    void (*log_kernel)(const float*, float*, unsigned int) =
+            (Image::getLogMode() == Image::FAST_LOG) ? kernels.fastLog : kernels.log;
+
+    return applyPointOperator([log_kernel](const float* apInput, float* apOutput, unsigned int aSize)
+    {
+        log_kernel(apInput, apOutput, aSize);
+    });
+}
+
+
+//-------------------------------------------
+HalfImage HalfImage::flipHorizontally() const
+//-------------------------------------------
+{
+    HalfImage temp(m_width, m_height, m_format, Image::NO_INIT);
+
+    for (unsigned int j = 0; j < m_height; ++j)
+    {
+        std::reverse_copy(m_p_image.begin() + j * m_width,
+                          m_p_image.begin() + (j + 1) * m_width,
+                          temp.m_p_image.begin() + j * m_width);
+    }
+
+    return temp;
+}
+
+
+//-----------------------------------------
+HalfImage HalfImage::flipVertically() const
+//-----------------------------------------
+{
+    HalfImage temp(m_width, m_height, m_format, Image::NO_INIT);
+
+    for (unsigned int j = 0; j < m_height; ++j)
+    {
+        std::copy(m_p_image.begin() + j * m_width,
+                  m_p_image.begin() + (j + 1) * m_width,
+                  temp.m_p_image.begin() + (m_height - j - 1) * m_width);
+    }
+
+    return temp;
+}
+
+
+//-------------------------------------------------------------------------
+template<typename BlockOperation>
+HalfImage HalfImage::applyPointOperator(BlockOperation anOperation) const
+//-------------------------------------------------------------------------
+{
+    HalfImage temp(m_width, m_height, m_format, Image::NO_INIT);
+
+    float input_block[BLOCK_SIZE];
+    float output_block[BLOCK_SIZE];
+
+    for (unsigned int start_id = 0; start_id < m_p_image.size(); start_id += BLOCK_SIZE)
+    {
+        unsigned int block_size = std::min<unsigned int>(BLOCK_SIZE, m_p_image.size() - start_id);
+
+        toFloat(&m_p_image[start_id], input_block, block_size);
+        anOperation(input_block, output_block, block_size);
+        fromFloat(output_block, &temp.m_p_image[start_id], block_size);
+    }
+
+    return temp;
+}
+
+
+//--------------------------------------------------------------------------------------------------------
+void HalfImage::toFloat(const std::uint16_t* apInput, float* apOutput, unsigned int aNumberOfPixels) const
+//--------------------------------------------------------------------------------------------------------
+{
+    if (m_format == FP16)
+    {
+        getImageKernels().halfToFloat(apInput, apOutput, aNumberOfPixels);
+    }
+    else
+    {
+        getImageKernels().bfloat16ToFloat(apInput, apOutput, aNumberOfPixels);
+    }
+}
+
+
+//----------------------------------------------------------------------------------------------------------
+void HalfImage::fromFloat(const float* apInput, std::uint16_t* apOutput, unsigned int aNumberOfPixels) const
+//----------------------------------------------------------------------------------------------------------
+{
+    if (m_format == FP16)
+    {
+        getImageKernels().floatToHalf(apInput, apOutput, aNumberOfPixels);
+    }
+    else
+    {
+        getImageKernels().floatToBFloat16(apInput, apOutput, aNumberOfPixels);
+    }
+}
@@ -30,11 +30,23 @@
 #include <sstream> // Header file for stringstream
 #include <fstream> // Header file for filestream
 #include <algorithm> // Header file for min/max/fill
-#include <numeric> // Header file for accumulate
 #include <cmath> // Header file for abs and pow
+#include <cstring> // Header file for memcpy
 #include <vector>
 
 #include "Image.h"
+#include "ReproducibleAccumulator.h"
+#include "ImageKernels.h"
+#include "PointLUT.h"
+#include "BulkCopy.h"
+#include "AsciiParser.h"
+
+
+//******************************************************************************
+//  Static members
+//******************************************************************************
+Image::SummationMode Image::m_summation_mode = Image::FAST_SUMMATION;
+Image::LogMode Image::m_log_mode = Image::EXACT_LOG;
 
 
 //-----------------
@@ -51,7 +63,7 @@ Image::Image(const Image& anImage):
 //----------------------------------
         m_width(anImage.m_width),
         m_height(anImage.m_height),
-        m_p_image(anImage.m_p_image)
+        m_p_image(anImage.m_p_image.size())
 //----------------------------------
 {
     // Out of memory
@@ -59,6 +71,9 @@ Image::Image(const Image& anImage):
     {
         throw ("Out of memory");
     }
+
+    // Copy the data, in parallel if the image is large
+    bulkCopy(anImage.m_p_image.data(), m_p_image.data(), m_p_image.size());
 }
 
 
@@ -69,7 +84,7 @@ Image::Image(const float* apData,
 //-----------------------------------------------------
         m_width(aWidth),
         m_height(aHeight),
-        m_p_image(std::vector<float>(aWidth * aHeight))
+        m_p_image(aWidth * aHeight)
 //-----------------------------------------------------
 {
     // Out of memory
@@ -78,8 +93,8 @@ Image::Image(const float* apData,
         throw ("Out of memory");
     }
 
-    // Copy the data
-    std::copy(apData, apData + m_width * m_height, m_p_image.begin());
+    // Copy the data, in parallel if the image is large
+    bulkCopy(apData, m_p_image.data(), m_p_image.size());
 }
 
 
@@ -90,7 +105,7 @@ Image::Image(unsigned int aWidth,
 //----------------------------------------------
         m_width(aWidth),
         m_height(aHeight),
-        m_p_image(std::vector<float>(aWidth * aHeight, aDefaultValue))
+        m_p_image(aWidth * aHeight, aDefaultValue)
 //----------------------------------------------
 {
     // Out of memory
@@ -101,6 +116,24 @@ Image::Image(unsigned int aWidth,
 }
 
 
+//-----------------------------------
+Image::Image(unsigned int aWidth,
+             unsigned int aHeight,
+             NoInit /*aTag*/):
+//-----------------------------------
+        m_width(aWidth),
+        m_height(aHeight),
+        m_p_image(aWidth * aHeight)
+//-----------------------------------
+{
+    // Out of memory
+    if (m_width * m_height && m_p_image.empty())
+    {
+        throw ("Out of memory");
+    }
+}
+
+
 //-------------
 Image::~Image()
 //-------------
@@ -218,19 +251,27 @@ Image& Image::operator=(const Image& anImage)
     // The images different
     if (this != &anImage)
     {
-        // Release memory
-        destroy();
+        // Reuse the memory if the number of pixels does not change
+        if (m_p_image.size() != anImage.m_p_image.size())
+        {
+            // Release memory
+            destroy();
+
+            m_p_image = PixelVector(anImage.m_p_image.size());
+        }
 
         // Copy the image properites
         m_width   = anImage.m_width;
         m_height  = anImage.m_height;
-        m_p_image = anImage.m_p_image;
 
         // Out of memory
         if (m_width * m_height && m_p_image.empty())
         {
             throw ("Out of memory");
         }
+
+        // Copy the data, in parallel if the image is large
+        bulkCopy(anImage.m_p_image.data(), m_p_image.data(), m_p_image.size());
     }
 
     // Return the instance
@@ -254,23 +295,61 @@ unsigned int Image::getHeight() const
 }
 
 
+//---------------------------------------------------------
+void Image::setSummationMode(SummationMode aMode)
+//---------------------------------------------------------
+{
+    m_summation_mode = aMode;
+}
+
+
+//---------------------------------------------------------
+Image::SummationMode Image::getSummationMode()
+//---------------------------------------------------------
+{
+    return m_summation_mode;
+}
+
+
+//-------------------------------------
+void Image::setLogMode(LogMode aMode)
+//-------------------------------------
+{
+    m_log_mode = aMode;
+}
+
+
+//---------------------------------
+Image::LogMode Image::getLogMode()
+//---------------------------------
+{
+    return m_log_mode;
+}
+
+
 //------------------------------
 float Image::getMinValue() const
 //------------------------------
 {
-    // The image is empty
-    if (m_p_image.empty())
-    {
-        throw "Empty image";
-    }
-
-    return (*std::min_element(&m_p_image[0], &m_p_image[m_width * m_height]));
+    float min_value, max_value;
+    getMinMaxValues(min_value, max_value);
+    return (min_value);
 }
 
 
 //------------------------------
 float Image::getMaxValue() const
 //------------------------------
+{
+    float min_value, max_value;
+    getMinMaxValues(min_value, max_value);
+    return (max_value);
+}
+
+
+//--------------------------------------------------------------------
+void Image::getMinMaxValues(float& aMinValue, float& aMaxValue) const
+//--------------------------------------------------------------------
 {
     // The image is empty
     if (m_p_image.empty())
@@ -278,7 +357,7 @@ float Image::getMaxValue() const
         throw "Empty image";
     }
 
-    return (*std::max_element(&m_p_image[0], &m_p_image[m_width * m_height]));
+    getImageKernels().getMinMax(m_p_image.data(), m_width * m_height, aMinValue, aMaxValue);
 }
 
 
@@ -286,7 +365,14 @@ float Image::getMaxValue() const
 float Image::getSum() const
 //-------------------------
 {
-    return (std::accumulate(m_p_image.begin(), m_p_image.end(), 0.0f));
+    if (m_summation_mode == REPRODUCIBLE_SUMMATION)
+    {
+        ReproducibleAccumulator accumulator;
+        getImageKernels().accumulate(m_p_image.data(), m_width * m_height, accumulator);
+        return (accumulator.getSum());
+    }
+
+    return (getImageKernels().getSum(m_p_image.data(), m_width * m_height));
 }
 
 
@@ -312,14 +398,14 @@ float Image::getVariance() const
 {
     float mean = getAverage();
 
-    float sum = 0.0;
-    for (std::vector<float>::const_iterator ite = m_p_image.begin();
-            ite != m_p_image.end();
-            ++ite)
+    if (m_summation_mode == REPRODUCIBLE_SUMMATION)
     {
-        sum += (*ite - mean) * (*ite - mean);
+        ReproducibleAccumulator accumulator;
+        getImageKernels().accumulateSquaredDifferences(m_p_image.data(), m_width * m_height, mean, accumulator);
+        return (accumulator.getSum() / (m_width * m_height));
     }
 
+    float sum = getImageKernels().getSumOfSquaredDifferences(m_p_image.data(), m_width * m_height, mean);
     return (sum / (m_width * m_height));
 }
 
@@ -370,9 +456,8 @@ void Image::loadPGM(const char* aFileName)
             // Variable to save the max value
             int max_value(-1);
 
-            // There is data to read
-            unsigned int pixel_count(0);
-            while (input_file.good())
+            // Read the header
+            while (input_file.good() && max_value < 0)
             {
                 // Get the new line
                 input_file.getline(p_line_data, LINE_SIZE);
@@ -391,7 +476,7 @@ void Image::loadPGM(const char* aFileName)
                         stream_line >> m_width >> m_height;
 
                         // Alocate the memory
-                        m_p_image = std::vector<float>(m_width * m_height);
+                        m_p_image = PixelVector(m_width * m_height, 0.0f);
 
                         // Out of memory
                         if (m_width * m_height && m_p_image.empty())
@@ -400,29 +485,34 @@ void Image::loadPGM(const char* aFileName)
                         }
                     }
                     // The max value is not set
-                    else if (max_value < 0)
+                    else
                     {
                         // Get the max value;
                         stream_line >> max_value;
                     }
-                    // Read the pixel data
-                    else
-                    {
-                        // Process all the pixels of the line
-                        while (stream_line.good())
-                        {
-                            // Get the pixel value
-                            int pixel_value(-1);
-                            stream_line >> pixel_value;
-                            // The pixel exists
-                            if (pixel_count < m_width * m_height)
-                            {
-                                m_p_image[pixel_count++] = pixel_value;
-                            }
-                        }
-                    }
                 }
             }
+
+            // Read the pixel data, the lines can be of any length. The
+            // pixels are appended to the image, the memory is kept.
+            m_p_image.clear();
+            AsciiParser parser(input_file);
+            while (!parser.isEnd())
+            {
+                // It is a comment
+                if (parser.getNextCharacter() == '#')
+                {
+                    parser.skipLine();
+                }
+                // Process all the pixels of the line
+                else
+                {
+                    parser.parseLine(m_p_image);
+                }
+            }
+
+            // Ignore the extra pixels, the missing ones are black
+            m_p_image.resize(m_width * m_height, 0.0f);
         }
         // Valid binary format
         else if (image_type == "P5")
@@ -454,7 +544,7 @@ void Image::loadPGM(const char* aFileName)
                             stream_line >> m_width >> m_height;
 
                             // Alocate the memory
-                            m_p_image = std::vector<float>(m_width * m_height);
+                            m_p_image = PixelVector(m_width * m_height, 0.0f);
 
                             // Out of memory
                             if (m_width * m_height && m_p_image.empty())
@@ -606,22 +696,14 @@ void Image::loadASCII(const char* aFileName)
     }
 
     // Load the data into a vector
-    std::string line;
+    AsciiParser parser(input_file);
     int number_of_rows(0);
     int number_of_columns(0);
 
     // Read evely line
-    while (std::getline(input_file, line))
+    while (!parser.isEnd())
     {
-        number_of_columns = 0;
-        float intensity;
-        std::stringstream line_parser;
-        line_parser << line;
-        while (line_parser >> intensity)
-        {
-            m_p_image.push_back(intensity);
-            ++number_of_columns;
-        }
+        number_of_columns = parser.parseLine(m_p_image);
         ++number_of_rows;
     }
 
@@ -712,18 +794,8 @@ bool Image::operator==(const Image& anImage) const
         return (false);
     }
 
-    std::vector<float>::const_iterator ite1 = m_p_image.begin();
-    std::vector<float>::const_iterator ite2 = anImage.m_p_image.begin();
-
-    for (unsigned int i(0); i < m_width * m_height; ++i)
-    {
-        if (std::abs(*ite1++ - *ite2++) > 1.0e-6)
-        {
-            return (false);
-        }
-    }
-
-    return (true);
+    float max_difference;
+    return (findFirstMismatch(anImage, 1.0e-6, max_difference) == m_width * m_height);
 }
 
 
@@ -735,25 +807,36 @@ bool Image::operator!=(const Image& anImage) const
 }
 
 
+//-----------------------------------------------------------------
+unsigned int Image::findFirstMismatch(const Image& anImage,
+                                      float aTolerance,
+                                      float& aMaxDifference) const
+//-----------------------------------------------------------------
+{
+    if (m_width != anImage.m_width || m_height != anImage.m_height)
+    {
+        throw "The images have different sizes";
+    }
+
+    return (getImageKernels().compare(m_p_image.data(), anImage.m_p_image.data(), m_width * m_height,
+                                      aTolerance, aMaxDifference));
+}
+
+
 //----------------------------
 Image Image::operator!() const
 //----------------------------
 {
-    // Copy the instance into a temporary variable
-    Image temp(*this);
+    // Create an image of the right size, every pixel is written below
+    Image temp(getWidth(), getHeight(), NO_INIT);
 
-    float min_value(getMinValue());
-    float max_value(getMaxValue());
+    float min_value, max_value;
+    getMinMaxValues(min_value, max_value);
     float range(max_value - min_value);
 
-    // Process every pixel
-    for (std::vector<float>::iterator ite = temp.m_p_image.begin();
-        ite != temp.m_p_image.end();
-        ++ite)
-    {
-        // Take care to preserve the dynamic of the image
-        *ite = min_value + range * (1.0 - (*ite - min_value) / range);
-    }
+    // Process every pixel, taking care to preserve the dynamic of the image
+    getImageKernels().negate(m_p_image.data(), temp.m_p_image.data(), m_width * m_height,
+                             min_value, range);
 
     // Return the result
     return (temp);
@@ -764,15 +847,12 @@ Image Image::operator!() const
 Image Image::shiftScaleFilter(float aShiftValue, float aScaleValue) const
 //-----------------------------------------------------------------------
 {
-    // Create an image of the right size
-    Image temp(getWidth(), getHeight());
+    // Create an image of the right size, every pixel is written below
+    Image temp(getWidth(), getHeight(), NO_INIT);
 
-    // Process every pixel of the image
-    for (unsigned int i = 0; i < m_width * m_height; ++i)
-    {
-        // Apply the shilft/scale filter
-        temp[i] = (m_p_image[i] + aShiftValue) * aScaleValue;
-    }
+    // Apply the shift/scale filter to every pixel of the image
+    getImageKernels().shiftScale(m_p_image.data(), temp.m_p_image.data(), m_width * m_height,
+                                 aShiftValue, aScaleValue);
 
     return temp;
 }
@@ -782,7 +862,9 @@ Image Image::shiftScaleFilter(float aShiftValue, float aScaleValue) const
 Image Image::getNormalised() const
 //--------------------------------
 {
-    return shiftScaleFilter(-getMinValue(), 1.0 / (getMaxValue() - getMinValue()));
+    float min_value, max_value;
+    getMinMaxValues(min_value, max_value);
+    return shiftScaleFilter(-min_value, 1.0 / (max_value - min_value));
 }
 
 
@@ -798,40 +880,98 @@ Image Image::getNormalized() const
 Image Image::logFilter() const
 //----------------------------
 {
-    // Create an image of the right size
-    Image temp(getWidth(), getHeight());
+    // Create an image of the right size, every pixel is written below
+    Image temp(getWidth(), getHeight(), NO_INIT);
 
-    // Process every pixel of the image
-    for (unsigned int i = 0; i < m_width * m_height; ++i)
+    // Apply the log filter to every pixel of the image
+    if (m_log_mode == FAST_LOG)
     {
-        // Apply the log filter
-        temp[i] = log(m_p_image[i]);
+        getImageKernels().fastLog(m_p_image.data(), temp.m_p_image.data(), m_width * m_height);
+    }
+    else
+    {
+        getImageKernels().log(m_p_image.data(), temp.m_p_image.data(), m_width * m_height);
     }
 
     return temp;
 }
 
 
-//-----------------------------------
-Image Image::flipHorizontally() const
-//-----------------------------------
+//------------------------------------------------------------------------------
+Image Image::applyPointFunction(PointFunction aFunction, float aParameter) const
+//------------------------------------------------------------------------------
+{
+    // Create an image of the right size, every pixel is written below
+    Image temp(getWidth(), getHeight(), NO_INIT);
+
+    // Apply the function to every pixel of the image
+    applyPointFunction(aFunction, aParameter, m_p_image.data(), temp.m_p_image.data(), m_width * m_height);
+
+    return temp;
+}
+
+
+//-------------------------------------------------------------
+void Image::applyPointFunction(PointFunction aFunction,
+                               float aParameter,
+                               const float* apInput,
+                               float* apOutput,
+                               unsigned int aNumberOfPixels)
+//-------------------------------------------------------------
 {
-    // Create an image of the right size
-    Image temp(getWidth(), getHeight());
+    const ImageKernels& kernels = getImageKernels();
+    bool is_fast = (m_log_mode == FAST_LOG);
 
-    // Process every pixel of the image
-    for (unsigned int i = 0; i < m_width * m_height; ++i)
+    switch (aFunction)
     {
-        // Retrieve the 2D index (x, y) from i
+    case LOG_FUNCTION:
+        (is_fast ? kernels.fastLog : kernels.log)(apInput, apOutput, aNumberOfPixels);
+        break;
 
-        // % is the "modulo operator", the remainder of i / m_width
-        int x = i % m_width;
+    case EXP_FUNCTION:
+        (is_fast ? kernels.fastExp : kernels.exp)(apInput, apOutput, aNumberOfPixels);
+        break;
 
-        // where "/" is an integer division
-        int y = i / m_width;
+    case POW_FUNCTION:
+        (is_fast ? kernels.fastPow : kernels.pow)(apInput, apOutput, aNumberOfPixels, aParameter);
+        break;
 
-        // Get the pixel
-        temp(x, y) = getPixel(m_width - x - 1, y);
+    case SQRT_FUNCTION:
+        kernels.sqrt(apInput, apOutput, aNumberOfPixels);
+        break;
+
+    default:
+        throw "Unknown point function";
+    }
+}
+
+
+//-----------------------------------------------
+Image Image::applyLUT(const PointLUT& aLUT) const
+//-----------------------------------------------
+{
+    // Create an image of the right size, every pixel is written below
+    Image temp(getWidth(), getHeight(), NO_INIT);
+
+    // Look up the new value of every pixel of the image
+    getImageKernels().applyLUT(m_p_image.data(), temp.m_p_image.data(), m_width * m_height,
+                               aLUT.getTable().data(), aLUT.getNumberOfEntries());
+
+    return temp;
+}
+
+
+//-----------------------------------
+Image Image::flipHorizontally() const
+//-----------------------------------
+{
+    // Create an image of the right size, every pixel is written below
+    Image temp(getWidth(), getHeight(), NO_INIT);
+
+    // Reverse every row of the image
+    for (unsigned int y = 0; y < m_height; ++y)
+    {
+        getImageKernels().reverseRow(&m_p_image[y * m_width], &temp.m_p_image[y * m_width], m_width);
     }
 
     return temp;
@@ -840,25 +980,48 @@ Image Image::flipHorizontally() const
 
 //---------------------------------
 Image Image::flipVertically() const
-//---------------------------------
-{
-    // Create an image of the right size
-    Image temp(getWidth(), getHeight());
+//---------------------------------
+{
+    // Create an image of the right size, every pixel is written below
+    Image temp(getWidth(), getHeight(), NO_INIT);
+
+    // Copy every row to its mirrored position
+    for (unsigned int y = 0; y < m_height; ++y)
+    {
+        std::memcpy(&temp.m_p_image[(m_height - y - 1) * m_width],
+                    &m_p_image[y * m_width],
+                    m_width * sizeof(float));
+    }
+
+    return temp;
+}
 
-    // Process every pixel of the image
-    for (unsigned int i = 0; i < m_width * m_height; ++i)
+
+//--------------------------------------
+Image& Image::flipHorizontallyInPlace()
+//--------------------------------------
+{
+    // Reverse every row of the image
+    for (unsigned int y = 0; y < m_height; ++y)
     {
-        // Retrieve the 2D index (x, y) from i
+        getImageKernels().reverseRowInPlace(&m_p_image[y * m_width], m_width);
+    }
 
-        // % is the "modulo operator", the remainder of i / m_width
-        int x = i % m_width;
+    return *this;
+}
 
-        // where "/" is an integer division
-        int y = i / m_width;
 
-        // Get the pixel
-        temp(x, y) = getPixel(x, m_height - y - 1);
+//------------------------------------
+Image& Image::flipVerticallyInPlace()
+//------------------------------------
+{
+    // Swap the rows of the top half with the ones of the bottom half
+    for (unsigned int y = 0; y < m_height / 2; ++y)
+    {
+        std::swap_ranges(m_p_image.begin() + y * m_width,
+                         m_p_image.begin() + (y + 1) * m_width,
+                         m_p_image.begin() + (m_height - y - 1) * m_width);
     }
 
-    return temp;
+    return *this;
 }
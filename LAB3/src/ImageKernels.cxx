@@ -0,0 +1,152 @@
+/**
+********************************************************************************
+*
+*   @file       ImageKernels.cxx
+*
+*   @brief      Selection of the variant of the image kernels: the widest
+*               instruction set supported by both the binary and the CPU is
+*               chosen once, the first time the kernels are used.
+*
+*   @version    1.0
+*
+*   @date       19/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//  Include
+//******************************************************************************
+#include "ImageKernels.h"
+
+
+//******************************************************************************
+//  Function declarations
+//******************************************************************************
+
+// The variants, in ImageKernelsScalar.cxx, ImageKernelsAVX2.cxx and
+// ImageKernelsAVX512.cxx. They return 0 if the variant is not compiled in.
+const ImageKernels* getScalarImageKernels();
+const ImageKernels* getAVX2ImageKernels();
+const ImageKernels* getAVX512ImageKernels();
+
+
+namespace
+{
+    //--------------------------------------------------------------------------
+    /// Check if the CPU supports an instruction set
+    //--------------------------------------------------------------------------
+    bool isSupportedByCPU(const std::string& anISA)
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_cpu_init();
+
+        if (anISA == "avx512") return __builtin_cpu_supports("avx512f");
+        if (anISA == "avx2")   return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("f16c");
+#endif
+
+        return anISA == "scalar";
+    }
+
+
+    //--------------------------------------------------------------------------
+    /// Variants supported by both the binary and the CPU, from the narrowest
+    /// to the widest
+    //--------------------------------------------------------------------------
+    std::vector<const ImageKernels*> getAvailableKernels()
+    {
+        std::vector<const ImageKernels*> kernel_set;
+
+        const ImageKernels* p_variant_set[] =
+        {
+            getScalarImageKernels(),
+            getAVX2ImageKernels(),
+            getAVX512ImageKernels()
+        };
+
+        for (unsigned int i = 0; i < sizeof(p_variant_set) / sizeof(p_variant_set[0]); ++i)
+        {
+            if (p_variant_set[i] && isSupportedByCPU(p_variant_set[i]->isa))
+            {
+                kernel_set.push_back(p_variant_set[i]);
+            }
+        }
+
+        return kernel_set;
+    }
+
+
+    //--------------------------------------------------------------------------
+    /// The selected variant, the widest one by default
+    //--------------------------------------------------------------------------
+    const ImageKernels*& getSelectedKernels()
+    {
+        static const ImageKernels* p_kernels = getAvailableKernels().back();
+        return p_kernels;
+    }
+}
+
+
+//-----------------------------------
+const ImageKernels& getImageKernels()
+//-----------------------------------
+{
+    return *getSelectedKernels();
+}
+
+
+//----------------------------------------------
+void setImageKernelISA(const std::string& anISA)
+//----------------------------------------------
+{
+    std::vector<const ImageKernels*> kernel_set = getAvailableKernels();
+
+    if (anISA == "auto")
+    {
+        getSelectedKernels() = kernel_set.back();
+        return;
+    }
+
+    for (std::vector<const ImageKernels*>::const_iterator ite = kernel_set.begin();
+            ite != kernel_set.end();
+            ++ite)
+    {
+        if (anISA == (*ite)->isa)
+        {
+            getSelectedKernels() = *ite;
+            return;
+        }
+    }
+
+    throw std::string("Instruction set not available: ") + anISA;
+}
+
+
+//-----------------------------
+std::string getImageKernelISA()
+//-----------------------------
+{
+    return getImageKernels().isa;
+}
+
+
+//----------------------------------------------------
+std::vector<std::string> getAvailableImageKernelISAs()
+//----------------------------------------------------
+{
+    std::vector<std::string> isa_set;
+
+    std::vector<const ImageKernels*> kernel_set = getAvailableKernels();
+    for (std::vector<const ImageKernels*>::const_iterator ite = kernel_set.begin();
+            ite != kernel_set.end();
+            ++ite)
+    {
+        isa_set.push_back((*ite)->isa);
+    }
+
+    return isa_set;
+}
@@ -0,0 +1,42 @@
+/**
+********************************************************************************
+*
+*   @file       ImageKernelsAVX2.cxx
+*
+*   @brief      AVX2 variant of the image kernels, compiled for AVX2 and F16C
+*               by ImageKernelsImpl.h. It is only available on x86.
+*
+*   @version    1.0
+*
+*   @date       19/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//  Include
+//******************************************************************************
+#include "ImageKernels.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define IMAGE_KERNELS_NAMESPACE avx2
+#define IMAGE_KERNELS_ISA "avx2"
+#define IMAGE_KERNELS_USE_AVX2
+#include "ImageKernelsImpl.h"
+#endif
+
+
+//---------------------------------------
+const ImageKernels* getAVX2ImageKernels()
+//---------------------------------------
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return &avx2::KERNELS;
+#else
+    return 0;
+#endif
+}
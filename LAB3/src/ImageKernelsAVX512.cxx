@@ -0,0 +1,42 @@
+/**
+********************************************************************************
+*
+*   @file       ImageKernelsAVX512.cxx
+*
+*   @brief      AVX-512 variant of the image kernels, compiled for AVX-512F
+*               by ImageKernelsImpl.h. It is only available on x86.
+*
+*   @version    1.0
+*
+*   @date       19/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//  Include
+//******************************************************************************
+#include "ImageKernels.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define IMAGE_KERNELS_NAMESPACE avx512
+#define IMAGE_KERNELS_ISA "avx512"
+#define IMAGE_KERNELS_USE_AVX512
+#include "ImageKernelsImpl.h"
+#endif
+
+
+//-----------------------------------------
+const ImageKernels* getAVX512ImageKernels()
+//-----------------------------------------
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return &avx512::KERNELS;
+#else
+    return 0;
+#endif
+}
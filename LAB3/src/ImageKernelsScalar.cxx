@@ -0,0 +1,33 @@
+/**
+********************************************************************************
+*
+*   @file       ImageKernelsScalar.cxx
+*
+*   @brief      Scalar variant of the image kernels, compiled for the baseline
+*               instruction set of the target.
+*
+*   @version    1.0
+*
+*   @date       19/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//  Include
+//******************************************************************************
+#define IMAGE_KERNELS_NAMESPACE scalar
+#define IMAGE_KERNELS_ISA "scalar"
+#include "ImageKernelsImpl.h"
+
+
+//-----------------------------------------
+const ImageKernels* getScalarImageKernels()
+//-----------------------------------------
+{
+    return &scalar::KERNELS;
+}
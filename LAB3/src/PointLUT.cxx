@@ -0,0 +1,225 @@
+/**
+********************************************************************************
+*
+*   @file       PointLUT.cxx
+*
+*   @brief      Lookup table (LUT) to apply a chain of point operators to an
+*               image whose pixel values are integers in [0, 255] or
+*               [0, 65535], e.g. an 8-bit or a 16-bit scene.
+*
+*   @version    1.0
+*
+*   @date       19/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//  Include
+//******************************************************************************
+#include <limits>
+
+#include "PointLUT.h"
+#include "ImageKernels.h"
+
+
+//--------------------------------------
+PointLUT::PointLUT(const Image& anImage):
+//--------------------------------------
+        PointLUT(getOccurrenceSet(anImage.getWidth() * anImage.getHeight() ? &anImage[0] : nullptr,
+                                  anImage.getWidth() * anImage.getHeight()))
+//--------------------------------------
+{}
+
+
+//-----------------------------------------------------------
+PointLUT::PointLUT(const std::vector<char>& anOccurrenceSet):
+//-----------------------------------------------------------
+        m_occurrence_set(anOccurrenceSet)
+//-----------------------------------------------------------
+{
+    // The largest value that occurs
+    unsigned int number_of_values = m_occurrence_set.size();
+    while (number_of_values && !m_occurrence_set[number_of_values - 1])
+    {
+        --number_of_values;
+    }
+
+    // No value occurs: the image is empty
+    if (!number_of_values)
+    {
+        throw "Empty image";
+    }
+
+    if (number_of_values > UINT16_SIZE)
+    {
+        throw "A lookup table has 256 or 65536 entries";
+    }
+
+    // 8-bit or 16-bit input
+    m_occurrence_set.resize(number_of_values <= UINT8_SIZE ? UINT8_SIZE : UINT16_SIZE, 0);
+
+    // Identity
+    m_table.resize(m_occurrence_set.size());
+    for (unsigned int i = 0; i < m_table.size(); ++i)
+    {
+        m_table[i] = i;
+    }
+}
+
+
+//-------------------------------------------------------------------------------------------------
+std::vector<char> PointLUT::getOccurrenceSet(const float* apPixelSet, unsigned int aNumberOfPixels)
+//-------------------------------------------------------------------------------------------------
+{
+    // Record the values that occur, and check they are valid indices
+    std::vector<char> occurrence_set(UINT16_SIZE, 0);
+
+    for (unsigned int i = 0; i < aNumberOfPixels; ++i)
+    {
+        float value = apPixelSet[i];
+
+        if (!(value >= 0.0f && value <= UINT16_SIZE - 1) ||
+                value != float((unsigned int)value))
+        {
+            throw "The pixel values are not integers in [0, 65535], a lookup table cannot be used";
+        }
+
+        occurrence_set[(unsigned int)value] = 1;
+    }
+
+    return occurrence_set;
+}
+
+
+//------------------------------------------------
+PointLUT::PointLUT(unsigned int aNumberOfEntries):
+//------------------------------------------------
+        m_table(aNumberOfEntries),
+        m_occurrence_set(aNumberOfEntries, 1)
+//------------------------------------------------
+{
+    if (aNumberOfEntries != UINT8_SIZE && aNumberOfEntries != UINT16_SIZE)
+    {
+        throw "A lookup table has 256 or 65536 entries";
+    }
+
+    // Identity
+    for (unsigned int i = 0; i < m_table.size(); ++i)
+    {
+        m_table[i] = i;
+    }
+}
+
+
+//-----------------------------------------------
+unsigned int PointLUT::getNumberOfEntries() const
+//-----------------------------------------------
+{
+    return m_table.size();
+}
+
+
+//--------------------------------------------------
+const std::vector<float>& PointLUT::getTable() const
+//--------------------------------------------------
+{
+    return m_table;
+}
+
+
+//---------------------------------
+float PointLUT::getMinValue() const
+//---------------------------------
+{
+    float min_value = std::numeric_limits<float>::infinity();
+
+    for (unsigned int i = 0; i < m_table.size(); ++i)
+    {
+        if (m_occurrence_set[i] && min_value > m_table[i]) min_value = m_table[i];
+    }
+
+    return min_value;
+}
+
+
+//---------------------------------
+float PointLUT::getMaxValue() const
+//---------------------------------
+{
+    float max_value = -std::numeric_limits<float>::infinity();
+
+    for (unsigned int i = 0; i < m_table.size(); ++i)
+    {
+        if (m_occurrence_set[i] && max_value < m_table[i]) max_value = m_table[i];
+    }
+
+    return max_value;
+}
+
+
+//----------------------------------
+PointLUT PointLUT::operator!() const
+//----------------------------------
+{
+    // Copy the instance into a temporary variable
+    PointLUT temp(*this);
+
+    float min_value(getMinValue());
+    float max_value(getMaxValue());
+    float range(max_value - min_value);
+
+    // Process every entry, taking care to preserve the dynamic of the image
+    getImageKernels().negate(m_table.data(), temp.m_table.data(), m_table.size(),
+                             min_value, range);
+
+    return temp;
+}
+
+
+//-----------------------------------------------------------------------------
+PointLUT PointLUT::shiftScaleFilter(float aShiftValue, float aScaleValue) const
+//-----------------------------------------------------------------------------
+{
+    // Copy the instance into a temporary variable
+    PointLUT temp(*this);
+
+    // Apply the shift/scale filter to every entry
+    getImageKernels().shiftScale(m_table.data(), temp.m_table.data(), m_table.size(),
+                                 aShiftValue, aScaleValue);
+
+    return temp;
+}
+
+
+//--------------------------------------
+PointLUT PointLUT::getNormalised() const
+//--------------------------------------
+{
+    return shiftScaleFilter(-getMinValue(), 1.0 / (getMaxValue() - getMinValue()));
+}
+
+
+//----------------------------------
+PointLUT PointLUT::logFilter() const
+//----------------------------------
+{
+    // Copy the instance into a temporary variable
+    PointLUT temp(*this);
+
+    // Apply the log filter to every entry
+    if (Image::getLogMode() == Image::FAST_LOG)
+    {
+        getImageKernels().fastLog(m_table.data(), temp.m_table.data(), m_table.size());
+    }
+    else
+    {
+        getImageKernels().log(m_table.data(), temp.m_table.data(), m_table.size());
+    }
+
+    return temp;
+}
@@ -23,8 +23,84 @@
 //  Include
 //******************************************************************************
 #include <pthread.h> // Header file for Pthreads
+#include <cmath> // Header file for abs
+#include <cstring> // Header file for memcpy
+#include <limits>
+#include <algorithm> // Header file for min and max
+#include <functional> // Header file for function and plus
+#include <utility> // Header file for pair
+#include <vector>
 
 #include "PthreadImage.h"
+#include "ParallelReduction.h"
+#include "ReproducibleAccumulator.h"
+#include "ImageKernels.h"
+#include "PointLUT.h"
+
+
+//******************************************************************************
+//  Function declarations
+//******************************************************************************
+namespace
+{
+    //--------------------------------------------------------------------------
+    /// Data given to every thread
+    //--------------------------------------------------------------------------
+    struct ThreadData
+    {
+        pthread_t thread_id;
+        unsigned int task_id;
+        const std::function<void(unsigned int)>* p_task;
+    };
+
+
+    //--------------------------------------------------------------------------
+    /// Callback of the threads, run the task of the thread
+    //--------------------------------------------------------------------------
+    void* runTask(void* apThreadData)
+    {
+        ThreadData* p_thread_data = static_cast<ThreadData*>(apThreadData);
+        (*p_thread_data->p_task)(p_thread_data->task_id);
+        return 0;
+    }
+
+
+    //--------------------------------------------------------------------------
+    /// Run aTask(0), aTask(1), ..., aTask(aNumberOfTasks - 1), one per thread,
+    /// and wait for all of them
+    //--------------------------------------------------------------------------
+    void runInParallel(unsigned int aNumberOfTasks,
+                       const std::function<void(unsigned int)>& aTask)
+    {
+        std::vector<ThreadData> thread_data_set(aNumberOfTasks);
+        unsigned int number_of_created_threads = 0;
+
+        // Create the threads
+        for (unsigned int i = 0; i < aNumberOfTasks; ++i)
+        {
+            thread_data_set[i].task_id = i;
+            thread_data_set[i].p_task = &aTask;
+
+            if (pthread_create(&thread_data_set[i].thread_id, NULL, runTask, &thread_data_set[i]))
+            {
+                break;
+            }
+
+            ++number_of_created_threads;
+        }
+
+        // Wait for the threads that have been created
+        for (unsigned int i = 0; i < number_of_created_threads; ++i)
+        {
+            pthread_join(thread_data_set[i].thread_id, NULL);
+        }
+
+        if (number_of_created_threads != aNumberOfTasks)
+        {
+            throw "Cannot create the threads";
+        }
+    }
+}
 
 
 //--------------------------------------------------------
@@ -79,6 +155,18 @@ PthreadImage::PthreadImage(unsigned int aWidth,
 {}
 
 
+//--------------------------------------------------------
+PthreadImage::PthreadImage(unsigned int aWidth,
+                           unsigned int aHeight,
+                           NoInit aTag,
+                           unsigned int aNumberOfThreads):
+//--------------------------------------------------------
+        Image(aWidth, aHeight, aTag),
+        m_thread_number(aNumberOfThreads)
+//--------------------------------------------------------
+{}
+
+
 //---------------------------
 PthreadImage::~PthreadImage()
 //---------------------------
@@ -120,33 +208,232 @@ PthreadImage& PthreadImage::operator=(const PthreadImage& anImage)
 }
 
 
-//-------------------------------------------------------
-bool PthreadImage::operator==(const Image& anImage) const
-//-------------------------------------------------------
+//-------------------------------------
+float PthreadImage::getMinValue() const
+//-------------------------------------
 {
-    //if (m_thread_number == 0 || m_thread_number == 1)
+    float min_value, max_value;
+    getMinMaxValues(min_value, max_value);
+    return (min_value);
+}
+
+
+//-------------------------------------
+float PthreadImage::getMaxValue() const
+//-------------------------------------
+{
+    float min_value, max_value;
+    getMinMaxValues(min_value, max_value);
+    return (max_value);
+}
+
+
+//---------------------------------------------------------------------------
+void PthreadImage::getMinMaxValues(float& aMinValue, float& aMaxValue) const
+//---------------------------------------------------------------------------
+{
+    if (m_thread_number == 0 || m_thread_number == 1)
+    {
+        Image::getMinMaxValues(aMinValue, aMaxValue);
+        return;
+    }
+
+    // The image is empty
+    if (m_p_image.empty())
+    {
+        throw "Empty image";
+    }
+
+    // One padded (min, max) pair per thread
+    ParallelReduction<std::pair<float, float> > reduction(m_thread_number,
+            std::make_pair(std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity()));
+
+    runInParallel(reduction.size(), [this, &reduction](unsigned int aTaskID)
     {
-        return Image::operator==(anImage);
+        unsigned int start_id, end_id;
+        reduction.getRange(m_width * m_height, aTaskID, start_id, end_id);
+
+        getImageKernels().getMinMax(&m_p_image[start_id], end_id - start_id,
+                                    reduction[aTaskID].first, reduction[aTaskID].second);
+    });
+
+    std::pair<float, float> min_max = reduction.combine([](const std::pair<float, float>& a,
+                                                           const std::pair<float, float>& b)
+    {
+        return std::make_pair(std::min(a.first, b.first), std::max(a.second, b.second));
+    });
+
+    aMinValue = min_max.first;
+    aMaxValue = min_max.second;
+}
+
+
+//--------------------------------
+float PthreadImage::getSum() const
+//--------------------------------
+{
+    if (m_thread_number == 0 || m_thread_number == 1)
+    {
+        return Image::getSum();
     }
-    /*else
+
+    // Exact partial sums, the result does not depend on the number of threads
+    if (m_summation_mode == REPRODUCIBLE_SUMMATION)
     {
-        if (m_width != anImage.getWidth())
+        ParallelReduction<ReproducibleAccumulator> reduction(m_thread_number, ReproducibleAccumulator());
+
+        runInParallel(reduction.size(), [this, &reduction](unsigned int aTaskID)
         {
-            return (false);
-        }
+            unsigned int start_id, end_id;
+            reduction.getRange(m_width * m_height, aTaskID, start_id, end_id);
+
+            getImageKernels().accumulate(&m_p_image[start_id], end_id - start_id, reduction[aTaskID]);
+        });
+
+        return (reduction.combine(std::plus<ReproducibleAccumulator>()).getSum());
+    }
+
+    // One padded partial result per thread
+    ParallelReduction<float> reduction(m_thread_number, 0.0f);
+
+    runInParallel(reduction.size(), [this, &reduction](unsigned int aTaskID)
+    {
+        unsigned int start_id, end_id;
+        reduction.getRange(m_width * m_height, aTaskID, start_id, end_id);
+
+        reduction[aTaskID] = getImageKernels().getSum(&m_p_image[start_id], end_id - start_id);
+    });
+
+    return (reduction.combine(std::plus<float>()));
+}
+
+
+//------------------------------------
+float PthreadImage::getAverage() const
+//------------------------------------
+{
+    return (getSum() / (m_width * m_height));
+}
+
+
+//-------------------------------------
+float PthreadImage::getVariance() const
+//-------------------------------------
+{
+    if (m_thread_number == 0 || m_thread_number == 1)
+    {
+        return Image::getVariance();
+    }
 
-        if (m_height != anImage.getHeight())
+    // Use the parallel sum, not Image::getSum()
+    float mean = getAverage();
+
+    // Exact partial sums, the result does not depend on the number of threads
+    if (m_summation_mode == REPRODUCIBLE_SUMMATION)
+    {
+        ParallelReduction<ReproducibleAccumulator> reduction(m_thread_number, ReproducibleAccumulator());
+
+        runInParallel(reduction.size(), [this, &reduction, mean](unsigned int aTaskID)
+        {
+            unsigned int start_id, end_id;
+            reduction.getRange(m_width * m_height, aTaskID, start_id, end_id);
+
+            getImageKernels().accumulateSquaredDifferences(&m_p_image[start_id], end_id - start_id,
+                                                           mean, reduction[aTaskID]);
+        });
+
+        return (reduction.combine(std::plus<ReproducibleAccumulator>()).getSum() / (m_width * m_height));
+    }
+
+    // One padded partial result per thread
+    ParallelReduction<float> reduction(m_thread_number, 0.0f);
+
+    runInParallel(reduction.size(), [this, &reduction, mean](unsigned int aTaskID)
+    {
+        unsigned int start_id, end_id;
+        reduction.getRange(m_width * m_height, aTaskID, start_id, end_id);
+
+        reduction[aTaskID] = getImageKernels().getSumOfSquaredDifferences(&m_p_image[start_id],
+                                                                          end_id - start_id,
+                                                                          mean);
+    });
+
+    return (reduction.combine(std::plus<float>()) / (m_width * m_height));
+}
+
+
+//-----------------------------------------------------------------------
+unsigned int PthreadImage::findFirstMismatch(const Image& anImage,
+                                             float aTolerance,
+                                             float& aMaxDifference) const
+//-----------------------------------------------------------------------
+{
+    if (m_thread_number == 0 || m_thread_number == 1)
+    {
+        return Image::findFirstMismatch(anImage, aTolerance, aMaxDifference);
+    }
+
+    if (m_width != anImage.getWidth() || m_height != anImage.getHeight())
+    {
+        throw "The images have different sizes";
+    }
+
+    unsigned int number_of_pixels = m_width * m_height;
+
+    // One padded (first mismatch, max difference) pair per thread, every
+    // thread stops at the first mismatch of its range
+    ParallelReduction<std::pair<unsigned int, float> > reduction(m_thread_number,
+            std::make_pair(number_of_pixels, 0.0f));
+
+    runInParallel(reduction.size(), [this, &reduction, &anImage, aTolerance](unsigned int aTaskID)
+    {
+        unsigned int start_id, end_id;
+        reduction.getRange(m_width * m_height, aTaskID, start_id, end_id);
+
+        // More threads than pixels: nothing to compare
+        if (end_id > start_id)
         {
-            return (false);
+            unsigned int mismatch_id = getImageKernels().compare(m_p_image.data() + start_id, &anImage[0] + start_id,
+                                                                 end_id - start_id,
+                                                                 aTolerance, reduction[aTaskID].second);
+
+            if (mismatch_id < end_id - start_id)
+            {
+                reduction[aTaskID].first = start_id + mismatch_id;
+            }
         }
+    });
 
-        // Add your code here
+    // The ranges after the first mismatch are ignored
+    std::pair<unsigned int, float> mismatch = reduction.combine([number_of_pixels](const std::pair<unsigned int, float>& a,
+                                                                                   const std::pair<unsigned int, float>& b)
+    {
+        if (a.first < number_of_pixels) return a;
 
+        return std::make_pair(b.first, (b.second <= a.second) ? a.second : b.second);
+    });
 
+    aMaxDifference = mismatch.second;
+    return (mismatch.first);
+}
+
+
+//-------------------------------------------------------
+bool PthreadImage::operator==(const Image& anImage) const
+//-------------------------------------------------------
+{
+    if (m_width != anImage.getWidth())
+    {
+        return (false);
+    }
 
+    if (m_height != anImage.getHeight())
+    {
+        return (false);
+    }
 
-        return true;
-    }*/
+    float max_difference;
+    return (findFirstMismatch(anImage, 1.0e-6, max_difference) == m_width * m_height);
 }
 
 
@@ -160,13 +447,23 @@ PthreadImage PthreadImage::operator!() const
     }
     else
     {
-        // Create an image of the right size
-        PthreadImage temp(getWidth(), getHeight(), 0.0, m_thread_number);
-
-        // Add your code here
+        // Create an image of the right size, every pixel is written below
+        PthreadImage temp(getWidth(), getHeight(), NO_INIT, m_thread_number);
 
+        float min_value, max_value;
+        getMinMaxValues(min_value, max_value);
+        float range(max_value - min_value);
 
+        // Every thread processes a contiguous range of pixels
+        runInParallel(m_thread_number, [this, &temp, min_value, range](unsigned int aTaskID)
+        {
+            unsigned int start_id, end_id;
+            getTaskRange(m_width * m_height, m_thread_number, aTaskID, start_id, end_id);
 
+            // Take care to preserve the dynamic of the image
+            getImageKernels().negate(&m_p_image[start_id], &temp.m_p_image[start_id], end_id - start_id,
+                                     min_value, range);
+        });
 
         return temp;
     }
@@ -184,13 +481,19 @@ PthreadImage PthreadImage::shiftScaleFilter(float aShiftValue,
     }
     else
     {
-        // Create an image of the right size
-        PthreadImage temp(getWidth(), getHeight(), 0.0, m_thread_number);
-
-        // Add your code here
-
+        // Create an image of the right size, every pixel is written below
+        PthreadImage temp(getWidth(), getHeight(), NO_INIT, m_thread_number);
 
+        // Every thread processes a contiguous range of pixels
+        runInParallel(m_thread_number, [this, &temp, aShiftValue, aScaleValue](unsigned int aTaskID)
+        {
+            unsigned int start_id, end_id;
+            getTaskRange(m_width * m_height, m_thread_number, aTaskID, start_id, end_id);
 
+            // Apply the shift/scale filter
+            getImageKernels().shiftScale(&m_p_image[start_id], &temp.m_p_image[start_id], end_id - start_id,
+                                         aShiftValue, aScaleValue);
+        });
 
         return temp;
     }
@@ -207,13 +510,84 @@ PthreadImage PthreadImage::logFilter() const
     }
     else
     {
-        // Create an image of the right size
-        PthreadImage temp(getWidth(), getHeight(), 0.0, m_thread_number);
+        // Create an image of the right size, every pixel is written below
+        PthreadImage temp(getWidth(), getHeight(), NO_INIT, m_thread_number);
+
+        // Every thread processes a contiguous range of pixels
+        runInParallel(m_thread_number, [this, &temp](unsigned int aTaskID)
+        {
+            unsigned int start_id, end_id;
+            getTaskRange(m_width * m_height, m_thread_number, aTaskID, start_id, end_id);
+
+            // Apply the log filter
+            if (m_log_mode == FAST_LOG)
+            {
+                getImageKernels().fastLog(&m_p_image[start_id], &temp.m_p_image[start_id], end_id - start_id);
+            }
+            else
+            {
+                getImageKernels().log(&m_p_image[start_id], &temp.m_p_image[start_id], end_id - start_id);
+            }
+        });
+
+        return temp;
+    }
+}
 
-        // Add your code here
 
+//--------------------------------------------------------------------
+PthreadImage PthreadImage::applyPointFunction(PointFunction aFunction,
+                                                float aParameter) const
+//--------------------------------------------------------------------
+{
+    if (m_thread_number == 0 || m_thread_number == 1)
+    {
+        return PthreadImage(Image::applyPointFunction(aFunction, aParameter), m_thread_number);
+    }
+    else
+    {
+        // Create an image of the right size, every pixel is written below
+        PthreadImage temp(getWidth(), getHeight(), NO_INIT, m_thread_number);
 
+        // Every thread processes a contiguous range of pixels
+        runInParallel(m_thread_number, [this, &temp, aFunction, aParameter](unsigned int aTaskID)
+        {
+            unsigned int start_id, end_id;
+            getTaskRange(m_width * m_height, m_thread_number, aTaskID, start_id, end_id);
 
+            // Apply the function
+            Image::applyPointFunction(aFunction, aParameter,
+                                      &m_p_image[start_id], &temp.m_p_image[start_id], end_id - start_id);
+        });
+
+        return temp;
+    }
+}
+
+
+//-------------------------------------------------------------
+PthreadImage PthreadImage::applyLUT(const PointLUT& aLUT) const
+//-------------------------------------------------------------
+{
+    if (m_thread_number == 0 || m_thread_number == 1)
+    {
+        return PthreadImage(Image::applyLUT(aLUT), m_thread_number);
+    }
+    else
+    {
+        // Create an image of the right size, every pixel is written below
+        PthreadImage temp(getWidth(), getHeight(), NO_INIT, m_thread_number);
+
+        // Every thread processes a contiguous range of pixels
+        runInParallel(m_thread_number, [this, &temp, &aLUT](unsigned int aTaskID)
+        {
+            unsigned int start_id, end_id;
+            getTaskRange(m_width * m_height, m_thread_number, aTaskID, start_id, end_id);
+
+            // Look up the new value of every pixel
+            getImageKernels().applyLUT(&m_p_image[start_id], &temp.m_p_image[start_id], end_id - start_id,
+                                       aLUT.getTable().data(), aLUT.getNumberOfEntries());
+        });
 
         return temp;
     }
@@ -230,13 +604,20 @@ PthreadImage PthreadImage::flipHorizontally() const
     }
     else
     {
-        // Create an image of the right size
-        PthreadImage temp(getWidth(), getHeight(), 0.0, m_thread_number);
-
-        // Add your code here
-
+        // Create an image of the right size, every pixel is written below
+        PthreadImage temp(getWidth(), getHeight(), NO_INIT, m_thread_number);
 
+        // Every thread reverses a contiguous range of rows
+        runInParallel(m_thread_number, [this, &temp](unsigned int aTaskID)
+        {
+            unsigned int start_row, end_row;
+            getTaskRange(m_height, m_thread_number, aTaskID, start_row, end_row);
 
+            for (unsigned int y = start_row; y < end_row; ++y)
+            {
+                getImageKernels().reverseRow(&m_p_image[y * m_width], &temp.m_p_image[y * m_width], m_width);
+            }
+        });
 
         return temp;
     }
@@ -245,22 +626,31 @@ PthreadImage PthreadImage::flipHorizontally() const
 
 //-----------------------------------------------
 PthreadImage PthreadImage::flipVertically() const
-//-----------------------------------------------
-{
-    if (m_thread_number == 0 || m_thread_number == 1)
-    {
-        return PthreadImage(Image::flipVertically(), m_thread_number);
-    }
-    else
-    {
-        // Create an image of the right size
-        PthreadImage temp(getWidth(), getHeight(), 0.0, m_thread_number);
-
-        // Add your code here
-
-
-
-
-        return temp;
+//-----------------------------------------------
+{
+    if (m_thread_number == 0 || m_thread_number == 1)
+    {
+        return PthreadImage(Image::flipVertically(), m_thread_number);
+    }
+    else
+    {
+        // Create an image of the right size, every pixel is written below
+        PthreadImage temp(getWidth(), getHeight(), NO_INIT, m_thread_number);
+
+        // Every thread copies a contiguous range of rows to their mirrored position
+        runInParallel(m_thread_number, [this, &temp](unsigned int aTaskID)
+        {
+            unsigned int start_row, end_row;
+            getTaskRange(m_height, m_thread_number, aTaskID, start_row, end_row);
+
+            for (unsigned int y = start_row; y < end_row; ++y)
+            {
+                std::memcpy(&temp.m_p_image[(m_height - y - 1) * m_width],
+                            &m_p_image[y * m_width],
+                            m_width * sizeof(float));
+            }
+        });
+
+        return temp;
     }
 }
@@ -0,0 +1,199 @@
+/**
+********************************************************************************
+*
+*   @file       ReproducibleAccumulator.cxx
+*
+*   @brief      Exact accumulator of single precision values, whose result
+*               does not depend on the order of the additions.
+*
+*   @version    1.0
+*
+*   @date       19/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//  Include
+//******************************************************************************
+#include <cmath> // Header file for ldexp, isnan
+#include <limits>
+
+#include "ReproducibleAccumulator.h"
+
+
+//******************************************************************************
+//  Constant variables
+//******************************************************************************
+namespace
+{
+    // Index of the counters of non-finite values in the state
+    const unsigned int POSITIVE_INFINITY_ID = ReproducibleAccumulator::NUMBER_OF_CHUNKS;
+    const unsigned int NEGATIVE_INFINITY_ID = ReproducibleAccumulator::NUMBER_OF_CHUNKS + 1;
+    const unsigned int NAN_ID               = ReproducibleAccumulator::NUMBER_OF_CHUNKS + 2;
+
+    // Weight of the least significant bit of the first chunk
+    const int LSB_EXPONENT = -149;
+}
+
+
+//-------------------------------------------------
+ReproducibleAccumulator::ReproducibleAccumulator():
+//-------------------------------------------------
+        m_number_of_pending_additions(0)
+//-------------------------------------------------
+{
+    for (unsigned int i = 0; i < STATE_SIZE; ++i)
+    {
+        m_state[i] = 0;
+    }
+}
+
+
+//-------------------------------------------------------------------------------------------------
+ReproducibleAccumulator& ReproducibleAccumulator::operator+=(const ReproducibleAccumulator& anAccumulator)
+//-------------------------------------------------------------------------------------------------
+{
+    ReproducibleAccumulator temp(anAccumulator);
+
+    // Both chunk sets are in [0, 2^32), their sum cannot overflow
+    normalise();
+    temp.normalise();
+
+    for (unsigned int i = 0; i < STATE_SIZE; ++i)
+    {
+        m_state[i] += temp.m_state[i];
+    }
+
+    m_number_of_pending_additions = 2;
+
+    return *this;
+}
+
+
+//--------------------------------------------------------------------------------------------------------
+ReproducibleAccumulator ReproducibleAccumulator::operator+(const ReproducibleAccumulator& anAccumulator) const
+//--------------------------------------------------------------------------------------------------------
+{
+    ReproducibleAccumulator temp(*this);
+    temp += anAccumulator;
+    return temp;
+}
+
+
+//-----------------------------------------
+void ReproducibleAccumulator::normalise()
+//-----------------------------------------
+{
+    for (unsigned int i = 0; i + 1 < NUMBER_OF_CHUNKS; ++i)
+    {
+        // Arithmetic shift, the carry may be negative
+        std::int64_t carry = m_state[i] >> 32;
+        m_state[i] -= carry * (std::int64_t(1) << 32);
+        m_state[i + 1] += carry;
+    }
+
+    m_number_of_pending_additions = 0;
+}
+
+
+//-----------------------------------------
+float ReproducibleAccumulator::getSum() const
+//-----------------------------------------
+{
+    // Infinities and NaNs follow the IEEE rules, whatever the order
+    if (m_state[NAN_ID] ||
+            (m_state[POSITIVE_INFINITY_ID] && m_state[NEGATIVE_INFINITY_ID]))
+    {
+        return std::numeric_limits<float>::quiet_NaN();
+    }
+    else if (m_state[POSITIVE_INFINITY_ID])
+    {
+        return std::numeric_limits<float>::infinity();
+    }
+    else if (m_state[NEGATIVE_INFINITY_ID])
+    {
+        return -std::numeric_limits<float>::infinity();
+    }
+
+    ReproducibleAccumulator temp(*this);
+    temp.normalise();
+
+    // Work on the magnitude, the most significant chunk holds the sign
+    bool is_negative = temp.m_state[NUMBER_OF_CHUNKS - 1] < 0;
+    if (is_negative)
+    {
+        for (unsigned int i = 0; i < NUMBER_OF_CHUNKS; ++i)
+        {
+            temp.m_state[i] = -temp.m_state[i];
+        }
+        temp.normalise();
+    }
+
+    // Most significant non-zero chunk, at least the second one
+    int top_id = NUMBER_OF_CHUNKS - 1;
+    while (top_id > 1 && temp.m_state[top_id] == 0)
+    {
+        --top_id;
+    }
+
+    // The two top chunks hold every bit of the sum, or at least 33 bits,
+    // more than a float and its rounding bit. The lower chunks only decide
+    // the rounding through a sticky bit, so the conversion rounds once
+    std::uint64_t significand = (std::uint64_t(temp.m_state[top_id]) << 32) |
+                                std::uint64_t(temp.m_state[top_id - 1]);
+
+    for (int i = top_id - 2; i >= 0; --i)
+    {
+        if (temp.m_state[i])
+        {
+            significand |= 1;
+            break;
+        }
+    }
+
+    // Exact unless it overflows: the sum is normal whenever bits were
+    // dropped, and a multiple of 2^-149 otherwise
+    float sum = std::ldexp(float(significand), LSB_EXPONENT + 32 * (top_id - 1));
+
+    return (is_negative ? -sum : sum);
+}
+
+
+//----------------------------------------------
+std::int64_t* ReproducibleAccumulator::getState()
+//----------------------------------------------
+{
+    return m_state;
+}
+
+
+//----------------------------------------------------------
+const std::int64_t* ReproducibleAccumulator::getState() const
+//----------------------------------------------------------
+{
+    return m_state;
+}
+
+
+//--------------------------------------------------------
+void ReproducibleAccumulator::addNonFinite(float aValue)
+//--------------------------------------------------------
+{
+    if (std::isnan(aValue))
+    {
+        ++m_state[NAN_ID];
+    }
+    else if (aValue > 0)
+    {
+        ++m_state[POSITIVE_INFINITY_ID];
+    }
+    else
+    {
+        ++m_state[NEGATIVE_INFINITY_ID];
+    }
+}
@@ -0,0 +1,306 @@
+/**
+********************************************************************************
+*
+*   @file       pointFunctionAccuracy.cxx
+*
+*   @brief      Check the error of the SIMD point functions (fastLog,
+*               fastExp, fastPow and sqrt) against the C library in double
+*               precision, check that every instruction set gives the same
+*               results, and print their throughput.
+*
+*   @version    1.0
+*
+*   @date       19/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//  Include
+//******************************************************************************
+#include <cstdlib>
+#include <cstdint> // Header file for uint32_t and uint64_t
+#include <cstring> // Header file for memcpy and memcmp
+#include <cmath>
+#include <algorithm> // Header file for max
+#include <string>
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <exception>
+
+#include "ImageKernels.h"
+
+
+//******************************************************************************
+//  Namespace
+//******************************************************************************
+using namespace std;
+
+
+//******************************************************************************
+//  Constant variables
+//******************************************************************************
+
+/// Number of values given to the kernels at once
+const unsigned int BLOCK_SIZE = 1 << 16;
+
+/// Exponents of fastPow, the ones of FAST_POW_MAX_ULP_ERROR
+const float POW_EXPONENT_SET[] = {0.1f, 1.0f / 2.2f, 0.5f, 1.5f, 2.2f, 3.0f, -1.0f, -2.5f};
+
+
+//******************************************************************************
+//  Function declarations
+//******************************************************************************
+float toFloat(uint32_t aBits);
+double getULPError(float aValue, double aReference);
+bool checkFunction(const string& aName,
+                   double aMaxULPError,
+                   uint32_t aFirstBits,
+                   uint32_t aLastBits,
+                   uint32_t aStride,
+                   double (*aReference)(double, double),
+                   float anExponent);
+double referenceLog(double aValue, double);
+double referenceExp(double aValue, double);
+double referencePow(double aValue, double anExponent);
+double referenceSqrt(double aValue, double);
+
+
+//-----------------------------
+int main(int argc, char** argv)
+//-----------------------------
+{
+    // Return code
+    int error_code(0);
+
+    // Catch exceptions
+    try
+    {
+        if (argc > 2)
+        {
+            std::string error_message;
+            error_message += "Invalid command line\n";
+            error_message += "Usage:\t";
+            error_message += argv[0];
+            error_message += "   [stride between the bit patterns of the inputs (default: 97, 1 for every float)]";
+
+            throw error_message;
+        }
+
+        uint32_t stride = (argc == 2) ? atoi(argv[1]) : 97;
+        if (stride == 0)
+        {
+            throw "The stride must be at least 1";
+        }
+
+        // Bit patterns of +0, +inf, -104 and 89
+        const uint32_t PLUS_ZERO = 0x00000000;
+        const uint32_t PLUS_INF  = 0x7f800000;
+        const uint32_t MINUS_104 = 0xc2d00000;
+        const uint32_t PLUS_89   = 0x42b20000;
+
+        bool is_valid = true;
+
+        // Every positive float, subnormals included
+        is_valid &= checkFunction("fastLog", FAST_LOG_MAX_ULP_ERROR, PLUS_ZERO, PLUS_INF, stride, referenceLog, 0.0f);
+        is_valid &= checkFunction("sqrt", 0.5, PLUS_ZERO, PLUS_INF, stride, referenceSqrt, 0.0f);
+
+        // [-104, 0] then [0, 89], the bit patterns of the negative floats
+        // decrease with the value
+        is_valid &= checkFunction("fastExp", FAST_EXP_MAX_ULP_ERROR, 0x80000000, MINUS_104, stride, referenceExp, 0.0f);
+        is_valid &= checkFunction("fastExp", FAST_EXP_MAX_ULP_ERROR, PLUS_ZERO, PLUS_89, stride, referenceExp, 0.0f);
+
+        // Every positive float, for every exponent
+        for (unsigned int i = 0; i < sizeof(POW_EXPONENT_SET) / sizeof(float); ++i)
+        {
+            is_valid &= checkFunction("fastPow", FAST_POW_MAX_ULP_ERROR, PLUS_ZERO, PLUS_INF, stride, referencePow, POW_EXPONENT_SET[i]);
+        }
+
+        if (!is_valid)
+        {
+            cerr << "FAILED" << endl;
+            error_code = 1;
+        }
+    }
+    // An error occured
+    catch (const std::exception& error)
+    {
+        error_code = 1;
+        std::cerr << error.what() << std::endl;
+    }
+    catch (const std::string& error)
+    {
+        error_code = 1;
+        std::cerr << error << std::endl;
+    }
+    catch (const char* error)
+    {
+        error_code = 1;
+        std::cerr << error << std::endl;
+    }
+
+    return (error_code);
+}
+
+
+//---------------------------
+float toFloat(uint32_t aBits)
+//---------------------------
+{
+    float value;
+    memcpy(&value, &aBits, sizeof(float));
+    return (value);
+}
+
+
+//-------------------------------------------------
+double getULPError(float aValue, double aReference)
+//-------------------------------------------------
+{
+    // NaN, infinities and results out of the range of float must match
+    float rounded_reference(aReference);
+    if (std::isnan(aValue) || std::isnan(rounded_reference) ||
+        std::isinf(aValue) || std::isinf(rounded_reference))
+    {
+        if (std::isnan(aValue) && std::isnan(rounded_reference)) return (0.0);
+        return ((aValue == rounded_reference) ? 0.0 : HUGE_VAL);
+    }
+
+    // Spacing of the floats around the reference, 2^-149 for the subnormals
+    int exponent = (aReference == 0.0) ? -126 : std::max(std::ilogb(aReference), -126);
+    double ulp = std::ldexp(1.0, exponent - 23);
+
+    return (std::abs(aValue - aReference) / ulp);
+}
+
+
+//------------------------------------------------------
+bool checkFunction(const string& aName,
+                   double aMaxULPError,
+                   uint32_t aFirstBits,
+                   uint32_t aLastBits,
+                   uint32_t aStride,
+                   double (*aReference)(double, double),
+                   float anExponent)
+//------------------------------------------------------
+{
+    vector<string> isa_set = getAvailableImageKernelISAs();
+
+    vector<float> input(BLOCK_SIZE);
+    vector<vector<float> > output_set(isa_set.size(), vector<float>(BLOCK_SIZE));
+    vector<double> duration_set(isa_set.size(), 0.0);
+    vector<double> max_error_set(isa_set.size(), 0.0);
+    vector<float> worst_input_set(isa_set.size(), 0.0f);
+    bool is_consistent = true;
+    unsigned long long number_of_values = 0;
+
+    // Both ends are included
+    uint64_t bits = aFirstBits;
+    while (bits <= aLastBits)
+    {
+        // Next block of inputs
+        unsigned int size = 0;
+        while (size < BLOCK_SIZE && bits <= aLastBits)
+        {
+            input[size++] = toFloat(uint32_t(bits));
+            bits += aStride;
+        }
+
+        // Every variant
+        for (unsigned int i = 0; i < isa_set.size(); ++i)
+        {
+            setImageKernelISA(isa_set[i]);
+            const ImageKernels& kernels = getImageKernels();
+
+            chrono::high_resolution_clock::time_point start = chrono::high_resolution_clock::now();
+
+            if (aName == "fastLog")      kernels.fastLog(&input[0], &output_set[i][0], size);
+            else if (aName == "fastExp") kernels.fastExp(&input[0], &output_set[i][0], size);
+            else if (aName == "fastPow") kernels.fastPow(&input[0], &output_set[i][0], size, anExponent);
+            else                         kernels.sqrt(&input[0], &output_set[i][0], size);
+
+            chrono::high_resolution_clock::time_point end = chrono::high_resolution_clock::now();
+            duration_set[i] += chrono::duration<double>(end - start).count();
+
+            // Bit-identical to the first variant
+            if (i && memcmp(&output_set[i][0], &output_set[0][0], size * sizeof(float)))
+            {
+                is_consistent = false;
+            }
+
+            for (unsigned int j = 0; j < size; ++j)
+            {
+                double error = getULPError(output_set[i][j], aReference(input[j], anExponent));
+                if (error > max_error_set[i])
+                {
+                    max_error_set[i] = error;
+                    worst_input_set[i] = input[j];
+                }
+            }
+        }
+
+        number_of_values += size;
+    }
+
+    setImageKernelISA("auto");
+
+    bool is_valid = is_consistent;
+    for (unsigned int i = 0; i < isa_set.size(); ++i)
+    {
+        bool is_accurate = (max_error_set[i] <= aMaxULPError);
+        is_valid &= is_accurate;
+
+        cout << setw(8) << left << aName <<
+            setw(8) << left << ((aName == "fastPow") ? to_string(anExponent).substr(0, 6) : "") <<
+            setw(7) << left << isa_set[i] <<
+            "max error " << setw(10) << left << max_error_set[i] << " ULP" <<
+            " (bound " << aMaxULPError << ", x = " << setprecision(9) << worst_input_set[i] << setprecision(6) << "), " <<
+            (number_of_values / duration_set[i] / 1.0e6) << " Mvalues/s" <<
+            (is_accurate ? "" : "   ERROR TOO LARGE") << endl;
+    }
+
+    if (!is_consistent)
+    {
+        cout << aName << ": the instruction sets give different results" << endl;
+    }
+
+    return (is_valid);
+}
+
+
+//----------------------------------------
+double referenceLog(double aValue, double)
+//----------------------------------------
+{
+    return (std::log(aValue));
+}
+
+
+//----------------------------------------
+double referenceExp(double aValue, double)
+//----------------------------------------
+{
+    return (std::exp(aValue));
+}
+
+
+//---------------------------------------------------
+double referencePow(double aValue, double anExponent)
+//---------------------------------------------------
+{
+    return (std::pow(aValue, anExponent));
+}
+
+
+//-----------------------------------------
+double referenceSqrt(double aValue, double)
+//-----------------------------------------
+{
+    return (std::sqrt(aValue));
+}
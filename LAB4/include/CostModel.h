@@ -0,0 +1,181 @@
+#ifndef __CostModel_h
+#define __CostModel_h
+
+
+/**
+********************************************************************************
+*
+*   @file       CostModel.h
+*
+*   @brief      Calibrated cost models used to select an implementation and
+*               a number of threads automatically.
+*
+*   @version    1.0
+*
+*   @date       19/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//  Include
+//******************************************************************************
+#include <string>
+#include <vector>
+
+
+//==============================================================================
+/**
+*   @struct CostModelEntry
+*   @brief  Linear model of the runtime of an operation for a given
+*           implementation and number of threads:
+*           runtime = overhead + time_per_pixel * number_of_pixels
+*/
+//==============================================================================
+struct CostModelEntry
+{
+    std::string operation;
+    std::string implementation;
+    unsigned int number_of_threads;
+    double overhead;
+    double time_per_pixel;
+};
+
+
+//==============================================================================
+/**
+*   @struct CostModelChoice
+*   @brief  Implementation and number of threads selected by the cost model,
+*           and why.
+*/
+//==============================================================================
+struct CostModelChoice
+{
+    std::string implementation;
+    unsigned int number_of_threads;
+    double predicted_runtime;
+    std::string reason;
+};
+
+
+//==============================================================================
+/**
+*   @class  CostModel
+*   @brief  CostModel measures, once per machine, the fixed overhead and the
+*           per-pixel cost of every operation for every shared-memory
+*           implementation, stores them in a local file, and uses them to
+*           pick the fastest implementation for a given image size.
+*/
+//==============================================================================
+class CostModel
+//------------------------------------------------------------------------------
+{
+//******************************************************************************
+public:
+    //--------------------------------------------------------------------------
+    /// Default constructor.
+    //--------------------------------------------------------------------------
+    CostModel();
+
+
+    //------------------------------------------------------------------------
+    /// Load the cost models from a file.
+    /**
+    * @param aFileName: the name of the file to load
+    * @return true if the file exists and is valid, false otherwise
+    */
+    //------------------------------------------------------------------------
+    bool load(const std::string& aFileName);
+
+
+    //------------------------------------------------------------------------
+    /// Save the cost models in a file.
+    /**
+    * @param aFileName: the name of the file to write
+    */
+    //------------------------------------------------------------------------
+    void save(const std::string& aFileName) const;
+
+
+    //------------------------------------------------------------------------
+    /// Measure the cost models of all the operations on this machine.
+    /**
+    * @param aMaxNumberOfThreads: the largest number of threads to consider
+    */
+    //------------------------------------------------------------------------
+    void calibrate(unsigned int aMaxNumberOfThreads);
+
+
+    //------------------------------------------------------------------------
+    /// Load the cost models of this machine, or measure and save them if
+    /// they do not exist yet.
+    /**
+    * @param aMaxNumberOfThreads: the largest number of threads to consider
+    * @param aForceCalibrationFlag: measure the models even if they exist
+    */
+    //------------------------------------------------------------------------
+    void loadOrCalibrate(unsigned int aMaxNumberOfThreads,
+                         bool aForceCalibrationFlag = false);
+
+
+    //------------------------------------------------------------------------
+    /// Select the fastest implementation for an operation.
+    /**
+    * @param anOperation: the name of the operation (see getOperations())
+    * @param aNumberOfPixels: the number of pixels in the image
+    * @param aMaxNumberOfThreads: the largest number of threads allowed
+    *                             (0 for no limit)
+    * @return the implementation and number of threads to use
+    */
+    //------------------------------------------------------------------------
+    CostModelChoice choose(const std::string& anOperation,
+                           unsigned int aNumberOfPixels,
+                           unsigned int aMaxNumberOfThreads = 0) const;
+
+
+    //------------------------------------------------------------------------
+    /// Operations that can be calibrated.
+    /**
+    * @return the names of the operations
+    */
+    //------------------------------------------------------------------------
+    static const std::vector<std::string>& getOperations();
+
+
+    //------------------------------------------------------------------------
+    /// Parallel implementations that can be calibrated (serial is always
+    /// calibrated).
+    /**
+    * @return the names of the implementations
+    */
+    //------------------------------------------------------------------------
+    static const std::vector<std::string>& getParallelImplementations();
+
+
+    //------------------------------------------------------------------------
+    /// Name of the file used to store the cost models of this machine.
+    /// $ICE4131_COST_MODEL if set, ~/.ice4131-cost_model-<hostname>.csv
+    /// otherwise.
+    /**
+    * @return the file name
+    */
+    //------------------------------------------------------------------------
+    static std::string getDefaultFileName();
+
+
+//******************************************************************************
+private:
+    /// Predicted runtime of an entry for a given number of pixels
+    static double predict(const CostModelEntry& anEntry,
+                          unsigned int aNumberOfPixels);
+
+
+    /// The cost model of every (operation, implementation, thread count)
+    std::vector<CostModelEntry> m_entry_set;
+};
+
+#endif
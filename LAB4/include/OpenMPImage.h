@@ -97,6 +97,22 @@ public:
                 unsigned int aNumberOfThreads = 4);
 
 
+    //------------------------------------------------------------------------
+    /// Constructor to build an image whose pixels are not initialised
+    /// (see Image::NO_INIT).
+    /**
+    * @param aWidth: the width of the image
+    * @param aHeight: the height of the image
+    * @param aTag: NO_INIT
+    * @param aNumberOfThreads: the number of threads (default: 4)
+    */
+    //------------------------------------------------------------------------
+    OpenMPImage(unsigned int aWidth,
+                unsigned int aHeight,
+                NoInit aTag,
+                unsigned int aNumberOfThreads = 4);
+
+
     //------------------------------------------------------------------------
     /// Destructor.
     //------------------------------------------------------------------------
@@ -159,6 +175,16 @@ public:
     float getMaxValue() const;
 
 
+    //------------------------------------------------------------------------
+    /// Compute the minimum and the maximum pixel values in one pass
+    /**
+    * @param aMinValue: the minimum pixel
+    * @param aMaxValue: the maximum pixel
+    */
+    //------------------------------------------------------------------------
+    void getMinMaxValues(float& aMinValue, float& aMaxValue) const;
+
+
     //------------------------------------------------------------------------
     /// Compute the sum of all the pixel values of the image
     /**
@@ -168,6 +194,15 @@ public:
     float getSum() const;
 
 
+    //------------------------------------------------------------------------
+    /// Compute the average value of all the pixels of the image
+    /**
+    * @return the average value of all the pixels of the image
+    */
+    //------------------------------------------------------------------------
+    float getAverage() const;
+
+
     //------------------------------------------------------------------------
     /// Compute the variance of the pixel values of the image
     /**
@@ -177,6 +212,23 @@ public:
     float getVariance() const;
 
 
+    //------------------------------------------------------------------------
+    /// Compare with an image of the same size, pixel by pixel, and stop at
+    /// the first pixel that differs by more than aTolerance (or is NaN)
+    /**
+    * @param anImage: the image to compare with
+    * @param aTolerance: the largest difference between similar pixels
+    * @param aMaxDifference: the largest difference of the pixels up to the
+    *        first mismatch (included)
+    * @return the index of the first mismatch, or the number of pixels if
+    *         the images are similar
+    */
+    //------------------------------------------------------------------------
+    unsigned int findFirstMismatch(const Image& anImage,
+                                   float aTolerance,
+                                   float& aMaxDifference) const;
+
+
     //------------------------------------------------------------------------
     /// Operator Equal to
     /**
@@ -218,6 +270,29 @@ public:
     OpenMPImage logFilter() const;
 
 
+    //------------------------------------------------------------------------
+    /// Apply a function to every pixel (see Image::applyPointFunction())
+    /**
+    * @param aFunction: the function
+    * @param aParameter: the parameter of the function, i.e. the exponent
+    *        p of POW_FUNCTION, unused otherwise
+    * @return the new image
+    */
+    //------------------------------------------------------------------------
+    OpenMPImage applyPointFunction(PointFunction aFunction, float aParameter = 1.0) const;
+
+
+    //------------------------------------------------------------------------
+    /// Apply a lookup table on the image, e.g. a chain of point operators
+    /// on an 8-bit image (see PointLUT)
+    /**
+    * @param aLUT: the lookup table
+    * @return the new image
+    */
+    //------------------------------------------------------------------------
+    OpenMPImage applyLUT(const PointLUT& aLUT) const;
+
+
     //------------------------------------------------------------------------
     /// Flip the image horizonatally
     /**
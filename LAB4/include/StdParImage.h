@@ -0,0 +1,309 @@
+#ifndef __StdParImage_h
+#define __StdParImage_h
+
+
+/**
+********************************************************************************
+*
+*   @file       StdParImage.h
+*
+*   @brief      Class to handle a greyscale image using the C++17 parallel
+*               algorithms to speedup computations.
+*
+*   @version    1.0
+*
+*   @date       19/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+//******************************************************************************
+//  Include
+//******************************************************************************
+#include "Image.h"
+
+
+//==============================================================================
+/**
+*   @class  StdParImage
+*   @brief  StdParImage is a class to manage a greyscale image using the
+*           C++17 parallel algorithms (std::execution::par_unseq) to speedup
+*           computations. The number of threads is honoured when the standard
+*           library uses TBB as its backend (e.g. GCC's libstdc++).
+*/
+//==============================================================================
+class StdParImage: public Image
+//------------------------------------------------------------------------------
+{
+//******************************************************************************
+public:
+    //--------------------------------------------------------------------------
+    /// Default constructor.
+    /**
+    * @param anImage: the image to copy
+    */
+    //--------------------------------------------------------------------------
+    StdParImage(unsigned int aNumberOfThreads = 4);
+
+
+    //------------------------------------------------------------------------
+    /// Copy constructor.
+    /**
+    * @param anImage: the image to copy
+    * @param aNumberOfThreads: the number of threads (default: 4)
+    */
+    //------------------------------------------------------------------------
+    StdParImage(const Image& anImage, unsigned int aNumberOfThreads = 4);
+
+
+    //------------------------------------------------------------------------
+    /// Copy constructor.
+    /**
+    * @param anImage: the image to copy
+    */
+    //------------------------------------------------------------------------
+    StdParImage(const StdParImage& anImage);
+
+
+    //------------------------------------------------------------------------
+    /// Constructor from an array.
+    /**
+    * @param apData: the array to copy
+    * @param aWidth: the width of the image
+    * @param aHeight: the height of the image
+    * @param aNumberOfThreads: the number of threads (default: 4)
+    */
+    //------------------------------------------------------------------------
+    StdParImage(const float* apData,
+                 unsigned int aWidth,
+                 unsigned int aHeight,
+                 unsigned int aNumberOfThreads = 4);
+
+
+    //------------------------------------------------------------------------
+    /// Constructor to build a black image.
+    /**
+    * @param aWidth: the width of the image
+    * @param aHeight: the height of the image
+    * @param aNumberOfThreads: the number of threads (default: 4)
+    */
+    //------------------------------------------------------------------------
+    StdParImage(unsigned int aWidth,
+                 unsigned int aHeight,
+                float aDefaultValue = 0.0,
+                unsigned int aNumberOfThreads = 4);
+
+
+    //------------------------------------------------------------------------
+    /// Constructor to build an image whose pixels are not initialised
+    /// (see Image::NO_INIT).
+    /**
+    * @param aWidth: the width of the image
+    * @param aHeight: the height of the image
+    * @param aTag: NO_INIT
+    * @param aNumberOfThreads: the number of threads (default: 4)
+    */
+    //------------------------------------------------------------------------
+    StdParImage(unsigned int aWidth,
+                unsigned int aHeight,
+                NoInit aTag,
+                unsigned int aNumberOfThreads = 4);
+
+
+    //------------------------------------------------------------------------
+    /// Destructor.
+    //------------------------------------------------------------------------
+    ~StdParImage();
+
+
+    //------------------------------------------------------------------------
+    /// Set the number of threads.
+    /**
+    * @param aNumberOfThreads: the number of threads
+    */
+    //------------------------------------------------------------------------
+    void setNumberOfThreads(unsigned int aNumberOfThreads);
+
+
+    //------------------------------------------------------------------------
+    /// Get the number of threads.
+    /**
+    * @return the number of threads
+    */
+    //------------------------------------------------------------------------
+    unsigned int getNumberOfThreads() const;
+
+
+    //------------------------------------------------------------------------
+    /// Assignment operator (also called copy operator).
+    /**
+    * @param anImage: the image to copy
+    * @return the updated version of the current image
+    */
+    //------------------------------------------------------------------------
+    StdParImage& operator=(const Image& anImage);
+
+
+    //------------------------------------------------------------------------
+    /// Assignment operator (also called copy operator).
+    /**
+    * @param anImage: the image to copy
+    * @return the updated version of the current image
+    */
+    //------------------------------------------------------------------------
+    StdParImage& operator=(const StdParImage& anImage);
+
+
+    //------------------------------------------------------------------------
+    /// Compute the minimum pixel value in the image
+    /**
+    * @return the minimum pixel
+    */
+    //------------------------------------------------------------------------
+    float getMinValue() const;
+
+
+    //------------------------------------------------------------------------
+    /// Compute the maximum pixel value in the image
+    /**
+    * @return the maximum pixel
+    */
+    //------------------------------------------------------------------------
+    float getMaxValue() const;
+
+
+    //------------------------------------------------------------------------
+    /// Compute the minimum and the maximum pixel values in one pass
+    /**
+    * @param aMinValue: the minimum pixel
+    * @param aMaxValue: the maximum pixel
+    */
+    //------------------------------------------------------------------------
+    void getMinMaxValues(float& aMinValue, float& aMaxValue) const;
+
+
+    //------------------------------------------------------------------------
+    /// Compute the sum of all the pixel values of the image
+    /**
+    * @return the sum of all the pixel values of the image
+    */
+    //------------------------------------------------------------------------
+    float getSum() const;
+
+
+    //------------------------------------------------------------------------
+    /// Compute the average value of all the pixels of the image
+    /**
+    * @return the average value of all the pixels of the image
+    */
+    //------------------------------------------------------------------------
+    float getAverage() const;
+
+
+    //------------------------------------------------------------------------
+    /// Compute the variance of the pixel values of the image
+    /**
+    * @return the variance of the pixel values of the image
+    */
+    //------------------------------------------------------------------------
+    float getVariance() const;
+
+
+    //------------------------------------------------------------------------
+    /// Compare with an image of the same size, pixel by pixel, and stop at
+    /// the first pixel that differs by more than aTolerance (or is NaN)
+    /**
+    * @param anImage: the image to compare with
+    * @param aTolerance: the largest difference between similar pixels
+    * @param aMaxDifference: the largest difference of the pixels up to the
+    *        first mismatch (included)
+    * @return the index of the first mismatch, or the number of pixels if
+    *         the images are similar
+    */
+    //------------------------------------------------------------------------
+    unsigned int findFirstMismatch(const Image& anImage,
+                                   float aTolerance,
+                                   float& aMaxDifference) const;
+
+
+    //------------------------------------------------------------------------
+    /// Operator Equal to
+    /**
+    * @param anImage: the image to compare with
+    * @return true if the images are similar,
+    *         false if they are different
+    */
+    //------------------------------------------------------------------------
+    bool operator==(const Image& anImage) const;
+
+
+    //------------------------------------------------------------------------
+    /// Negation operator. Compute the negative of the current image.
+    /**
+    * @return the negative image
+    */
+    //------------------------------------------------------------------------
+    StdParImage operator!() const;
+
+
+    //------------------------------------------------------------------------
+    /// Add aShiftValue to every pixel, then multiply every pixel
+    /// by aScaleValue
+    /**
+    * @param aShiftValue: the shift parameter of the filter
+    * @param aScaleValue: the scale parameter of the filter
+    * @return the new image
+    */
+    //------------------------------------------------------------------------
+    StdParImage shiftScaleFilter(float aShiftValue, float aScaleValue) const;
+
+
+    //------------------------------------------------------------------------
+    /// Apply a log filter on the image
+    /**
+    * @return the new image
+    */
+    //------------------------------------------------------------------------
+    StdParImage logFilter() const;
+
+
+    //------------------------------------------------------------------------
+    /// Apply a lookup table on the image, e.g. a chain of point operators
+    /// on an 8-bit image (see PointLUT)
+    /**
+    * @param aLUT: the lookup table
+    * @return the new image
+    */
+    //------------------------------------------------------------------------
+    StdParImage applyLUT(const PointLUT& aLUT) const;
+
+
+    //------------------------------------------------------------------------
+    /// Flip the image horizonatally
+    /**
+    * @return the new image
+    */
+    //------------------------------------------------------------------------
+    StdParImage flipHorizontally() const;
+
+
+    //------------------------------------------------------------------------
+    /// Flip the image vertically
+    /**
+    * @return the new image
+    */
+    //------------------------------------------------------------------------
+    StdParImage flipVertically() const;
+
+
+//******************************************************************************
+private:
+    /// Number of threads
+    unsigned int m_thread_number;
+};
+
+
+#endif
@@ -0,0 +1,557 @@
+/**
+********************************************************************************
+*
+*   @file       CostModel.cxx
+*
+*   @brief      Calibrated cost models used to select an implementation and
+*               a number of threads automatically.
+*
+*   @version    1.0
+*
+*   @date       19/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//  Include
+//******************************************************************************
+#include <cstdlib>   // Header file for getenv
+#include <sstream>   // Header file for stringstream
+#include <fstream>   // Header file for filestream
+#include <iostream>  // Header file for cerr
+#include <algorithm> // Header file for min/max
+#include <limits>
+#include <chrono>    // To measure durations
+#include <random>    // To generate the calibration image
+
+#include <unistd.h>  // Header file for gethostname
+
+#include "CostModel.h"
+#include "Image.h"
+#include "PointLUT.h"
+#include "PthreadImage.h"
+#include "OpenMPImage.h"
+#include "StdParImage.h"
+
+
+//******************************************************************************
+//  Constant variables
+//******************************************************************************
+namespace
+{
+    /// Size of the small image used for the calibration (overhead)
+    const unsigned int SMALL_IMAGE_SIZE = 64;
+
+    /// Size of the large image used for the calibration (cost per pixel)
+    const unsigned int LARGE_IMAGE_SIZE = 1024;
+
+    /// Number of runs per measurement (the fastest one is kept)
+    const unsigned int NUMBER_OF_RUNS = 5;
+
+    /// First line of the file
+    const char* FILE_HEADER = "operation,implementation,number_of_threads,overhead_in_sec,time_per_pixel_in_sec";
+
+
+    //--------------------------------------------------------------------------
+    template<typename T> void runOperation(const std::string& anOperation,
+                                           const T& anImage)
+    //--------------------------------------------------------------------------
+    {
+        if (anOperation == "log")
+        {
+            float min_value, max_value;
+            anImage.getMinMaxValues(min_value, max_value);
+            T output = anImage.shiftScaleFilter(-min_value, 1.0 / (max_value - min_value)).logFilter();
+        }
+        else if (anOperation == "fast_log")
+        {
+            Image::LogMode log_mode = Image::getLogMode();
+            Image::setLogMode(Image::FAST_LOG);
+
+            float min_value, max_value;
+            anImage.getMinMaxValues(min_value, max_value);
+            T output = anImage.shiftScaleFilter(-min_value, 1.0 / (max_value - min_value)).logFilter();
+
+            Image::setLogMode(log_mode);
+        }
+        else if (anOperation == "lut_log")
+        {
+            float min_value, max_value;
+            anImage.getMinMaxValues(min_value, max_value);
+            T output = anImage.applyLUT(PointLUT(anImage).shiftScaleFilter(-min_value, 1.0 / (max_value - min_value)).logFilter());
+        }
+        else if (anOperation == "flip_horizontally")
+        {
+            T output = anImage.flipHorizontally();
+        }
+        else if (anOperation == "flip_vertically")
+        {
+            T output = anImage.flipVertically();
+        }
+        else
+        {
+            throw "Unknown operation";
+        }
+    }
+
+
+    //--------------------------------------------------------------------------
+    template<typename T> double timeOperation(const std::string& anOperation,
+                                              const T& anImage)
+    //--------------------------------------------------------------------------
+    {
+        double runtime = std::numeric_limits<double>::max();
+
+        // Keep the fastest run to filter out the noise
+        for (unsigned int i = 0; i < NUMBER_OF_RUNS; ++i)
+        {
+            auto start = std::chrono::high_resolution_clock::now();
+            runOperation(anOperation, anImage);
+            auto end = std::chrono::high_resolution_clock::now();
+
+            runtime = std::min(runtime, std::chrono::duration<double>(end - start).count());
+        }
+
+        return runtime;
+    }
+
+
+    //--------------------------------------------------------------------------
+    double timeOperation(const std::string& anOperation,
+                         const std::string& anImplementation,
+                         unsigned int aNumberOfThreads,
+                         const Image& anImage)
+    //--------------------------------------------------------------------------
+    {
+        if (anImplementation == "serial")
+        {
+            return timeOperation(anOperation, anImage);
+        }
+        else if (anImplementation == "pthread")
+        {
+            return timeOperation(anOperation, PthreadImage(anImage, aNumberOfThreads));
+        }
+        else if (anImplementation == "openmp")
+        {
+            return timeOperation(anOperation, OpenMPImage(anImage, aNumberOfThreads));
+        }
+        else if (anImplementation == "stdpar")
+        {
+            return timeOperation(anOperation, StdParImage(anImage, aNumberOfThreads));
+        }
+        else
+        {
+            throw "Unknown implementation";
+        }
+    }
+
+
+    //--------------------------------------------------------------------------
+    Image createCalibrationImage(unsigned int aSize)
+    //--------------------------------------------------------------------------
+    {
+        std::mt19937 generator;
+        std::uniform_int_distribution<int> distribution(0, 255);
+
+        Image temp(aSize, aSize);
+        for (unsigned int i = 0; i < aSize * aSize; ++i)
+        {
+            temp[i] = distribution(generator);
+        }
+
+        return temp;
+    }
+}
+
+
+//---------------------
+CostModel::CostModel()
+//---------------------
+{}
+
+
+//----------------------------------------------------
+bool CostModel::load(const std::string& aFileName)
+//----------------------------------------------------
+{
+    m_entry_set.clear();
+
+    // Open the file
+    std::ifstream input_file(aFileName.c_str());
+
+    // The file does not exist
+    if (!input_file.is_open())
+    {
+        return false;
+    }
+
+    // Check the header
+    std::string line;
+    if (!std::getline(input_file, line) || line != FILE_HEADER)
+    {
+        return false;
+    }
+
+    // Read every model
+    while (std::getline(input_file, line))
+    {
+        if (line.empty()) continue;
+
+        std::stringstream line_parser(line);
+        std::string number_of_threads;
+        std::string overhead;
+        std::string time_per_pixel;
+        CostModelEntry entry;
+
+        std::getline(line_parser, entry.operation, ',');
+        std::getline(line_parser, entry.implementation, ',');
+        std::getline(line_parser, number_of_threads, ',');
+        std::getline(line_parser, overhead, ',');
+        std::getline(line_parser, time_per_pixel, ',');
+
+        // Invalid line
+        if (entry.operation.empty() || entry.implementation.empty() ||
+            number_of_threads.empty() || overhead.empty() ||
+            time_per_pixel.empty())
+        {
+            m_entry_set.clear();
+            return false;
+        }
+
+        entry.number_of_threads = std::atoi(number_of_threads.c_str());
+        entry.overhead          = std::atof(overhead.c_str());
+        entry.time_per_pixel    = std::atof(time_per_pixel.c_str());
+
+        m_entry_set.push_back(entry);
+    }
+
+    return !m_entry_set.empty();
+}
+
+
+//-------------------------------------------------------
+void CostModel::save(const std::string& aFileName) const
+//-------------------------------------------------------
+{
+    // Open the file
+    std::ofstream output_file(aFileName.c_str());
+
+    // The file is not open
+    if (!output_file.is_open())
+    {
+        std::string error_message("The file (");
+        error_message += aFileName;
+        error_message += ") cannot be created";
+
+        throw error_message;
+    }
+
+    output_file.precision(std::numeric_limits<double>::max_digits10);
+    output_file << FILE_HEADER << std::endl;
+
+    for (std::vector<CostModelEntry>::const_iterator ite = m_entry_set.begin();
+            ite != m_entry_set.end();
+            ++ite)
+    {
+        output_file << ite->operation << "," <<
+            ite->implementation << "," <<
+            ite->number_of_threads << "," <<
+            ite->overhead << "," <<
+            ite->time_per_pixel << std::endl;
+    }
+}
+
+
+//------------------------------------------------------------
+void CostModel::calibrate(unsigned int aMaxNumberOfThreads)
+//------------------------------------------------------------
+{
+    m_entry_set.clear();
+
+    // Numbers of threads to try: 2, 4, 8, ... and the maximum
+    std::vector<unsigned int> number_of_threads_set;
+    for (unsigned int i = 2; i < aMaxNumberOfThreads; i *= 2)
+    {
+        number_of_threads_set.push_back(i);
+    }
+
+    if (aMaxNumberOfThreads > 1)
+    {
+        number_of_threads_set.push_back(aMaxNumberOfThreads);
+    }
+
+    // Implementations and numbers of threads to try
+    std::vector<std::pair<std::string, unsigned int> > implementation_set;
+    implementation_set.push_back(std::make_pair(std::string("serial"), 1u));
+
+    for (std::vector<std::string>::const_iterator implementation = getParallelImplementations().begin();
+            implementation != getParallelImplementations().end();
+            ++implementation)
+    {
+        for (std::vector<unsigned int>::const_iterator ite = number_of_threads_set.begin();
+                ite != number_of_threads_set.end();
+                ++ite)
+        {
+            implementation_set.push_back(std::make_pair(*implementation, *ite));
+        }
+    }
+
+    // Images used for the calibration
+    Image small_image(createCalibrationImage(SMALL_IMAGE_SIZE));
+    Image large_image(createCalibrationImage(LARGE_IMAGE_SIZE));
+    double small_number_of_pixels = SMALL_IMAGE_SIZE * SMALL_IMAGE_SIZE;
+    double large_number_of_pixels = LARGE_IMAGE_SIZE * LARGE_IMAGE_SIZE;
+
+    // Fit runtime = overhead + time_per_pixel * number_of_pixels
+    for (std::vector<std::string>::const_iterator operation = getOperations().begin();
+            operation != getOperations().end();
+            ++operation)
+    {
+        for (std::vector<std::pair<std::string, unsigned int> >::const_iterator ite = implementation_set.begin();
+                ite != implementation_set.end();
+                ++ite)
+        {
+            double small_runtime = timeOperation(*operation, ite->first, ite->second, small_image);
+            double large_runtime = timeOperation(*operation, ite->first, ite->second, large_image);
+
+            CostModelEntry entry;
+            entry.operation = *operation;
+            entry.implementation = ite->first;
+            entry.number_of_threads = ite->second;
+            entry.time_per_pixel = std::max(0.0, (large_runtime - small_runtime) / (large_number_of_pixels - small_number_of_pixels));
+            entry.overhead = std::max(0.0, small_runtime - entry.time_per_pixel * small_number_of_pixels);
+
+            m_entry_set.push_back(entry);
+        }
+    }
+}
+
+
+//-------------------------------------------------------------------
+void CostModel::loadOrCalibrate(unsigned int aMaxNumberOfThreads,
+                                bool aForceCalibrationFlag)
+//-------------------------------------------------------------------
+{
+    std::string file_name = getDefaultFileName();
+
+    bool need_calibration = aForceCalibrationFlag || !load(file_name);
+
+    // The models were measured with fewer threads than needed now,
+    // or before an implementation or an operation was added
+    if (!need_calibration)
+    {
+        unsigned int calibrated_number_of_threads = 1;
+        for (std::vector<CostModelEntry>::const_iterator ite = m_entry_set.begin();
+                ite != m_entry_set.end();
+                ++ite)
+        {
+            calibrated_number_of_threads = std::max(calibrated_number_of_threads, ite->number_of_threads);
+        }
+
+        need_calibration = calibrated_number_of_threads < aMaxNumberOfThreads;
+
+        for (std::vector<std::string>::const_iterator implementation = getParallelImplementations().begin();
+                implementation != getParallelImplementations().end() && aMaxNumberOfThreads > 1;
+                ++implementation)
+        {
+            bool is_calibrated = false;
+            for (std::vector<CostModelEntry>::const_iterator ite = m_entry_set.begin();
+                    ite != m_entry_set.end() && !is_calibrated;
+                    ++ite)
+            {
+                is_calibrated = (ite->implementation == *implementation);
+            }
+
+            need_calibration |= !is_calibrated;
+        }
+
+        for (std::vector<std::string>::const_iterator operation = getOperations().begin();
+                operation != getOperations().end();
+                ++operation)
+        {
+            bool is_calibrated = false;
+            for (std::vector<CostModelEntry>::const_iterator ite = m_entry_set.begin();
+                    ite != m_entry_set.end() && !is_calibrated;
+                    ++ite)
+            {
+                is_calibrated = (ite->operation == *operation);
+            }
+
+            need_calibration |= !is_calibrated;
+        }
+    }
+
+    if (need_calibration)
+    {
+        std::cerr << "Calibrating the cost models with up to " <<
+            aMaxNumberOfThreads << " threads, this is done only once..." <<
+            std::endl;
+
+        calibrate(aMaxNumberOfThreads);
+        save(file_name);
+
+        std::cerr << "Cost models saved in " << file_name << std::endl;
+    }
+}
+
+
+//-------------------------------------------------------------------------
+CostModelChoice CostModel::choose(const std::string& anOperation,
+                                  unsigned int aNumberOfPixels,
+                                  unsigned int aMaxNumberOfThreads) const
+//-------------------------------------------------------------------------
+{
+    const CostModelEntry* p_best_entry = 0;
+    const CostModelEntry* p_serial_entry = 0;
+    bool has_parallel_entry = false;
+
+    for (std::vector<CostModelEntry>::const_iterator ite = m_entry_set.begin();
+            ite != m_entry_set.end();
+            ++ite)
+    {
+        // Ignore other operations and too many threads
+        if (ite->operation != anOperation) continue;
+        if (aMaxNumberOfThreads && ite->number_of_threads > aMaxNumberOfThreads) continue;
+
+        if (ite->implementation == "serial")
+        {
+            p_serial_entry = &(*ite);
+        }
+        else
+        {
+            has_parallel_entry = true;
+        }
+
+        // Keep the fastest, prefer fewer threads in case of a tie
+        if (!p_best_entry ||
+            predict(*ite, aNumberOfPixels) < predict(*p_best_entry, aNumberOfPixels))
+        {
+            p_best_entry = &(*ite);
+        }
+    }
+
+    CostModelChoice choice;
+    std::stringstream reason;
+
+    // No model, use the serial implementation
+    if (!p_best_entry)
+    {
+        choice.implementation = "serial";
+        choice.number_of_threads = 0;
+        choice.predicted_runtime = 0;
+        choice.reason = "no cost model for \"" + anOperation + "\", fall back to serial";
+        return choice;
+    }
+
+    choice.implementation = p_best_entry->implementation;
+    choice.number_of_threads = (p_best_entry->implementation == "serial") ? 0 : p_best_entry->number_of_threads;
+    choice.predicted_runtime = predict(*p_best_entry, aNumberOfPixels);
+
+    reason << "predicted " << choice.predicted_runtime << " sec";
+
+    if (p_serial_entry && p_serial_entry != p_best_entry)
+    {
+        reason << " vs " << predict(*p_serial_entry, aNumberOfPixels) << " sec for serial";
+
+        // Break-even point of the selected implementation against serial
+        if (p_serial_entry->time_per_pixel > p_best_entry->time_per_pixel)
+        {
+            reason << ", parallel pays off above " <<
+                (unsigned int)(std::max(0.0, p_best_entry->overhead - p_serial_entry->overhead) /
+                    (p_serial_entry->time_per_pixel - p_best_entry->time_per_pixel)) <<
+                " pixels";
+        }
+    }
+    else if (!has_parallel_entry)
+    {
+        reason << ", a single thread is available";
+    }
+    else
+    {
+        reason << ", image below the size where the parallel overhead pays off";
+    }
+
+    choice.reason = reason.str();
+
+    return choice;
+}
+
+
+//-------------------------------------------------------------
+const std::vector<std::string>& CostModel::getOperations()
+//-------------------------------------------------------------
+{
+    static std::vector<std::string> operation_set;
+
+    if (operation_set.empty())
+    {
+        operation_set.push_back("log");
+        operation_set.push_back("fast_log");
+        operation_set.push_back("lut_log");
+        operation_set.push_back("flip_horizontally");
+        operation_set.push_back("flip_vertically");
+    }
+
+    return operation_set;
+}
+
+
+//-------------------------------------------------------------------------
+const std::vector<std::string>& CostModel::getParallelImplementations()
+//-------------------------------------------------------------------------
+{
+    static std::vector<std::string> implementation_set;
+
+    if (implementation_set.empty())
+    {
+        implementation_set.push_back("pthread");
+        implementation_set.push_back("openmp");
+        implementation_set.push_back("stdpar");
+    }
+
+    return implementation_set;
+}
+
+
+//-------------------------------------------
+std::string CostModel::getDefaultFileName()
+//-------------------------------------------
+{
+    // The user chose the file
+    const char* p_file_name = std::getenv("ICE4131_COST_MODEL");
+    if (p_file_name && *p_file_name)
+    {
+        return p_file_name;
+    }
+
+    // One file per machine, as the home directory is shared between nodes
+    char p_host_name[256] = "localhost";
+    gethostname(p_host_name, sizeof(p_host_name) - 1);
+
+    std::string file_name;
+    const char* p_home = std::getenv("HOME");
+    if (p_home && *p_home)
+    {
+        file_name = std::string(p_home) + "/";
+    }
+
+    file_name += ".ice4131-cost_model-";
+    file_name += p_host_name;
+    file_name += ".csv";
+
+    return file_name;
+}
+
+
+//---------------------------------------------------------------
+double CostModel::predict(const CostModelEntry& anEntry,
+                          unsigned int aNumberOfPixels)
+//---------------------------------------------------------------
+{
+    return anEntry.overhead + anEntry.time_per_pixel * aNumberOfPixels;
+}
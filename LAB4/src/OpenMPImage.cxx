@@ -24,9 +24,28 @@
 //******************************************************************************
 #include <cmath> // Header file for abs and log
 #include <limits>
+#include <cstring> // Header file for memcpy
+#include <algorithm> // Header file for min and max
+#include <functional> // Header file for plus
+#include <utility> // Header file for pair
 #include <omp.h> // Header file for OpenMP
 
 #include "OpenMPImage.h"
+#include "ParallelReduction.h"
+#include "ReproducibleAccumulator.h"
+#include "ImageKernels.h"
+#include "PointLUT.h"
+
+
+//******************************************************************************
+//  Constant variables
+//******************************************************************************
+namespace
+{
+    /// Number of pixels given to the point kernels at once. The blocks are
+    /// shared among the threads with a static schedule.
+    const unsigned int BLOCK_SIZE = 4096;
+}
 
 
 //--------------------------------------------------------
@@ -81,6 +100,18 @@ OpenMPImage::OpenMPImage(unsigned int aWidth,
 {}
 
 
+//------------------------------------------------------
+OpenMPImage::OpenMPImage(unsigned int aWidth,
+                         unsigned int aHeight,
+                         NoInit aTag,
+                         unsigned int aNumberOfThreads):
+//------------------------------------------------------
+        Image(aWidth, aHeight, aTag),
+        m_thread_number(aNumberOfThreads)
+//------------------------------------------------------
+{}
+
+
 //---------------------------
 OpenMPImage::~OpenMPImage()
 //---------------------------
@@ -126,15 +157,8 @@ OpenMPImage& OpenMPImage::operator=(const OpenMPImage& anImage)
 float OpenMPImage::getMinValue() const
 //------------------------------------
 {
-    float min_value = std::numeric_limits<float>::max();
-
-#pragma omp parallel for reduction(min: min_value)
-    for (unsigned int i = 0; i < m_width * m_height; ++i)
-    {
-        if (min_value > m_p_image[i]) min_value = m_p_image[i];
-    }
-
-
+    float min_value, max_value;
+    getMinMaxValues(min_value, max_value);
     return (min_value);
 }
 
@@ -143,16 +167,46 @@ float OpenMPImage::getMinValue() const
 float OpenMPImage::getMaxValue() const
 //------------------------------------
 {
-    float max_value = std::numeric_limits<float>::min();
+    float min_value, max_value;
+    getMinMaxValues(min_value, max_value);
+    return (max_value);
+}
 
-#pragma omp parallel for reduction(max: max_value)
-    for (unsigned int i = 0; i < m_width * m_height; ++i)
+
+//--------------------------------------------------------------------------
+void OpenMPImage::getMinMaxValues(float& aMinValue, float& aMaxValue) const
+//--------------------------------------------------------------------------
+{
+    // The image is empty
+    if (m_p_image.empty())
     {
-        if (max_value < m_p_image[i]) max_value = m_p_image[i];
+        throw "Empty image";
     }
 
+    // One padded (min, max) pair per task
+    ParallelReduction<std::pair<float, float> > reduction(m_thread_number,
+            std::make_pair(std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity()));
 
-    return (max_value);
+    // The tasks are processed in parallel, the partial result of a task does
+    // not depend on the thread that processed it
+#pragma omp parallel for num_threads(reduction.size()) schedule(static)
+    for (unsigned int task_id = 0; task_id < reduction.size(); ++task_id)
+    {
+        unsigned int start_id, end_id;
+        reduction.getRange(m_width * m_height, task_id, start_id, end_id);
+
+        getImageKernels().getMinMax(&m_p_image[start_id], end_id - start_id,
+                                    reduction[task_id].first, reduction[task_id].second);
+    }
+
+    std::pair<float, float> min_max = reduction.combine([](const std::pair<float, float>& a,
+                                                           const std::pair<float, float>& b)
+    {
+        return std::make_pair(std::min(a.first, b.first), std::max(a.second, b.second));
+    });
+
+    aMinValue = min_max.first;
+    aMaxValue = min_max.second;
 }
 
 
@@ -160,15 +214,44 @@ float OpenMPImage::getMaxValue() const
 float OpenMPImage::getSum() const
 //-------------------------------
 {
-    float sum = 0.0;
+    // Exact partial sums, the result does not depend on the number of threads
+    if (m_summation_mode == REPRODUCIBLE_SUMMATION)
+    {
+        ParallelReduction<ReproducibleAccumulator> reduction(m_thread_number, ReproducibleAccumulator());
+
+#pragma omp parallel for num_threads(reduction.size()) schedule(static)
+        for (unsigned int task_id = 0; task_id < reduction.size(); ++task_id)
+        {
+            unsigned int start_id, end_id;
+            reduction.getRange(m_width * m_height, task_id, start_id, end_id);
+
+            getImageKernels().accumulate(&m_p_image[start_id], end_id - start_id, reduction[task_id]);
+        }
+
+        return (reduction.combine(std::plus<ReproducibleAccumulator>()).getSum());
+    }
+
+    // One padded partial result per task
+    ParallelReduction<float> reduction(m_thread_number, 0.0f);
 
-#pragma omp parallel for reduction(+: sum)
-    for (unsigned int i = 0; i < m_width * m_height; ++i)
+#pragma omp parallel for num_threads(reduction.size()) schedule(static)
+    for (unsigned int task_id = 0; task_id < reduction.size(); ++task_id)
     {
-        sum += m_p_image[i];
+        unsigned int start_id, end_id;
+        reduction.getRange(m_width * m_height, task_id, start_id, end_id);
+
+        reduction[task_id] = getImageKernels().getSum(&m_p_image[start_id], end_id - start_id);
     }
 
-    return (sum);
+    return (reduction.combine(std::plus<float>()));
+}
+
+
+//-----------------------------------
+float OpenMPImage::getAverage() const
+//-----------------------------------
+{
+    return (getSum() / (m_width * m_height));
 }
 
 
@@ -176,16 +259,94 @@ float OpenMPImage::getSum() const
 float OpenMPImage::getVariance() const
 //------------------------------------
 {
+    // Use the parallel sum, not Image::getSum()
     float mean = getAverage();
-    float sum = 0.0;
 
-#pragma omp parallel for reduction(+: sum)
-    for (unsigned int i = 0; i < m_width * m_height; ++i)
+    // Exact partial sums, the result does not depend on the number of threads
+    if (m_summation_mode == REPRODUCIBLE_SUMMATION)
+    {
+        ParallelReduction<ReproducibleAccumulator> reduction(m_thread_number, ReproducibleAccumulator());
+
+#pragma omp parallel for num_threads(reduction.size()) schedule(static)
+        for (unsigned int task_id = 0; task_id < reduction.size(); ++task_id)
+        {
+            unsigned int start_id, end_id;
+            reduction.getRange(m_width * m_height, task_id, start_id, end_id);
+
+            getImageKernels().accumulateSquaredDifferences(&m_p_image[start_id], end_id - start_id,
+                                                           mean, reduction[task_id]);
+        }
+
+        return (reduction.combine(std::plus<ReproducibleAccumulator>()).getSum() / (m_width * m_height));
+    }
+
+    // One padded partial result per task
+    ParallelReduction<float> reduction(m_thread_number, 0.0f);
+
+#pragma omp parallel for num_threads(reduction.size()) schedule(static)
+    for (unsigned int task_id = 0; task_id < reduction.size(); ++task_id)
     {
-        sum += (m_p_image[i] - mean) * (m_p_image[i] - mean);
+        unsigned int start_id, end_id;
+        reduction.getRange(m_width * m_height, task_id, start_id, end_id);
+
+        reduction[task_id] = getImageKernels().getSumOfSquaredDifferences(&m_p_image[start_id],
+                                                                          end_id - start_id,
+                                                                          mean);
     }
 
-    return (sum / (m_width * m_height));
+    return (reduction.combine(std::plus<float>()) / (m_width * m_height));
+}
+
+
+//----------------------------------------------------------------------
+unsigned int OpenMPImage::findFirstMismatch(const Image& anImage,
+                                            float aTolerance,
+                                            float& aMaxDifference) const
+//----------------------------------------------------------------------
+{
+    if (m_width != anImage.getWidth() || m_height != anImage.getHeight())
+    {
+        throw "The images have different sizes";
+    }
+
+    unsigned int number_of_pixels = m_width * m_height;
+
+    // One padded (first mismatch, max difference) pair per task, every task
+    // stops at the first mismatch of its range
+    ParallelReduction<std::pair<unsigned int, float> > reduction(m_thread_number,
+            std::make_pair(number_of_pixels, 0.0f));
+
+#pragma omp parallel for num_threads(reduction.size()) schedule(static)
+    for (unsigned int task_id = 0; task_id < reduction.size(); ++task_id)
+    {
+        unsigned int start_id, end_id;
+        reduction.getRange(number_of_pixels, task_id, start_id, end_id);
+
+        // More threads than pixels: nothing to compare
+        if (end_id > start_id)
+        {
+            unsigned int mismatch_id = getImageKernels().compare(m_p_image.data() + start_id, &anImage[0] + start_id,
+                                                                 end_id - start_id,
+                                                                 aTolerance, reduction[task_id].second);
+
+            if (mismatch_id < end_id - start_id)
+            {
+                reduction[task_id].first = start_id + mismatch_id;
+            }
+        }
+    }
+
+    // The ranges after the first mismatch are ignored
+    std::pair<unsigned int, float> mismatch = reduction.combine([number_of_pixels](const std::pair<unsigned int, float>& a,
+                                                                                   const std::pair<unsigned int, float>& b)
+    {
+        if (a.first < number_of_pixels) return a;
+
+        return std::make_pair(b.first, (b.second <= a.second) ? a.second : b.second);
+    });
+
+    aMaxDifference = mismatch.second;
+    return (mismatch.first);
 }
 
 
@@ -203,15 +364,8 @@ bool OpenMPImage::operator==(const Image& anImage) const
         return (false);
     }
 
-    for (unsigned int i = 0; i < m_width * m_height; ++i)
-    {
-        if (std::abs(m_p_image[i] - anImage[i]) > 1.0e-6)
-        {
-            return (false);
-        }
-    }
-
-    return (true);
+    float max_difference;
+    return (findFirstMismatch(anImage, 1.0e-6, max_difference) == m_width * m_height);
 }
 
 
@@ -219,18 +373,26 @@ bool OpenMPImage::operator==(const Image& anImage) const
 OpenMPImage OpenMPImage::operator!() const
 //------------------------------------------
 {
-    // Copy the instance into a temporary variable
-    OpenMPImage temp(*this);
+    // Create an image of the right size, every pixel is written below
+    OpenMPImage temp(getWidth(), getHeight(), NO_INIT, m_thread_number);
 
-    float min_value(getMinValue());
-    float max_value(getMaxValue());
+    float min_value, max_value;
+    getMinMaxValues(min_value, max_value);
     float range(max_value - min_value);
 
-    // Process every pixel
-    for (unsigned int i = 0; i < m_width * m_height; ++i)
+    unsigned int number_of_pixels = m_width * m_height;
+    unsigned int number_of_blocks = (number_of_pixels + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+    // Process every block of pixels
+#pragma omp parallel for num_threads(m_thread_number) schedule(static)
+    for (unsigned int block_id = 0; block_id < number_of_blocks; ++block_id)
     {
+        unsigned int start_id = block_id * BLOCK_SIZE;
+        unsigned int end_id = std::min(number_of_pixels, start_id + BLOCK_SIZE);
+
         // Take care to preserve the dynamic of the image
-        temp[i] = min_value + range * (1.0 - (temp[i] - min_value) / range);
+        getImageKernels().negate(&m_p_image[start_id], &temp.m_p_image[start_id], end_id - start_id,
+                                 min_value, range);
     }
 
     // Return the result
@@ -243,14 +405,22 @@ OpenMPImage OpenMPImage::shiftScaleFilter(float aShiftValue,
                                             float aScaleValue) const
 //------------------------------------------------------------------
 {
-    // Create an image of the right size
-    OpenMPImage temp(getWidth(), getHeight(), 0.0, m_thread_number);
+    // Create an image of the right size, every pixel is written below
+    OpenMPImage temp(getWidth(), getHeight(), NO_INIT, m_thread_number);
+
+    unsigned int number_of_pixels = m_width * m_height;
+    unsigned int number_of_blocks = (number_of_pixels + BLOCK_SIZE - 1) / BLOCK_SIZE;
 
-    // Process every pixel of the image
-    for (unsigned int i = 0; i < m_width * m_height; ++i)
+    // Process every block of pixels
+#pragma omp parallel for num_threads(m_thread_number) schedule(static)
+    for (unsigned int block_id = 0; block_id < number_of_blocks; ++block_id)
     {
-        // Apply the shilft/scale filter
-        temp[i] = (m_p_image[i] + aShiftValue) * aScaleValue;
+        unsigned int start_id = block_id * BLOCK_SIZE;
+        unsigned int end_id = std::min(number_of_pixels, start_id + BLOCK_SIZE);
+
+        // Apply the shift/scale filter
+        getImageKernels().shiftScale(&m_p_image[start_id], &temp.m_p_image[start_id], end_id - start_id,
+                                     aShiftValue, aScaleValue);
     }
 
     return temp;
@@ -261,66 +431,119 @@ OpenMPImage OpenMPImage::shiftScaleFilter(float aShiftValue,
 OpenMPImage OpenMPImage::logFilter() const
 //----------------------------------------
 {
-    // Create an image of the right size
-    OpenMPImage temp(getWidth(), getHeight(), 0.0, m_thread_number);
+    // Create an image of the right size, every pixel is written below
+    OpenMPImage temp(getWidth(), getHeight(), NO_INIT, m_thread_number);
+
+    unsigned int number_of_pixels = m_width * m_height;
+    unsigned int number_of_blocks = (number_of_pixels + BLOCK_SIZE - 1) / BLOCK_SIZE;
 
-    // Process every pixel of the image
-    for (unsigned int i = 0; i < m_width * m_height; ++i)
+    // Process every block of pixels
+#pragma omp parallel for num_threads(m_thread_number) schedule(static)
+    for (unsigned int block_id = 0; block_id < number_of_blocks; ++block_id)
     {
+        unsigned int start_id = block_id * BLOCK_SIZE;
+        unsigned int end_id = std::min(number_of_pixels, start_id + BLOCK_SIZE);
+
         // Apply the log filter
-        temp[i] = log(m_p_image[i]);
+        if (m_log_mode == FAST_LOG)
+        {
+            getImageKernels().fastLog(&m_p_image[start_id], &temp.m_p_image[start_id], end_id - start_id);
+        }
+        else
+        {
+            getImageKernels().log(&m_p_image[start_id], &temp.m_p_image[start_id], end_id - start_id);
+        }
     }
 
     return temp;
 }
 
 
-//-----------------------------------
-Image Image::flipHorizontally() const
-//-----------------------------------
+//------------------------------------------------------------------
+OpenMPImage OpenMPImage::applyPointFunction(PointFunction aFunction,
+                                              float aParameter) const
+//------------------------------------------------------------------
 {
-    // Create an image of the right size
-    Image temp(getWidth(), getHeight());
+    // Create an image of the right size, every pixel is written below
+    OpenMPImage temp(getWidth(), getHeight(), NO_INIT, m_thread_number);
 
-    // Process every pixel of the image
-    for (unsigned int i = 0; i < m_width * m_height; ++i)
+    unsigned int number_of_pixels = m_width * m_height;
+    unsigned int number_of_blocks = (number_of_pixels + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+    // Process every block of pixels
+#pragma omp parallel for num_threads(m_thread_number) schedule(static)
+    for (unsigned int block_id = 0; block_id < number_of_blocks; ++block_id)
     {
-        // Retrieve the 2D index (x, y) from i
+        unsigned int start_id = block_id * BLOCK_SIZE;
+        unsigned int end_id = std::min(number_of_pixels, start_id + BLOCK_SIZE);
 
-        // % is the "modulo operator", the remainder of i / m_width
-        int x = i % m_width;
+        // Apply the function
+        Image::applyPointFunction(aFunction, aParameter,
+                                  &m_p_image[start_id], &temp.m_p_image[start_id], end_id - start_id);
+    }
 
-        // where "/" is an integer division
-        int y = i / m_width;
+    return temp;
+}
+
+
+//-----------------------------------------------------------
+OpenMPImage OpenMPImage::applyLUT(const PointLUT& aLUT) const
+//-----------------------------------------------------------
+{
+    // Create an image of the right size, every pixel is written below
+    OpenMPImage temp(getWidth(), getHeight(), NO_INIT, m_thread_number);
+
+    unsigned int number_of_pixels = m_width * m_height;
+    unsigned int number_of_blocks = (number_of_pixels + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+    // Process every block of pixels
+#pragma omp parallel for num_threads(m_thread_number) schedule(static)
+    for (unsigned int block_id = 0; block_id < number_of_blocks; ++block_id)
+    {
+        unsigned int start_id = block_id * BLOCK_SIZE;
+        unsigned int end_id = std::min(number_of_pixels, start_id + BLOCK_SIZE);
 
-        // Get the pixel
-        temp(x, y) = getPixel(m_width - x - 1, y);
+        // Look up the new value of every pixel
+        getImageKernels().applyLUT(&m_p_image[start_id], &temp.m_p_image[start_id], end_id - start_id,
+                                   aLUT.getTable().data(), aLUT.getNumberOfEntries());
     }
 
     return temp;
 }
 
 
-//---------------------------------
-Image Image::flipVertically() const
-//---------------------------------
+//-----------------------------------------------
+OpenMPImage OpenMPImage::flipHorizontally() const
+//-----------------------------------------------
 {
-    // Create an image of the right size
-    Image temp(getWidth(), getHeight());
+    // Create an image of the right size, every pixel is written below
+    OpenMPImage temp(getWidth(), getHeight(), NO_INIT, m_thread_number);
 
-    // Process every pixel of the image
-    for (unsigned int i = 0; i < m_width * m_height; ++i)
+    // Reverse every row of the image
+#pragma omp parallel for num_threads(m_thread_number)
+    for (unsigned int y = 0; y < m_height; ++y)
     {
-        // Retrieve the 2D index (x, y) from i
+        getImageKernels().reverseRow(&m_p_image[y * m_width], &temp.m_p_image[y * m_width], m_width);
+    }
+
+    return temp;
+}
 
-        // % is the "modulo operator", the remainder of i / m_width
-        int x = i % m_width;
 
-        // where "/" is an integer division
-        int y = i / m_width;
+//---------------------------------------------
+OpenMPImage OpenMPImage::flipVertically() const
+//---------------------------------------------
+{
+    // Create an image of the right size, every pixel is written below
+    OpenMPImage temp(getWidth(), getHeight(), NO_INIT, m_thread_number);
 
-        // Get the pixel
-        temp(x, y) = getPixel(x, m_height - y - 1);
+    // Copy every row to its mirrored position
+#pragma omp parallel for num_threads(m_thread_number)
+    for (unsigned int y = 0; y < m_height; ++y)
+    {
+        std::memcpy(&temp.m_p_image[(m_height - y - 1) * m_width],
+                    &m_p_image[y * m_width],
+                    m_width * sizeof(float));
     }
 
     return temp;
@@ -0,0 +1,586 @@
+/**
+********************************************************************************
+*
+*   @file       StdParImage.cxx
+*
+*   @brief      Class to handle a greyscale image using the C++17 parallel
+*               algorithms to speedup computations.
+*
+*   @version    1.0
+*
+*   @date       19/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//  Include
+//******************************************************************************
+#include <cmath> // Header file for abs and log
+#include <cstring> // Header file for memcpy
+#include <algorithm> // Header file for transform, minmax_element, etc.
+#include <numeric> // Header file for reduce, transform_reduce and iota
+#include <functional> // Header file for plus
+#include <execution> // Header file for the execution policies
+#include <vector>
+
+#ifdef HAS_TBB
+#include <tbb/global_control.h> // To limit the number of threads of TBB
+#endif
+
+#include "StdParImage.h"
+#include "ReproducibleAccumulator.h"
+#include "ImageKernels.h"
+#include "PointLUT.h"
+
+
+//******************************************************************************
+//  Function declarations
+//******************************************************************************
+namespace
+{
+    //--------------------------------------------------------------------------
+    /// Limit the number of threads used by the parallel algorithms during
+    /// the lifetime of the instance. The standard has no such control, it is
+    /// only possible when the backend is TBB.
+    //--------------------------------------------------------------------------
+    class ThreadLimit
+    {
+    public:
+        ThreadLimit(unsigned int aNumberOfThreads)
+#ifdef HAS_TBB
+            : m_control(tbb::global_control::max_allowed_parallelism,
+                        std::max(1u, aNumberOfThreads))
+#endif
+        {}
+
+#ifdef HAS_TBB
+    private:
+        tbb::global_control m_control;
+#endif
+    };
+
+
+    //--------------------------------------------------------------------------
+    /// Exact sum of anOperation(pixel) over all the pixels. Blocks of pixels
+    /// are accumulated in parallel, the order in which the runtime combines
+    /// them does not matter.
+    //--------------------------------------------------------------------------
+    template<typename UnaryOperation>
+    float reproducibleSum(const Image::PixelVector& aPixelSet,
+                          UnaryOperation anOperation)
+    {
+        const unsigned int BLOCK_SIZE = 65536;
+
+        std::vector<unsigned int> block_set((aPixelSet.size() + BLOCK_SIZE - 1) / BLOCK_SIZE);
+        std::iota(block_set.begin(), block_set.end(), 0);
+
+        const float* p_input = aPixelSet.data();
+        unsigned int number_of_pixels = aPixelSet.size();
+
+        return std::transform_reduce(std::execution::par,
+                                     block_set.begin(),
+                                     block_set.end(),
+                                     ReproducibleAccumulator(),
+                                     std::plus<ReproducibleAccumulator>(),
+                                     [p_input, number_of_pixels, anOperation](unsigned int aBlockID)
+                                     {
+                                         ReproducibleAccumulator accumulator;
+                                         unsigned int end_id = std::min(number_of_pixels, (aBlockID + 1) * BLOCK_SIZE);
+                                         for (unsigned int i = aBlockID * BLOCK_SIZE; i < end_id; ++i)
+                                         {
+                                             accumulator.add(anOperation(p_input[i]));
+                                         }
+                                         return accumulator;
+                                     }).getSum();
+    }
+
+}
+
+
+//--------------------------------------------------------
+StdParImage::StdParImage(unsigned int aNumberOfThreads):
+//--------------------------------------------------------
+        Image(),
+        m_thread_number(aNumberOfThreads)
+//--------------------------------------------------------
+{}
+
+
+//--------------------------------------------------------
+StdParImage::StdParImage(const Image& anImage,
+                         unsigned int aNumberOfThreads):
+//--------------------------------------------------------
+        Image(anImage),
+        m_thread_number(aNumberOfThreads)
+//--------------------------------------------------------
+{}
+
+
+//------------------------------------------------------
+StdParImage::StdParImage(const StdParImage& anImage):
+//------------------------------------------------------
+        Image(anImage),
+        m_thread_number(anImage.m_thread_number)
+//------------------------------------------------------
+{}
+
+
+//-------------------------------------------------------
+StdParImage::StdParImage(const float* apData,
+                         unsigned int aWidth,
+                         unsigned int aHeight,
+                         unsigned int aNumberOfThreads):
+//-------------------------------------------------------
+        Image(apData, aWidth, aHeight),
+        m_thread_number(aNumberOfThreads)
+//-------------------------------------------------------
+{}
+
+
+//--------------------------------------------------------
+StdParImage::StdParImage(unsigned int aWidth,
+                         unsigned int aHeight,
+                         float aDefaultValue,
+                         unsigned int aNumberOfThreads):
+//--------------------------------------------------------
+        Image(aWidth, aHeight, aDefaultValue),
+        m_thread_number(aNumberOfThreads)
+//--------------------------------------------------------
+{}
+
+
+//------------------------------------------------------
+StdParImage::StdParImage(unsigned int aWidth,
+                         unsigned int aHeight,
+                         NoInit aTag,
+                         unsigned int aNumberOfThreads):
+//------------------------------------------------------
+        Image(aWidth, aHeight, aTag),
+        m_thread_number(aNumberOfThreads)
+//------------------------------------------------------
+{}
+
+
+//---------------------------
+StdParImage::~StdParImage()
+//---------------------------
+{}
+
+
+//------------------------------------------------------------------
+void StdParImage::setNumberOfThreads(unsigned int aNumberOfThreads)
+//------------------------------------------------------------------
+{
+    m_thread_number = aNumberOfThreads;
+}
+
+
+//---------------------------------------------------
+unsigned int StdParImage::getNumberOfThreads() const
+//---------------------------------------------------
+{
+    return m_thread_number;
+}
+
+
+//---------------------------------------------------------
+StdParImage& StdParImage::operator=(const Image& anImage)
+//---------------------------------------------------------
+{
+    Image::operator=(anImage);
+    return *this;
+}
+
+
+//----------------------------------------------------------------
+StdParImage& StdParImage::operator=(const StdParImage& anImage)
+//----------------------------------------------------------------
+{
+    Image::operator=(anImage);
+    m_thread_number = anImage.m_thread_number;
+    return *this;
+}
+
+
+//------------------------------------
+float StdParImage::getMinValue() const
+//------------------------------------
+{
+    float min_value, max_value;
+    getMinMaxValues(min_value, max_value);
+    return (min_value);
+}
+
+
+//------------------------------------
+float StdParImage::getMaxValue() const
+//------------------------------------
+{
+    float min_value, max_value;
+    getMinMaxValues(min_value, max_value);
+    return (max_value);
+}
+
+
+//--------------------------------------------------------------------------
+void StdParImage::getMinMaxValues(float& aMinValue, float& aMaxValue) const
+//--------------------------------------------------------------------------
+{
+    // The image is empty
+    if (m_p_image.empty())
+    {
+        throw "Empty image";
+    }
+
+    ThreadLimit thread_limit(m_thread_number);
+
+    auto min_max = std::minmax_element(std::execution::par_unseq,
+                                       m_p_image.begin(),
+                                       m_p_image.end());
+
+    aMinValue = *min_max.first;
+    aMaxValue = *min_max.second;
+}
+
+
+//-------------------------------
+float StdParImage::getSum() const
+//-------------------------------
+{
+    ThreadLimit thread_limit(m_thread_number);
+
+    // Exact sum, the result does not depend on the number of threads
+    if (m_summation_mode == REPRODUCIBLE_SUMMATION)
+    {
+        return (reproducibleSum(m_p_image, [](float aValue) { return aValue; }));
+    }
+
+    return (std::reduce(std::execution::par_unseq,
+                        m_p_image.begin(),
+                        m_p_image.end(),
+                        0.0f));
+}
+
+
+//-----------------------------------
+float StdParImage::getAverage() const
+//-----------------------------------
+{
+    return (getSum() / (m_width * m_height));
+}
+
+
+//------------------------------------
+float StdParImage::getVariance() const
+//------------------------------------
+{
+    float mean = getAverage();
+
+    ThreadLimit thread_limit(m_thread_number);
+
+    // Exact sum, the result does not depend on the number of threads
+    if (m_summation_mode == REPRODUCIBLE_SUMMATION)
+    {
+        return (reproducibleSum(m_p_image,
+                                [mean](float aValue)
+                                {
+                                    return (aValue - mean) * (aValue - mean);
+                                }) / (m_width * m_height));
+    }
+
+    float sum = std::transform_reduce(std::execution::par_unseq,
+                                      m_p_image.begin(),
+                                      m_p_image.end(),
+                                      0.0f,
+                                      std::plus<float>(),
+                                      [mean](float aValue)
+                                      {
+                                          return (aValue - mean) * (aValue - mean);
+                                      });
+
+    return (sum / (m_width * m_height));
+}
+
+
+//----------------------------------------------------------------------
+unsigned int StdParImage::findFirstMismatch(const Image& anImage,
+                                            float aTolerance,
+                                            float& aMaxDifference) const
+//----------------------------------------------------------------------
+{
+    if (m_width != anImage.getWidth() || m_height != anImage.getHeight())
+    {
+        throw "The images have different sizes";
+    }
+
+    ThreadLimit thread_limit(m_thread_number);
+
+    // First pixel out of the tolerance (or NaN)
+    auto mismatch = std::mismatch(std::execution::par_unseq,
+                                  m_p_image.begin(),
+                                  m_p_image.end(),
+                                  &anImage[0],
+                                  [aTolerance](float aValue1, float aValue2)
+                                  {
+                                      return (std::abs(aValue1 - aValue2) <= aTolerance);
+                                  });
+
+    unsigned int mismatch_id = mismatch.first - m_p_image.begin();
+
+    // Largest difference up to the mismatch (included), NaN wins
+    unsigned int end_id = std::min<unsigned int>(mismatch_id + 1, m_p_image.size());
+    aMaxDifference = std::transform_reduce(std::execution::par_unseq,
+                                           m_p_image.begin(),
+                                           m_p_image.begin() + end_id,
+                                           &anImage[0],
+                                           0.0f,
+                                           [](float aValue1, float aValue2)
+                                           {
+                                               return ((aValue1 != aValue1 || aValue2 <= aValue1) ? aValue1 : aValue2);
+                                           },
+                                           [](float aValue1, float aValue2)
+                                           {
+                                               return (std::abs(aValue1 - aValue2));
+                                           });
+
+    return (mismatch_id);
+}
+
+
+//------------------------------------------------------
+bool StdParImage::operator==(const Image& anImage) const
+//------------------------------------------------------
+{
+    if (m_width != anImage.getWidth())
+    {
+        return (false);
+    }
+
+    if (m_height != anImage.getHeight())
+    {
+        return (false);
+    }
+
+    if (m_p_image.empty())
+    {
+        return (true);
+    }
+
+    ThreadLimit thread_limit(m_thread_number);
+
+    return (std::equal(std::execution::par_unseq,
+                       m_p_image.begin(),
+                       m_p_image.end(),
+                       &anImage[0],
+                       [](float aValue1, float aValue2)
+                       {
+                           return (std::abs(aValue1 - aValue2) <= 1.0e-6);
+                       }));
+}
+
+
+//------------------------------------------
+StdParImage StdParImage::operator!() const
+//------------------------------------------
+{
+    // Create an image of the right size, every pixel is written below
+    StdParImage temp(getWidth(), getHeight(), NO_INIT, m_thread_number);
+
+    if (m_p_image.empty())
+    {
+        return (temp);
+    }
+
+    ThreadLimit thread_limit(m_thread_number);
+
+    // Find the range with a single pass
+    float min_value, max_value;
+    getMinMaxValues(min_value, max_value);
+    float range(max_value - min_value);
+
+    // Process every pixel
+    std::transform(std::execution::par_unseq,
+                   m_p_image.begin(),
+                   m_p_image.end(),
+                   temp.m_p_image.begin(),
+                   [min_value, range](float aValue)
+                   {
+                       // Take care to preserve the dynamic of the image
+                       return float(min_value + range * (1.0 - (aValue - min_value) / range));
+                   });
+
+    // Return the result
+    return (temp);
+}
+
+
+//------------------------------------------------------------------
+StdParImage StdParImage::shiftScaleFilter(float aShiftValue,
+                                          float aScaleValue) const
+//------------------------------------------------------------------
+{
+    // Create an image of the right size, every pixel is written below
+    StdParImage temp(getWidth(), getHeight(), NO_INIT, m_thread_number);
+
+    ThreadLimit thread_limit(m_thread_number);
+
+    // Process every pixel of the image
+    std::transform(std::execution::par_unseq,
+                   m_p_image.begin(),
+                   m_p_image.end(),
+                   temp.m_p_image.begin(),
+                   [aShiftValue, aScaleValue](float aValue)
+                   {
+                       // Apply the shilft/scale filter
+                       return (aValue + aShiftValue) * aScaleValue;
+                   });
+
+    return temp;
+}
+
+
+//----------------------------------------
+StdParImage StdParImage::logFilter() const
+//----------------------------------------
+{
+    // Create an image of the right size, every pixel is written below
+    StdParImage temp(getWidth(), getHeight(), NO_INIT, m_thread_number);
+
+    ThreadLimit thread_limit(m_thread_number);
+
+    // Blocks of pixels, processed in parallel by the log kernel
+    const unsigned int BLOCK_SIZE = 4096;
+
+    std::vector<unsigned int> block_set((m_p_image.size() + BLOCK_SIZE - 1) / BLOCK_SIZE);
+    std::iota(block_set.begin(), block_set.end(), 0);
+
+    const float* p_input = m_p_image.data();
+    float* p_output = temp.m_p_image.data();
+    unsigned int number_of_pixels = m_p_image.size();
+
+    const ImageKernels& kernels = getImageKernels();
+    void (*log_kernel)(const float*, float*, unsigned int) =
+            (m_log_mode == FAST_LOG) ? kernels.fastLog : kernels.log;
+
+    std::for_each(std::execution::par,
+                  block_set.begin(),
+                  block_set.end(),
+                  [p_input, p_output, number_of_pixels, log_kernel](unsigned int aBlockID)
+                  {
+                      unsigned int start_id = aBlockID * BLOCK_SIZE;
+                      unsigned int end_id = std::min(number_of_pixels, start_id + BLOCK_SIZE);
+                      log_kernel(p_input + start_id, p_output + start_id, end_id - start_id);
+                  });
+
+    return temp;
+}
+
+
+//-----------------------------------------------------------
+StdParImage StdParImage::applyLUT(const PointLUT& aLUT) const
+//-----------------------------------------------------------
+{
+    // Create an image of the right size, every pixel is written below
+    StdParImage temp(getWidth(), getHeight(), NO_INIT, m_thread_number);
+
+    ThreadLimit thread_limit(m_thread_number);
+
+    // Blocks of pixels, processed in parallel by the lookup kernel
+    const unsigned int BLOCK_SIZE = 4096;
+
+    std::vector<unsigned int> block_set((m_p_image.size() + BLOCK_SIZE - 1) / BLOCK_SIZE);
+    std::iota(block_set.begin(), block_set.end(), 0);
+
+    const float* p_input = m_p_image.data();
+    float* p_output = temp.m_p_image.data();
+    unsigned int number_of_pixels = m_p_image.size();
+
+    const float* p_table = aLUT.getTable().data();
+    unsigned int table_size = aLUT.getNumberOfEntries();
+    void (*apply_lut_kernel)(const float*, float*, unsigned int, const float*, unsigned int) =
+            getImageKernels().applyLUT;
+
+    std::for_each(std::execution::par,
+                  block_set.begin(),
+                  block_set.end(),
+                  [p_input, p_output, number_of_pixels, p_table, table_size, apply_lut_kernel](unsigned int aBlockID)
+                  {
+                      unsigned int start_id = aBlockID * BLOCK_SIZE;
+                      unsigned int end_id = std::min(number_of_pixels, start_id + BLOCK_SIZE);
+                      apply_lut_kernel(p_input + start_id, p_output + start_id, end_id - start_id,
+                                       p_table, table_size);
+                  });
+
+    return temp;
+}
+
+
+//-----------------------------------------------
+StdParImage StdParImage::flipHorizontally() const
+//-----------------------------------------------
+{
+    // Create an image of the right size, every pixel is written below
+    StdParImage temp(getWidth(), getHeight(), NO_INIT, m_thread_number);
+
+    // Row indices, processed in parallel
+    std::vector<unsigned int> row_set(m_height);
+    std::iota(row_set.begin(), row_set.end(), 0);
+
+    ThreadLimit thread_limit(m_thread_number);
+
+    const float* p_input = m_p_image.data();
+    float* p_output = temp.m_p_image.data();
+    unsigned int width = m_width;
+    void (*reverse_row_kernel)(const float*, float*, unsigned int) = getImageKernels().reverseRow;
+
+    // Reverse every row
+    std::for_each(std::execution::par_unseq,
+                  row_set.begin(),
+                  row_set.end(),
+                  [p_input, p_output, width, reverse_row_kernel](unsigned int aRow)
+                  {
+                      reverse_row_kernel(p_input + aRow * width,
+                                         p_output + aRow * width,
+                                         width);
+                  });
+
+    return temp;
+}
+
+
+//---------------------------------------------
+StdParImage StdParImage::flipVertically() const
+//---------------------------------------------
+{
+    // Create an image of the right size, every pixel is written below
+    StdParImage temp(getWidth(), getHeight(), NO_INIT, m_thread_number);
+
+    // Row indices, processed in parallel
+    std::vector<unsigned int> row_set(m_height);
+    std::iota(row_set.begin(), row_set.end(), 0);
+
+    ThreadLimit thread_limit(m_thread_number);
+
+    const float* p_input = m_p_image.data();
+    float* p_output = temp.m_p_image.data();
+    unsigned int width = m_width;
+    unsigned int height = m_height;
+
+    // Copy every row to its mirrored position
+    std::for_each(std::execution::par_unseq,
+                  row_set.begin(),
+                  row_set.end(),
+                  [p_input, p_output, width, height](unsigned int aRow)
+                  {
+                      std::memcpy(p_output + (height - aRow - 1) * width,
+                                  p_input + aRow * width,
+                                  width * sizeof(float));
+                  });
+
+    return temp;
+}
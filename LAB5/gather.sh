@@ -0,0 +1,50 @@
+#!/bin/bash
+# Compare how the MPI processes assemble the output image: point-to-point
+# messages (p2p), MPI_Gatherv, MPI_Allgatherv and chunks sent with MPI_Isend
+# as soon as they are computed (pipelined), from 2 to 256 processes. The
+# overlap efficiency of every run is written in gather-overlap.txt.
+#
+# Project/Account (use your own)
+#SBATCH -A scw1563
+#
+# Number of MPI tasks
+#SBATCH -n 256
+#
+# Number of tasks per node
+#SBATCH --tasks-per-node=40
+#
+# Runtime of this jobs is less then 2 hours.
+#SBATCH --time=02:00:00
+
+# Clear the environment from any previously loaded modules
+module purge > /dev/null 2>&1
+
+# Load the module environment suitable for the job
+source env.sh
+
+# Change the input image path if needed
+INPUT_IMAGE="../LAB3/Airbus_Pleiades_50cm_8bit_grey_Yogyakarta.txt"
+
+# Number of runs of every configuration
+NUMBER_OF_RUNS=5
+
+# Header for the CSV files, the implementation is mpi:<gather mode>
+header="\"input_file\",\"output_file\",implementation,number_of_processes_or_threads,duration_in_sec,sockets,physical_cores,logical_cpus,allowed_cpus,isa"
+
+echo "Log_filter,"$header  > gather-log.csv
+echo "Flip_filter,"$header > gather-flip.csv
+> gather-overlap.txt
+
+for i in 2 4 8 16 32 64 128 256
+do
+    for mode in p2p gatherv allgatherv pipelined
+    do
+        for run in `seq $NUMBER_OF_RUNS`
+        do
+            mpirun -np $i ./bin/log     -c MPI --gather $mode -i $INPUT_IMAGE -n $i >> gather-log.csv  2>> gather-overlap.txt
+            mpirun -np $i ./bin/flip -H -c MPI --gather $mode -i $INPUT_IMAGE -n $i >> gather-flip.csv 2>> gather-overlap.txt
+        done
+    done
+done
+
+# End of submit file
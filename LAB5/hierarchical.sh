@@ -0,0 +1,64 @@
+#!/bin/bash
+# Compare flat collectives (one MPI_Gatherv, MPI_Allreduce, etc. over all
+# the processes) with hierarchical ones (in every node, then between the node
+# leaders), with 10 to 40 processes per node on 1 to 4 nodes. The ranks are
+# either consecutive in every node (core) or dealt to the nodes in turn
+# (node).
+#
+# Project/Account (use your own)
+#SBATCH -A scw1563
+#
+# Number of nodes, all their cores are used
+#SBATCH --nodes=4
+#SBATCH --exclusive
+#
+# Runtime of this jobs is less then 2 hours.
+#SBATCH --time=02:00:00
+
+# Clear the environment from any previously loaded modules
+module purge > /dev/null 2>&1
+
+# Load the module environment suitable for the job
+source env.sh
+
+# Change the input image path if needed
+INPUT_IMAGE="../LAB3/Airbus_Pleiades_50cm_8bit_grey_Yogyakarta.txt"
+
+# Number of runs of every configuration
+NUMBER_OF_RUNS=5
+
+# Header for the CSV files, the implementation is
+# mpi:<gather mode>:<collective mode> and the layout is in the last column
+header="\"input_file\",\"output_file\",implementation,number_of_processes_or_threads,duration_in_sec,sockets,physical_cores,logical_cpus,allowed_cpus,isa,rank_by"
+
+echo "Log_filter,"$header  > hierarchical-log.csv
+echo "Flip_filter,"$header > hierarchical-flip.csv
+
+for nodes in 1 2 4
+do
+    for processes_per_node in 10 20 40
+    do
+        processes=$(( nodes * processes_per_node ))
+
+        for rank_by in core node
+        do
+            MAPPING="--map-by ppr:$processes_per_node:node --rank-by $rank_by --bind-to core"
+
+            for gather in gatherv allgatherv dynamic
+            do
+                for collectives in flat hierarchical
+                do
+                    OPTIONS="-c mpi --gather $gather --collectives $collectives"
+
+                    for run in `seq $NUMBER_OF_RUNS`
+                    do
+                        mpirun -np $processes $MAPPING ./bin/log     $OPTIONS -i $INPUT_IMAGE | sed "s/$/,$rank_by/" >> hierarchical-log.csv
+                        mpirun -np $processes $MAPPING ./bin/flip -H $OPTIONS -i $INPUT_IMAGE | sed "s/$/,$rank_by/" >> hierarchical-flip.csv
+                    done
+                done
+            done
+        done
+    done
+done
+
+# End of submit file
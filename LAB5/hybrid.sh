@@ -0,0 +1,59 @@
+#!/bin/bash
+# Compare MPI processes only (mpi) with MPI processes and OpenMP threads
+# (hybrid) on the same number of cores: from 40 processes of 1 thread to 1
+# process of 40 threads per node, on 1 to 4 nodes.
+#
+# Project/Account (use your own)
+#SBATCH -A scw1563
+#
+# Number of nodes, all their cores are used
+#SBATCH --nodes=4
+#SBATCH --exclusive
+#
+# Runtime of this jobs is less then 2 hours.
+#SBATCH --time=02:00:00
+
+# Clear the environment from any previously loaded modules
+module purge > /dev/null 2>&1
+
+# Load the module environment suitable for the job
+source env.sh
+
+# Change the input image path if needed
+INPUT_IMAGE="../LAB3/Airbus_Pleiades_50cm_8bit_grey_Yogyakarta.txt"
+
+# Number of runs of every configuration
+NUMBER_OF_RUNS=5
+
+# Number of cores per node
+CORES_PER_NODE=40
+
+# Header for the CSV files, the implementation is hybrid:<processes>x<threads>
+# and the number of threads is the total number of threads
+header="\"input_file\",\"output_file\",implementation,number_of_processes_or_threads,duration_in_sec,sockets,physical_cores,logical_cpus,allowed_cpus,isa"
+
+echo "Log_filter,"$header  > hybrid-log.csv
+echo "Flip_filter,"$header > hybrid-flip.csv
+
+for nodes in 1 2 4
+do
+    for threads in 1 2 4 10 20 40
+    do
+        processes_per_node=$(( CORES_PER_NODE / threads ))
+        processes=$(( nodes * processes_per_node ))
+
+        # Every process is bound to its own cores, its threads stay there
+        export OMP_NUM_THREADS=$threads
+        export OMP_PROC_BIND=close
+        export OMP_PLACES=cores
+        MAPPING="--map-by ppr:$processes_per_node:node:PE=$threads --bind-to core"
+
+        for run in `seq $NUMBER_OF_RUNS`
+        do
+            mpirun -np $processes $MAPPING ./bin/log     -c hybrid -n $threads -i $INPUT_IMAGE >> hybrid-log.csv
+            mpirun -np $processes $MAPPING ./bin/flip -H -c hybrid -n $threads -i $INPUT_IMAGE >> hybrid-flip.csv
+        done
+    done
+done
+
+# End of submit file
@@ -0,0 +1,396 @@
+#ifndef __MPIBlockDecomposition_h
+#define __MPIBlockDecomposition_h
+
+
+/**
+********************************************************************************
+*
+*   @file       MPIBlockDecomposition.h
+*
+*   @brief      Decomposition of an image in 2-D blocks over a Cartesian grid
+*               of MPI processes, with a halo around every block for the
+*               filters that read the neighbouring pixels.
+*
+*   @version    1.0
+*
+*   @date       19/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//  Include
+//******************************************************************************
+#include <algorithm> // Header file for min and max
+#include <vector>
+#include <mpi.h> // Header file for MPI
+
+
+//==============================================================================
+/**
+*   @class  MPIBlockDecomposition
+*   @brief  MPIBlockDecomposition splits an image in a grid of blocks, one
+*           per process of an MPI_Cart_create communicator (MPI_Dims_create,
+*           the longest axis of the image gets the most processes). Every
+*           process holds its block in a padded buffer: the block, surrounded
+*           by a halo of aHaloWidth pixels on every side.
+*
+*           The halo is filled by a non-blocking exchange with the eight
+*           neighbours: the rows, the columns (strided) and the corners are
+*           described by MPI_Type_create_subarray, so nothing is copied in
+*           a send buffer. Outside the image, the halo repeats the nearest
+*           pixel of the image. apply() computes the inner pixels of the
+*           block, which do not need the halo, while the halo is exchanged,
+*           then the pixels along the edges.
+*
+*           The rows of an image (e.g. the block of rows of a distributed
+*           MPIImage) are redistributed in the blocks, and back, with a
+*           single MPI_Alltoallw.
+*/
+//==============================================================================
+class MPIBlockDecomposition
+//------------------------------------------------------------------------------
+{
+//******************************************************************************
+public:
+    //--------------------------------------------------------------------------
+    /// Constructor. All the processes of MPI_COMM_WORLD must call it.
+    /**
+    * @param aWidth: the width of the whole image
+    * @param aHeight: the height of the whole image
+    * @param aHaloWidth: the number of pixels of the halo on every side,
+    *        e.g. the radius of a filter. It cannot be larger than the
+    *        smallest block along an axis split between several processes
+    */
+    //--------------------------------------------------------------------------
+    MPIBlockDecomposition(unsigned int aWidth,
+                          unsigned int aHeight,
+                          unsigned int aHaloWidth);
+
+
+    //--------------------------------------------------------------------------
+    /// Destructor, the communicator and the datatypes are freed.
+    //--------------------------------------------------------------------------
+    ~MPIBlockDecomposition();
+
+
+    MPIBlockDecomposition(const MPIBlockDecomposition& aDecomposition) = delete;
+    MPIBlockDecomposition& operator=(const MPIBlockDecomposition& aDecomposition) = delete;
+
+
+    //--------------------------------------------------------------------------
+    /// Cartesian communicator of the blocks. The processes are not
+    /// reordered: the ranks are the ones of MPI_COMM_WORLD.
+    /**
+    * @return the communicator
+    */
+    //--------------------------------------------------------------------------
+    MPI_Comm getCommunicator() const;
+
+
+    //--------------------------------------------------------------------------
+    /// Number of processes along every axis.
+    /**
+    * @param aNumberOfColumns: the number of blocks along the horizontal axis
+    * @param aNumberOfRows: the number of blocks along the vertical axis
+    */
+    //--------------------------------------------------------------------------
+    void getProcessGrid(int& aNumberOfColumns, int& aNumberOfRows) const;
+
+
+    //--------------------------------------------------------------------------
+    /// Position and size of the block of a process in the whole image.
+    /**
+    * @param aRank: the rank of the process
+    * @param aFirstColumn: the first column of the block
+    * @param aFirstRow: the first row of the block
+    * @param aWidth: the number of columns of the block
+    * @param aHeight: the number of rows of the block
+    */
+    //--------------------------------------------------------------------------
+    void getBlock(int aRank,
+                  unsigned int& aFirstColumn,
+                  unsigned int& aFirstRow,
+                  unsigned int& aWidth,
+                  unsigned int& aHeight) const;
+
+
+    //--------------------------------------------------------------------------
+    /// Number of columns of the block of this process.
+    /**
+    * @return the width of the block
+    */
+    //--------------------------------------------------------------------------
+    unsigned int getBlockWidth() const;
+
+
+    //--------------------------------------------------------------------------
+    /// Number of rows of the block of this process.
+    /**
+    * @return the height of the block
+    */
+    //--------------------------------------------------------------------------
+    unsigned int getBlockHeight() const;
+
+
+    //--------------------------------------------------------------------------
+    /// Number of pixels of the halo on every side of the blocks.
+    /**
+    * @return the width of the halo
+    */
+    //--------------------------------------------------------------------------
+    unsigned int getHaloWidth() const;
+
+
+    //--------------------------------------------------------------------------
+    /// Number of columns of the padded buffer: the block and its halo.
+    /**
+    * @return the width of the padded buffer
+    */
+    //--------------------------------------------------------------------------
+    unsigned int getPaddedWidth() const;
+
+
+    //--------------------------------------------------------------------------
+    /// Number of pixels of the padded buffer: the block and its halo.
+    /**
+    * @return the size of the padded buffer
+    */
+    //--------------------------------------------------------------------------
+    unsigned int getPaddedSize() const;
+
+
+    //--------------------------------------------------------------------------
+    /// Copy the block of this process from the whole image, without any
+    /// communication, e.g. from a replicated MPIImage. The halo is not
+    /// filled (see startHaloExchange()).
+    /**
+    * @param apImage: the pixels of the whole image
+    * @param apPaddedBlock: the padded buffer (see getPaddedSize())
+    */
+    //--------------------------------------------------------------------------
+    void copyBlock(const float* apImage, float* apPaddedBlock) const;
+
+
+    //--------------------------------------------------------------------------
+    /// Redistribute the rows of the image in the blocks with MPI_Alltoallw.
+    /// Every process holds a different set of consecutive rows, e.g. the
+    /// block of a distributed MPIImage. All the processes must call it.
+    /// The halo is not filled (see startHaloExchange()).
+    /**
+    * @param apRows: the rows of this process
+    * @param aFirstRow: the index of the first row of this process
+    * @param aNumberOfRows: the number of rows of this process
+    * @param apPaddedBlock: the padded buffer (see getPaddedSize())
+    */
+    //--------------------------------------------------------------------------
+    void rowsToBlock(const float* apRows,
+                     unsigned int aFirstRow,
+                     unsigned int aNumberOfRows,
+                     float* apPaddedBlock) const;
+
+
+    //--------------------------------------------------------------------------
+    /// Redistribute the blocks in rows with MPI_Alltoallw, the opposite of
+    /// rowsToBlock(). All the processes must call it.
+    /**
+    * @param apBlock: the block of this process, without halo
+    *        (getBlockWidth() x getBlockHeight() pixels)
+    * @param apRows: the rows of this process
+    * @param aFirstRow: the index of the first row of this process
+    * @param aNumberOfRows: the number of rows of this process
+    */
+    //--------------------------------------------------------------------------
+    void blockToRows(const float* apBlock,
+                     float* apRows,
+                     unsigned int aFirstRow,
+                     unsigned int aNumberOfRows) const;
+
+
+    //--------------------------------------------------------------------------
+    /// Post the receives and the sends of the halo, then return: the pixels
+    /// of the block that are not sent can be computed in the meantime.
+    /**
+    * @param apPaddedBlock: the padded buffer, its block is up to date
+    */
+    //--------------------------------------------------------------------------
+    void startHaloExchange(float* apPaddedBlock);
+
+
+    //--------------------------------------------------------------------------
+    /// Wait for the halo, then fill the parts of the halo outside the image
+    /// with the nearest pixel of the image.
+    /**
+    * @param apPaddedBlock: the padded buffer given to startHaloExchange()
+    */
+    //--------------------------------------------------------------------------
+    void finishHaloExchange(float* apPaddedBlock);
+
+
+    //--------------------------------------------------------------------------
+    /// Apply a neighbourhood kernel to every pixel of the block. The inner
+    /// pixels are computed during the halo exchange, then the pixels of the
+    /// edges. aKernel(input, stride, output, size) computes size consecutive
+    /// pixels of a row: the pixel (x + dx, y + dy) of the neighbourhood of
+    /// the output pixel x is input[x + dy * stride + dx], for dx and dy
+    /// between -getHaloWidth() and getHaloWidth(). The rows are shared
+    /// between aNumberOfThreads OpenMP threads, MPI is only called outside
+    /// the parallel regions.
+    /**
+    * @param apPaddedBlock: the padded buffer, its block is up to date
+    * @param apBlock: the output block, without halo
+    * @param aKernel: the kernel
+    * @param aNumberOfThreads: the number of threads (default: 1)
+    */
+    //--------------------------------------------------------------------------
+    template<typename NeighbourhoodKernel>
+    void apply(float* apPaddedBlock,
+               float* apBlock,
+               NeighbourhoodKernel aKernel,
+               unsigned int aNumberOfThreads = 1)
+    {
+        unsigned int halo = m_halo_width;
+        unsigned int width = m_block_width;
+        unsigned int height = m_block_height;
+
+        // Output pixel (x, y) of a range of a row
+        auto apply_kernel = [this, apPaddedBlock, apBlock, halo, width, &aKernel](unsigned int x,
+                                                                                unsigned int y,
+                                                                                unsigned int aNumberOfPixels)
+        {
+            if (aNumberOfPixels)
+            {
+                aKernel(apPaddedBlock + (y + halo) * m_padded_width + x + halo,
+                        m_padded_width,
+                        apBlock + y * width + x,
+                        aNumberOfPixels);
+            }
+        };
+
+        // The inner pixels, whose neighbourhood is inside the block
+        unsigned int x_begin = std::min(halo, width);
+        unsigned int x_end = std::max(x_begin, width - x_begin);
+        unsigned int y_begin = std::min(halo, height);
+        unsigned int y_end = std::max(y_begin, height - y_begin);
+
+        startHaloExchange(apPaddedBlock);
+
+#pragma omp parallel for num_threads(aNumberOfThreads) schedule(static)
+        for (unsigned int y = y_begin; y < y_end; ++y)
+        {
+            apply_kernel(x_begin, y, x_end - x_begin);
+        }
+
+        finishHaloExchange(apPaddedBlock);
+
+        // The rows along the top and bottom edges, then the columns along
+        // the left and right edges
+#pragma omp parallel num_threads(aNumberOfThreads)
+        {
+#pragma omp for schedule(static) nowait
+            for (unsigned int y = 0; y < y_begin; ++y)
+            {
+                apply_kernel(0, y, width);
+            }
+
+#pragma omp for schedule(static) nowait
+            for (unsigned int y = y_end; y < height; ++y)
+            {
+                apply_kernel(0, y, width);
+            }
+
+#pragma omp for schedule(static)
+            for (unsigned int y = y_begin; y < y_end; ++y)
+            {
+                apply_kernel(0, y, x_begin);
+                apply_kernel(x_end, y, width - x_end);
+            }
+        }
+    }
+
+
+//******************************************************************************
+private:
+    //--------------------------------------------------------------------------
+    /// Datatypes of MPI_Alltoallw between rows and blocks, one per process,
+    /// MPI_FLOAT if there is nothing to exchange with the process.
+    /**
+    * @param aFirstRow: the index of the first row of this process
+    * @param aNumberOfRows: the number of rows of this process
+    * @param aHaloWidth: the halo around the block of this process, i.e.
+    *        m_halo_width for the padded buffer, 0 for a block without halo
+    * @param aRowTypeSet: for every process, the part of the rows of this
+    *        process in its block
+    * @param aBlockTypeSet: for every process, the part of its rows in the
+    *        block of this process
+    */
+    //--------------------------------------------------------------------------
+    void createRowTypes(unsigned int aFirstRow,
+                        unsigned int aNumberOfRows,
+                        unsigned int aHaloWidth,
+                        std::vector<MPI_Datatype>& aRowTypeSet,
+                        std::vector<MPI_Datatype>& aBlockTypeSet) const;
+
+
+    /// Number of neighbours of a block, including the diagonal ones
+    static const int NUMBER_OF_NEIGHBOURS = 8;
+
+
+    /// The Cartesian communicator
+    MPI_Comm m_communicator;
+
+
+    /// Size of the whole image
+    unsigned int m_width;
+    unsigned int m_height;
+
+
+    /// Number of processes along the horizontal and the vertical axes
+    int m_number_of_columns;
+    int m_number_of_rows;
+
+
+    /// First column, first row and size of the block of every process, in
+    /// rank order
+    std::vector<unsigned int> m_first_column_set;
+    std::vector<unsigned int> m_first_row_set;
+    std::vector<unsigned int> m_width_set;
+    std::vector<unsigned int> m_height_set;
+
+
+    /// Size of the block of this process
+    unsigned int m_block_width;
+    unsigned int m_block_height;
+
+
+    /// Number of pixels of the halo on every side
+    unsigned int m_halo_width;
+
+
+    /// Size of the padded buffer
+    unsigned int m_padded_width;
+    unsigned int m_padded_height;
+
+
+    /// Rank of every neighbour, MPI_PROC_NULL outside the grid
+    int m_p_neighbour_set[NUMBER_OF_NEIGHBOURS];
+
+
+    /// Part of the block sent to every neighbour, in the padded buffer
+    MPI_Datatype m_p_send_type_set[NUMBER_OF_NEIGHBOURS];
+
+
+    /// Part of the halo received from every neighbour
+    MPI_Datatype m_p_receive_type_set[NUMBER_OF_NEIGHBOURS];
+
+
+    /// The requests of the halo exchange in progress
+    std::vector<MPI_Request> m_request_set;
+};
+
+
+#endif
@@ -25,14 +25,33 @@
 //******************************************************************************
 //  Include
 //******************************************************************************
+#include <string>
+#include <vector>
+#include <memory> // Header file for unique_ptr
+#include <mpi.h> // Header file for MPI
+
 #include "Image.h"
+#include "MPISharedBuffer.h"
+#include "ReproducibleAccumulator.h"
 
 
 //==============================================================================
 /**
 *   @class  MPIImage
 *   @brief  MPIImage is a class to manage a greyscale image using MPI
-*           to speedup computations
+*           to speedup computations. An image is either replicated (every
+*           process holds all the pixels) or distributed (every process
+*           holds a block of whole rows, see DistributionMode). The width
+*           and the height are the ones of the whole image in both cases.
+*           The filters of a distributed image give a distributed image and
+*           its statistics are reduced with MPI_Allreduce, so a chain of
+*           filters exchanges no pixel: the blocks are gathered only by
+*           gatherImage() and the save methods. A shared image is held once
+*           per node, in a buffer shared by the processes of the node (see
+*           MPISharedBuffer).
+*
+*           Every process uses a single thread; MPIOpenMPImage shares the
+*           part of every process between OpenMP threads.
 */
 //==============================================================================
 class MPIImage: public Image
@@ -40,6 +59,276 @@ class MPIImage: public Image
 {
 //******************************************************************************
 public:
+    /// How the filters assemble the sub-images of the processes
+    enum GatherMode
+    {
+        /// Every process sends the first and the last index of its
+        /// sub-image, then its pixels, to the master, which receives them
+        /// in rank order: three blocking messages per process
+        POINT_TO_POINT_GATHER,
+
+        /// A single MPI_Gatherv, only the master has the whole image. The
+        /// other processes have only their part: a filter or a statistic
+        /// that reads the other parts of the output, e.g. a flip after a
+        /// pixel filter, first broadcasts the image from the master, as
+        /// ALLGATHERV would have given it. The same for
+        /// POINT_TO_POINT_GATHER and PIPELINED
+        GATHERV,
+
+        /// A single MPI_Allgatherv, every process has the whole image
+        ALLGATHERV,
+
+        /// Every process computes its sub-image chunk by chunk (see
+        /// setChunkSize()) and sends every chunk with MPI_Isend as soon as
+        /// it is computed. The master posts all the receives first, computes
+        /// its own chunks, then drains the completions with MPI_Waitsome, so
+        /// the transfers overlap the computation. As with GATHERV, only the
+        /// master has the whole image
+        PIPELINED,
+
+        /// The sub-images are not fixed: the image is cut in tiles of
+        /// setChunkSize() pixels, every process starts with the tile of its
+        /// rank, then takes the next free tile from a counter held by the
+        /// master (MPI_Fetch_and_op), until there is none left. Every tile
+        /// is sent to the master with its index as tag, and the master
+        /// computes tiles too. A process that computes faster, e.g. on a
+        /// faster or less busy core, computes more tiles. The tiles of a
+        /// process may be anywhere in the image, so the master then
+        /// broadcasts the whole image: as with ALLGATHERV, every process
+        /// has it, e.g. for the next filter of a chain
+        DYNAMIC
+    };
+
+
+    /// How the images are loaded
+    enum DistributionMode
+    {
+        /// Every process loads the whole image, the filters assemble the
+        /// whole output (see GatherMode)
+        REPLICATED,
+
+        /// The master loads the image and scatters blocks of rows with
+        /// MPI_Scatterv: every process holds only its block, the filters
+        /// process it and give a distributed output
+        SCATTERED,
+
+        /// The whole image is held once per node, in memory shared by the
+        /// processes of the node (MPI_Win_allocate_shared, see
+        /// MPINodeTopology). The master loads the image and broadcasts it
+        /// to the other node leaders only. Every process of a node writes
+        /// its part of the output directly in the shared output, then the
+        /// node leaders exchange the parts of their nodes with
+        /// MPI_Allgatherv: every node has the whole output, the gather mode
+        /// is not used
+        SHARED
+    };
+
+
+    /// How the collectives of the filters and of the statistics are done
+    enum CollectiveMode
+    {
+        /// One collective over MPI_COMM_WORLD, e.g. MPI_Gatherv: the
+        /// master exchanges one message with every process
+        FLAT,
+
+        /// In two steps (see MPINodeTopology): in every node, then between
+        /// the node leaders. The sub-images of GATHERV, ALLGATHERV and
+        /// DYNAMIC, and the blocks of a distributed image, reach the master
+        /// in one message per node, and the reductions of the statistics
+        /// cross the network once per node. The floating-point sums of
+        /// FAST_SUMMATION may differ in the last bits from FLAT, as the
+        /// partial sums are added in another order
+        HIERARCHICAL
+    };
+
+
+    //--------------------------------------------------------------------------
+    /// Set the gather mode of all the images (default: GATHERV).
+    /**
+    * @param aMode: the gather mode
+    */
+    //--------------------------------------------------------------------------
+    static void setGatherMode(GatherMode aMode);
+
+
+    //--------------------------------------------------------------------------
+    /// Get the gather mode of all the images.
+    /**
+    * @return the gather mode
+    */
+    //--------------------------------------------------------------------------
+    static GatherMode getGatherMode();
+
+
+    //--------------------------------------------------------------------------
+    /// Gather mode from its name.
+    /**
+    * @param aName: "p2p", "gatherv", "allgatherv", "pipelined" or "dynamic"
+    *        (the case does not matter)
+    * @return the gather mode
+    */
+    //--------------------------------------------------------------------------
+    static GatherMode getGatherMode(const std::string& aName);
+
+
+    //--------------------------------------------------------------------------
+    /// Name of a gather mode.
+    /**
+    * @param aMode: the gather mode
+    * @return "p2p", "gatherv", "allgatherv", "pipelined" or "dynamic"
+    */
+    //--------------------------------------------------------------------------
+    static std::string getGatherModeName(GatherMode aMode);
+
+
+    //--------------------------------------------------------------------------
+    /// Set the number of pixels of the chunks sent by PIPELINED and of the
+    /// tiles of DYNAMIC (default: 65536). The chunks of the flips are whole
+    /// rows, at least one.
+    /**
+    * @param aNumberOfPixels: the number of pixels of a chunk
+    */
+    //--------------------------------------------------------------------------
+    static void setChunkSize(unsigned int aNumberOfPixels);
+
+
+    //--------------------------------------------------------------------------
+    /// Get the number of pixels of the chunks sent by PIPELINED and of the
+    /// tiles of DYNAMIC.
+    /**
+    * @return the number of pixels of a chunk
+    */
+    //--------------------------------------------------------------------------
+    static unsigned int getChunkSize();
+
+
+    //--------------------------------------------------------------------------
+    /// Time spent by all the processes in the filters of the replicated
+    /// images since the last call to resetGatherTimes(): computing their
+    /// sub-images, and assembling them without computing, e.g. in MPI_Gatherv
+    /// or in MPI_Waitsome. All the processes must call this method.
+    /**
+    * @param aComputeTime: the sum of the compute times, in seconds
+    * @param aWaitTime: the sum of the times spent only assembling, in seconds
+    */
+    //--------------------------------------------------------------------------
+    static void getGatherTimes(double& aComputeTime, double& aWaitTime);
+
+
+    //--------------------------------------------------------------------------
+    /// Overlap efficiency of the filters: the fraction of their time spent
+    /// computing, aComputeTime / (aComputeTime + aWaitTime) (see
+    /// getGatherTimes()). It is 1 if the transfers are completely hidden.
+    /// All the processes must call this method.
+    /**
+    * @return the overlap efficiency, between 0 and 1
+    */
+    //--------------------------------------------------------------------------
+    static double getOverlapEfficiency();
+
+
+    //--------------------------------------------------------------------------
+    /// Work of every process in the filters of the replicated images since
+    /// the last call to resetGatherTimes(): the number of pixels it has
+    /// computed, and its idle time, i.e. the time it has spent only
+    /// assembling or waiting for a tile (see getGatherTimes()). All the
+    /// processes must call this method.
+    /**
+    * @param aNumberOfPixelsSet: the number of pixels of every process, in
+    *        rank order, on the master (empty on the other processes)
+    * @param anIdleTimeSet: the idle time of every process, in seconds, on
+    *        the master (empty on the other processes)
+    */
+    //--------------------------------------------------------------------------
+    static void getWorkDistribution(std::vector<unsigned long long>& aNumberOfPixelsSet,
+                                    std::vector<double>& anIdleTimeSet);
+
+
+    //--------------------------------------------------------------------------
+    /// Reset the times given by getGatherTimes() and the numbers of pixels
+    /// given by getWorkDistribution() on this process.
+    //--------------------------------------------------------------------------
+    static void resetGatherTimes();
+
+
+    //--------------------------------------------------------------------------
+    /// Set the distribution mode of the images loaded from now on
+    /// (default: REPLICATED).
+    /**
+    * @param aMode: the distribution mode
+    */
+    //--------------------------------------------------------------------------
+    static void setDistributionMode(DistributionMode aMode);
+
+
+    //--------------------------------------------------------------------------
+    /// Get the distribution mode of the images loaded from now on.
+    /**
+    * @return the distribution mode
+    */
+    //--------------------------------------------------------------------------
+    static DistributionMode getDistributionMode();
+
+
+    //--------------------------------------------------------------------------
+    /// Distribution mode from its name.
+    /**
+    * @param aName: "replicated", "scattered" or "shared" (the case does not
+    *        matter)
+    * @return the distribution mode
+    */
+    //--------------------------------------------------------------------------
+    static DistributionMode getDistributionMode(const std::string& aName);
+
+
+    //--------------------------------------------------------------------------
+    /// Name of a distribution mode.
+    /**
+    * @param aMode: the distribution mode
+    * @return "replicated", "scattered" or "shared"
+    */
+    //--------------------------------------------------------------------------
+    static std::string getDistributionModeName(DistributionMode aMode);
+
+
+    //--------------------------------------------------------------------------
+    /// Set the collective mode of all the images (default: FLAT).
+    /**
+    * @param aMode: the collective mode
+    */
+    //--------------------------------------------------------------------------
+    static void setCollectiveMode(CollectiveMode aMode);
+
+
+    //--------------------------------------------------------------------------
+    /// Get the collective mode of all the images.
+    /**
+    * @return the collective mode
+    */
+    //--------------------------------------------------------------------------
+    static CollectiveMode getCollectiveMode();
+
+
+    //--------------------------------------------------------------------------
+    /// Collective mode from its name.
+    /**
+    * @param aName: "flat" or "hierarchical" (the case does not matter)
+    * @return the collective mode
+    */
+    //--------------------------------------------------------------------------
+    static CollectiveMode getCollectiveMode(const std::string& aName);
+
+
+    //--------------------------------------------------------------------------
+    /// Name of a collective mode.
+    /**
+    * @param aMode: the collective mode
+    * @return "flat" or "hierarchical"
+    */
+    //--------------------------------------------------------------------------
+    static std::string getCollectiveModeName(CollectiveMode aMode);
+
+
     //--------------------------------------------------------------------------
     /// Default constructor.
     //--------------------------------------------------------------------------
@@ -55,6 +344,16 @@ public:
     MPIImage(const Image& anImage);
 
 
+    //------------------------------------------------------------------------
+    /// Copy constructor. A shared image is copied in a new buffer, all the
+    /// processes must call it.
+    /**
+    * @param anImage: the image to copy
+    */
+    //------------------------------------------------------------------------
+    MPIImage(const MPIImage& anImage);
+
+
     //------------------------------------------------------------------------
     /// Constructor from an array.
     /**
@@ -80,6 +379,50 @@ public:
                 float aDefaultValue = 0.0);
 
 
+    //------------------------------------------------------------------------
+    /// Constructor to build an image whose pixels are not initialised
+    /// (see Image::NO_INIT).
+    /**
+    * @param aWidth: the width of the image
+    * @param aHeight: the height of the image
+    * @param aTag: NO_INIT
+    */
+    //------------------------------------------------------------------------
+    MPIImage(unsigned int aWidth,
+             unsigned int aHeight,
+             NoInit aTag);
+
+
+    //------------------------------------------------------------------------
+    /// Assignment operator. A shared image is copied in a shared buffer,
+    /// all the processes must call it.
+    /**
+    * @param anImage: the image to copy
+    * @return the updated version of the current image
+    */
+    //------------------------------------------------------------------------
+    MPIImage& operator=(const MPIImage& anImage);
+
+
+    //------------------------------------------------------------------------
+    /// Load an image from a PGM file. With SCATTERED or SHARED, only the
+    /// master reads the file (see DistributionMode).
+    /**
+    * @param aFileName: the name of the file to load
+    */
+    //------------------------------------------------------------------------
+    void loadPGM(const char* aFileName);
+
+
+    //------------------------------------------------------------------------
+    /// Load an image from a PGM file (see loadPGM(const char*)).
+    /**
+    * @param aFileName: the name of the file to load
+    */
+    //------------------------------------------------------------------------
+    void loadPGM(const std::string& aFileName);
+
+
     //------------------------------------------------------------------------
     /// Save the image in a PGM file
     /**
@@ -89,6 +432,34 @@ public:
     void savePGM(const char* aFileName);
 
 
+    //------------------------------------------------------------------------
+    /// Save the image in a PGM file
+    /**
+    * @param aFileName: the name of the file to write
+    */
+    //------------------------------------------------------------------------
+    void savePGM(const std::string& aFileName);
+
+
+    //------------------------------------------------------------------------
+    /// Load an image from an ASCII file. With SCATTERED or SHARED, only the
+    /// master reads the file (see DistributionMode).
+    /**
+    * @param aFileName: the name of the file to load
+    */
+    //------------------------------------------------------------------------
+    void loadASCII(const char* aFileName);
+
+
+    //------------------------------------------------------------------------
+    /// Load an image from an ASCII file (see loadASCII(const char*)).
+    /**
+    * @param aFileName: the name of the file to load
+    */
+    //------------------------------------------------------------------------
+    void loadASCII(const std::string& aFileName);
+
+
     //------------------------------------------------------------------------
     /// Save the image in an ASCII file
     /**
@@ -98,6 +469,205 @@ public:
     void saveASCII(const char* aFileName);
 
 
+    //------------------------------------------------------------------------
+    /// Save the image in an ASCII file
+    /**
+    * @param aFileName: the name of the file to write
+    */
+    //------------------------------------------------------------------------
+    void saveASCII(const std::string& aFileName);
+
+
+    //------------------------------------------------------------------------
+    /// Check if every process holds only a block of rows.
+    /**
+    * @return true if the image is distributed, false if it is replicated
+    */
+    //------------------------------------------------------------------------
+    bool isDistributed() const;
+
+
+    //------------------------------------------------------------------------
+    /// Check if the image is held once per node (see SHARED). A shared
+    /// image is not distributed: every process can read all the pixels.
+    /**
+    * @return true if the image is in a buffer shared by the processes of
+    *         the node
+    */
+    //------------------------------------------------------------------------
+    bool isShared() const;
+
+
+    //------------------------------------------------------------------------
+    /// First row of the block of this process (0 if the image is
+    /// replicated).
+    /**
+    * @return the index of the row
+    */
+    //------------------------------------------------------------------------
+    unsigned int getFirstRow() const;
+
+
+    //------------------------------------------------------------------------
+    /// Number of rows of the block of this process (the height if the
+    /// image is replicated).
+    /**
+    * @return the number of rows
+    */
+    //------------------------------------------------------------------------
+    unsigned int getNumberOfRows() const;
+
+
+    //------------------------------------------------------------------------
+    /// Assemble the whole image on the master, e.g. to save it. The blocks
+    /// of a distributed image are gathered with MPI_Gatherv; a replicated
+    /// image is copied as it is, a shared image is copied by the master.
+    /**
+    * @param anImage: the whole image on the master (the other processes
+    *        get a copy of their replicated image, or nothing)
+    */
+    //------------------------------------------------------------------------
+    void gatherImage(Image& anImage) const;
+
+
+    //------------------------------------------------------------------------
+    /// Compute the minimum pixel value in the image
+    /**
+    * @return the minimum pixel
+    */
+    //------------------------------------------------------------------------
+    float getMinValue() const;
+
+
+    //------------------------------------------------------------------------
+    /// Compute the maximum pixel value in the image
+    /**
+    * @return the maximum pixel
+    */
+    //------------------------------------------------------------------------
+    float getMaxValue() const;
+
+
+    //------------------------------------------------------------------------
+    /// Compute the minimum and the maximum pixel values in one pass. Every
+    /// process scans its part, the partial results are combined with a
+    /// single MPI_Allreduce.
+    /**
+    * @param aMinValue: the minimum pixel
+    * @param aMaxValue: the maximum pixel
+    */
+    //------------------------------------------------------------------------
+    void getMinMaxValues(float& aMinValue, float& aMaxValue) const;
+
+
+    //------------------------------------------------------------------------
+    /// Compute the sum of all the pixel values of the image. Every process
+    /// adds its part, the partial sums are combined with MPI_Allreduce.
+    /**
+    * @return the sum of all the pixel values of the image
+    */
+    //------------------------------------------------------------------------
+    float getSum() const;
+
+
+    //------------------------------------------------------------------------
+    /// Compute the average value of all the pixels of the image
+    /**
+    * @return the average value of all the pixels of the image
+    */
+    //------------------------------------------------------------------------
+    float getAverage() const;
+
+
+    //------------------------------------------------------------------------
+    /// Compute the average value of all the pixels of the image
+    /**
+    * @return the average value of all the pixels of the image
+    */
+    //------------------------------------------------------------------------
+    float getMean() const;
+
+
+    //------------------------------------------------------------------------
+    /// Compute the variance of the pixel values of the image. With
+    /// FAST_SUMMATION, it takes a single MPI_Allreduce (see
+    /// getStatistics()).
+    /**
+    * @return the variance of the pixel values of the image
+    */
+    //------------------------------------------------------------------------
+    float getVariance() const;
+
+
+    //------------------------------------------------------------------------
+    /// Compute the standard deviation of the pixel values of the image
+    /**
+    * @return the standard deviation of the pixel values of the image
+    */
+    //------------------------------------------------------------------------
+    float getStdDev() const;
+
+
+    //------------------------------------------------------------------------
+    /// Compute the minimum, the maximum, the average and the variance of
+    /// the pixel values at once. Every process computes them for its part,
+    /// then the partial results are combined by a single MPI_Allreduce,
+    /// with a user-defined operation that merges the counts, the means and
+    /// the sums of squared differences (M2) pairwise (Chan et al.).
+    /**
+    * @param aMinValue: the minimum pixel
+    * @param aMaxValue: the maximum pixel
+    * @param anAverage: the average value of the pixels
+    * @param aVariance: the variance of the pixel values
+    */
+    //------------------------------------------------------------------------
+    void getStatistics(float& aMinValue,
+                       float& aMaxValue,
+                       float& anAverage,
+                       float& aVariance) const;
+
+
+    //------------------------------------------------------------------------
+    /// Compare with an image of the same size, pixel by pixel, and stop at
+    /// the first pixel that differs by more than aTolerance (or is NaN).
+    /// Every process searches its part, the results are combined with
+    /// MPI_Allreduce.
+    /**
+    * @param anImage: the image to compare with
+    * @param aTolerance: the largest difference between similar pixels
+    * @param aMaxDifference: the largest difference of the pixels up to the
+    *        first mismatch (included)
+    * @return the index of the first mismatch, or the number of pixels if
+    *         the images are similar
+    */
+    //------------------------------------------------------------------------
+    unsigned int findFirstMismatch(const Image& anImage,
+                                   float aTolerance,
+                                   float& aMaxDifference) const;
+
+
+    //------------------------------------------------------------------------
+    /// Operator Equal to
+    /**
+    * @param anImage: the image to compare with
+    * @return true if the images are similar,
+    *         false if they are different
+    */
+    //------------------------------------------------------------------------
+    bool operator==(const Image& anImage) const;
+
+
+    //------------------------------------------------------------------------
+    /// Operator Not equal to
+    /**
+    * @param anImage: the image to compare with
+    * @return true if the images are different,
+    *         false if they are similar
+    */
+    //------------------------------------------------------------------------
+    bool operator!=(const Image& anImage) const;
+
+
     //------------------------------------------------------------------------
     /// Negation operator. Compute the negative of the current image.
     /**
@@ -119,6 +689,25 @@ public:
     MPIImage shiftScaleFilter(float aShiftValue, float aScaleValue) const;
 
 
+    //------------------------------------------------------------------------
+    /// Normalise the image between 0 and 1. The range is computed with a
+    /// single MPI_Allreduce (see getMinMaxValues()).
+    /**
+    * @return the new image
+    */
+    //------------------------------------------------------------------------
+    MPIImage getNormalised() const;
+
+
+    //------------------------------------------------------------------------
+    /// Normalize the image between 0 and 1 (see getNormalised()).
+    /**
+    * @return the new image
+    */
+    //------------------------------------------------------------------------
+    MPIImage getNormalized() const;
+
+
     //------------------------------------------------------------------------
     /// Apply a log filter on the image
     /**
@@ -128,6 +717,52 @@ public:
     MPIImage logFilter() const;
 
 
+    //------------------------------------------------------------------------
+    /// Apply a point function on the image (see Image::applyPointFunction())
+    /**
+    * @param aFunction: the function
+    * @param aParameter: the parameter of the function, if any
+    * @return the new image
+    */
+    //------------------------------------------------------------------------
+    MPIImage applyPointFunction(PointFunction aFunction, float aParameter = 1.0) const;
+
+
+    //------------------------------------------------------------------------
+    /// Apply a lookup table on the image, e.g. a chain of point operators
+    /// on an 8-bit image (see PointLUT)
+    /**
+    * @param aLUT: the lookup table
+    * @return the new image
+    */
+    //------------------------------------------------------------------------
+    MPIImage applyLUT(const PointLUT& aLUT) const;
+
+
+    //------------------------------------------------------------------------
+    /// Create the lookup table of the image (see PointLUT(const Image&)).
+    /// Every process records the values of its pixels, the records are
+    /// combined with MPI_Allreduce.
+    /**
+    * @return the identity table of the image
+    */
+    //------------------------------------------------------------------------
+    PointLUT createLUT() const;
+
+
+    //------------------------------------------------------------------------
+    /// Apply a box filter on the image: every pixel is replaced by the
+    /// average of the (2 aRadius + 1) x (2 aRadius + 1) pixels around it,
+    /// the pixels outside the image are the nearest ones of the image. The
+    /// image is split in 2-D blocks (see MPIBlockDecomposition).
+    /**
+    * @param aRadius: the radius of the neighbourhood, in pixels
+    * @return the new image
+    */
+    //------------------------------------------------------------------------
+    MPIImage boxFilter(unsigned int aRadius) const;
+
+
     //------------------------------------------------------------------------
     /// Flip the image horizonatally
     /**
@@ -146,6 +781,28 @@ public:
     MPIImage flipVertically() const;
 
 
+    //------------------------------------------------------------------------
+    /// Flip the image horizontally, in place. Every process reverses the
+    /// rows of its block if the image is distributed, its part of the rows
+    /// if it is shared, all the rows otherwise.
+    /**
+    * @return the updated version of the current image
+    */
+    //------------------------------------------------------------------------
+    MPIImage& flipHorizontallyInPlace();
+
+
+    //------------------------------------------------------------------------
+    /// Flip the image vertically, in place. The block of a distributed
+    /// image becomes the mirrored block, as with flipVertically(). A
+    /// shared image is flipped in a new buffer.
+    /**
+    * @return the updated version of the current image
+    */
+    //------------------------------------------------------------------------
+    MPIImage& flipVerticallyInPlace();
+
+
     static const int ROOT = 0;
 
 
@@ -156,6 +813,200 @@ protected:
             unsigned int& aEndID) const;
 
     void checkMPIError(int errorCode) const;
+
+    /// Number of elements and index of the first element of every process,
+    /// in the same order as workload(), multiplied by anElementSize, e.g.
+    /// the counts and the displacements of MPI_Gatherv
+    void getWorkloads(unsigned int aNumberOfElements,
+            unsigned int anElementSize,
+            std::vector<int>& aCountSet,
+            std::vector<int>& aDisplacementSet) const;
+
+    /// Assemble the sub-images of the processes (see workload()) in
+    /// anImage with the gather mode (see GatherMode). An element is
+    /// anElementSize pixels, e.g. 1 for a pixel, the width for a row.
+    void gather(MPIImage& anImage,
+            unsigned int aNumberOfElements,
+            unsigned int anElementSize) const;
+
+    /// Pixels processed by this process: its part of the workload (see
+    /// workload(), getWorkloadID()) if the image is replicated or shared,
+    /// its whole block if it is distributed
+    void getLocalPixels(unsigned int& aStartID,
+            unsigned int& aNumberOfPixels) const;
+
+    /// Sum of the partial sums of all the processes (FAST_SUMMATION)
+    float allReduceSum(float aPartialSum) const;
+
+    /// Sum of the partial sums of all the processes (REPRODUCIBLE_SUMMATION)
+    float allReduceSum(const ReproducibleAccumulator& aPartialSum) const;
+
+    /// Index of this process in the workloads (see getWorkloads()): its
+    /// rank, or its index node by node if the image is shared (see
+    /// MPINodeTopology::getProcessIndex()), so that the parts of the
+    /// processes of a node are consecutive
+    int getWorkloadID() const;
+
+    /// True if this process has the pixels of its part of the workload
+    /// for elements of anElementSize pixels (see gather()), e.g. 1 for the
+    /// point operators and the statistics, the width for the rows, 0 if
+    /// the whole image is needed. Always true if every process has the
+    /// whole image, or its block, or the buffer of its node
+    bool hasLocalPart(unsigned int anElementSize) const;
+
+    /// Copy of the image in which every process has the whole image: the
+    /// master broadcasts its pixels (see broadcast()). All the processes
+    /// must call it, e.g. when hasLocalPart() is false
+    MPIImage getWholeImage() const;
+
+    /// Exchange the pixels and the distribution of two images, but not
+    /// their number of threads, e.g. to return the output of a filter of
+    /// MPIImage as an image of a derived class without copying it
+    void swapImage(MPIImage& anImage);
+
+
+    /// Number of OpenMP threads of every process, 1 for MPIImage
+    unsigned int m_thread_number;
+
+
+//******************************************************************************
+private:
+    /// Constructor of an image distributed as anImage (the same rows on
+    /// every process), whose pixels are not initialised, e.g. the output
+    /// of a filter
+    MPIImage(const MPIImage& anImage, NoInit aTag);
+
+    /// The pixels of this process: the shared buffer of its node if the
+    /// image is shared, its own pixels otherwise
+    float* getData();
+    const float* getData() const;
+
+    /// Copy the pixels and the distribution of anImage, in a shared buffer
+    /// if anImage is shared (see MPIImage(const MPIImage&))
+    void copyImage(const MPIImage& anImage);
+
+    /// Exchange the parts of the nodes of a shared image: the node leaders
+    /// send the parts of the processes of their node (see getWorkloadID())
+    /// to the other leaders with MPI_Allgatherv. All the processes must
+    /// call it once they have written their part, as in gather()
+    void exchangeNodeParts(unsigned int aNumberOfElements,
+            unsigned int anElementSize);
+
+    /// Load the image with aLoadFunction(Image&): by every process, or by
+    /// the master only, then its rows are scattered or it is broadcast to
+    /// the node leaders (see DistributionMode)
+    template<typename LoadFunction>
+    void load(LoadFunction aLoadFunction);
+
+    /// Apply a point operator, anOperation(input, output, size), to the
+    /// pixels of this process, then assemble the output if the image is
+    /// replicated
+    template<typename BlockOperation>
+    MPIImage applyPointOperator(BlockOperation anOperation) const;
+
+    /// Apply a neighbourhood operator, anOperation(input, stride, output,
+    /// size) (see MPIBlockDecomposition::apply()), to the 2-D block of this
+    /// process, whose halo is aRadius pixels wide. The output has the same
+    /// distribution as the image: the blocks are redistributed in the rows
+    /// of a distributed image, or in the part of every process of a
+    /// replicated image, then assembled
+    template<typename NeighbourhoodOperation>
+    MPIImage applyNeighbourhoodOperator(unsigned int aRadius,
+            NeighbourhoodOperation anOperation) const;
+
+    /// Compute the sub-image of this process in anImage with
+    /// anOperation(first element, number of elements), then assemble the
+    /// sub-images with the gather mode, chunk by chunk with PIPELINED, tile
+    /// by tile with DYNAMIC. An element is anElementSize pixels, as in
+    /// gather()
+    template<typename ChunkOperation>
+    void computeAndGather(MPIImage& anImage,
+            unsigned int aNumberOfElements,
+            unsigned int anElementSize,
+            ChunkOperation anOperation) const;
+
+    /// Compute the tiles of anImage taken from a counter held by the master,
+    /// send them to the master, then broadcast the whole image (see DYNAMIC)
+    template<typename ChunkOperation>
+    void computeTiles(MPIImage& anImage,
+            unsigned int aNumberOfElements,
+            unsigned int anElementSize,
+            ChunkOperation anOperation) const;
+
+    /// Gather the blocks of a distributed image in apImage on the master
+    void gatherRows(float* apImage) const;
+
+    /// MPI_Allreduce over all the processes, in two steps with HIERARCHICAL
+    /// (see CollectiveMode). The operation must be commutative
+    void allReduce(const void* apInput,
+            void* apOutput,
+            int aCount,
+            MPI_Datatype aType,
+            MPI_Op anOperation) const;
+
+    /// MPI_Bcast of aCount pixels from the master to all the processes, in
+    /// two steps with HIERARCHICAL (see CollectiveMode)
+    void broadcast(float* apData, unsigned int aCount) const;
+
+    /// Share the elements [aStartID, aStartID + aNumberOfElements) between
+    /// the threads (see m_thread_number): anOperation(first element, number
+    /// of elements) is called once per thread, on consecutive elements
+    template<typename TaskOperation>
+    void forEachTask(unsigned int aStartID,
+            unsigned int aNumberOfElements,
+            TaskOperation anOperation) const;
+
+
+    /// The gather mode of all the images
+    static GatherMode m_gather_mode;
+
+
+    /// The number of pixels of the chunks sent by PIPELINED and of the tiles
+    /// of DYNAMIC
+    static unsigned int m_chunk_size;
+
+
+    /// Time spent by this process computing in computeAndGather()
+    static double m_compute_time;
+
+
+    /// Time spent by this process only assembling in computeAndGather()
+    static double m_wait_time;
+
+
+    /// Number of pixels computed by this process in computeAndGather()
+    static unsigned long long m_number_of_computed_pixels;
+
+
+    /// The distribution mode of the images loaded from now on
+    static DistributionMode m_distribution_mode;
+
+
+    /// The collective mode of all the images
+    static CollectiveMode m_collective_mode;
+
+
+    /// True if every process holds only a block of rows
+    bool m_is_distributed;
+
+
+    /// First row of the block of this process
+    unsigned int m_first_row;
+
+
+    /// Number of rows of the block of this process
+    unsigned int m_number_of_rows;
+
+
+    /// 0 if every process has the whole image (or its block, or the
+    /// buffer of its node). Otherwise only the master has it, e.g. after
+    /// GATHERV, and every other process has only its part of the workload
+    /// for elements of m_part_element_size pixels (see gather())
+    unsigned int m_part_element_size;
+
+
+    /// The buffer of the node if the image is shared, m_p_image is empty
+    std::unique_ptr<MPISharedBuffer> m_p_shared_buffer;
 };
 
 
@@ -0,0 +1,258 @@
+#ifndef __MPINodeTopology_h
+#define __MPINodeTopology_h
+
+
+/**
+********************************************************************************
+*
+*   @file       MPINodeTopology.h
+*
+*   @brief      Class to group the MPI processes by node: a communicator per
+*               node, a communicator of the node leaders, and hierarchical
+*               collectives over them.
+*
+*   @version    1.0
+*
+*   @date       19/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//  Include
+//******************************************************************************
+#include <vector>
+#include <mpi.h> // Header file for MPI
+
+
+//==============================================================================
+/**
+*   @class  MPINodeTopology
+*   @brief  MPINodeTopology splits MPI_COMM_WORLD in one communicator per
+*           node (MPI_Comm_split_type with MPI_COMM_TYPE_SHARED: the
+*           processes that can share memory). The first process of every
+*           node, in rank order, is its leader; the leaders have their own
+*           communicator. The master (rank 0) is the leader of the node 0.
+*
+*           The processes are also numbered node by node (see
+*           getProcessIndex()), so that the work given to the processes of a
+*           node in this order is a single range, e.g. a block of rows.
+*
+*           gatherv(), broadcast() and allReduce() are collectives over
+*           MPI_COMM_WORLD done in two steps, first in every node then
+*           between the leaders, so that the master exchanges one message
+*           per node rather than one per process, and most of the traffic
+*           stays in the nodes.
+*
+*           The communicators are created by the first call to
+*           getInstance(), which all the processes must make, and freed by
+*           MPI_Finalize().
+*/
+//==============================================================================
+class MPINodeTopology
+//------------------------------------------------------------------------------
+{
+//******************************************************************************
+public:
+    //--------------------------------------------------------------------------
+    /// Topology of the processes, discovered once. All the processes must
+    /// call it the first time.
+    /**
+    * @return the topology
+    */
+    //--------------------------------------------------------------------------
+    static const MPINodeTopology& getInstance();
+
+
+    //--------------------------------------------------------------------------
+    /// Communicator of the processes of the node of this process.
+    /**
+    * @return the communicator
+    */
+    //--------------------------------------------------------------------------
+    MPI_Comm getNodeCommunicator() const;
+
+
+    //--------------------------------------------------------------------------
+    /// Communicator of the node leaders, the rank of a leader is the index
+    /// of its node.
+    /**
+    * @return the communicator, MPI_COMM_NULL if this process is not a leader
+    */
+    //--------------------------------------------------------------------------
+    MPI_Comm getLeaderCommunicator() const;
+
+
+    //--------------------------------------------------------------------------
+    /// Check if this process is the leader of its node.
+    /**
+    * @return true if its rank in the node is 0
+    */
+    //--------------------------------------------------------------------------
+    bool isLeader() const;
+
+
+    //--------------------------------------------------------------------------
+    /// Number of nodes.
+    /**
+    * @return the number of nodes
+    */
+    //--------------------------------------------------------------------------
+    int getNumberOfNodes() const;
+
+
+    //--------------------------------------------------------------------------
+    /// Index of the node of this process.
+    /**
+    * @return the index of the node, between 0 and getNumberOfNodes() - 1
+    */
+    //--------------------------------------------------------------------------
+    int getNodeID() const;
+
+
+    //--------------------------------------------------------------------------
+    /// Rank of this process in its node.
+    /**
+    * @return the rank in the node communicator
+    */
+    //--------------------------------------------------------------------------
+    int getNodeRank() const;
+
+
+    //--------------------------------------------------------------------------
+    /// Number of processes of the node of this process.
+    /**
+    * @return the size of the node communicator
+    */
+    //--------------------------------------------------------------------------
+    int getNodeSize() const;
+
+
+    //--------------------------------------------------------------------------
+    /// Index of this process when the processes are numbered node by node:
+    /// the processes of the node i come after the ones of the nodes 0 to
+    /// i - 1, in the order of their rank in the node.
+    /**
+    * @return the index of the process
+    */
+    //--------------------------------------------------------------------------
+    int getProcessIndex() const;
+
+
+    //--------------------------------------------------------------------------
+    /// Processes of a node, numbered as by getProcessIndex().
+    /**
+    * @param aNodeID: the index of the node
+    * @param aFirstProcessIndex: the index of its first process
+    * @param aNumberOfProcesses: its number of processes
+    */
+    //--------------------------------------------------------------------------
+    void getNodeProcesses(int aNodeID,
+                          int& aFirstProcessIndex,
+                          int& aNumberOfProcesses) const;
+
+
+    //--------------------------------------------------------------------------
+    /// Rank in MPI_COMM_WORLD of a process.
+    /**
+    * @param aProcessIndex: the index of the process (see getProcessIndex())
+    * @return its rank
+    */
+    //--------------------------------------------------------------------------
+    int getRank(int aProcessIndex) const;
+
+
+    //--------------------------------------------------------------------------
+    /// Hierarchical MPI_Gatherv of floats to the master (rank 0): every
+    /// leader gathers the arrays of its node, then sends them to the master
+    /// in a single message, received in place with an indexed datatype.
+    /// All the processes must call it.
+    /**
+    * @param apSendBuffer: the array of this process, it may already be in
+    *                      place in apReceiveBuffer on the master
+    * @param aSendCount: its number of elements
+    * @param apReceiveBuffer: the output, only used on the master
+    * @param apCountSet: the number of elements of every process, in rank
+    *                    order, only used on the master
+    * @param apDisplacementSet: the position of the array of every process in
+    *                           apReceiveBuffer, in rank order, only used on
+    *                           the master
+    */
+    //--------------------------------------------------------------------------
+    void gatherv(const float* apSendBuffer,
+                 int aSendCount,
+                 float* apReceiveBuffer,
+                 const int* apCountSet,
+                 const int* apDisplacementSet) const;
+
+
+    //--------------------------------------------------------------------------
+    /// Hierarchical MPI_Bcast of floats from the master (rank 0): to the
+    /// leaders, then in every node. All the processes must call it.
+    /**
+    * @param apData: the array
+    * @param aCount: its number of elements
+    */
+    //--------------------------------------------------------------------------
+    void broadcast(float* apData, int aCount) const;
+
+
+    //--------------------------------------------------------------------------
+    /// Hierarchical MPI_Allreduce: MPI_Reduce in every node to its leader,
+    /// MPI_Allreduce between the leaders, then MPI_Bcast in every node. The
+    /// operation must be commutative. All the processes must call it.
+    /**
+    * @param apInput: the input, or MPI_IN_PLACE
+    * @param apOutput: the output
+    * @param aCount: the number of elements
+    * @param aType: their type
+    * @param anOperation: the reduction
+    */
+    //--------------------------------------------------------------------------
+    void allReduce(const void* apInput,
+                   void* apOutput,
+                   int aCount,
+                   MPI_Datatype aType,
+                   MPI_Op anOperation) const;
+
+
+//******************************************************************************
+private:
+    //--------------------------------------------------------------------------
+    /// Default constructor. Create the communicators, all the processes
+    /// must call it.
+    //--------------------------------------------------------------------------
+    MPINodeTopology();
+
+
+    /// Processes of the node of this process
+    MPI_Comm m_node_communicator;
+
+
+    /// Node leaders, MPI_COMM_NULL on the other processes
+    MPI_Comm m_leader_communicator;
+
+
+    /// Index of the node of this process
+    int m_node_id;
+
+
+    /// Rank of this process in its node
+    int m_node_rank;
+
+
+    /// Index of the first process and number of processes of every node
+    std::vector<int> m_first_process_set;
+    std::vector<int> m_number_of_processes_set;
+
+
+    /// Rank in MPI_COMM_WORLD of every process, numbered node by node
+    std::vector<int> m_rank_set;
+};
+
+
+#endif
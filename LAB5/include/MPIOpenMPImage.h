@@ -0,0 +1,202 @@
+#ifndef __MPIOpenMPImage_h
+#define __MPIOpenMPImage_h
+
+
+/**
+********************************************************************************
+*
+*   @file       MPIOpenMPImage.h
+*
+*   @brief      Class to handle a greyscale image using MPI between the
+*               processes and OpenMP within every process.
+*
+*   @version    1.0
+*
+*   @date       19/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//  Include
+//******************************************************************************
+#include <mpi.h> // Header file for MPI
+
+#include "MPIImage.h"
+
+
+//==============================================================================
+/**
+*   @class  MPIOpenMPImage
+*   @brief  MPIOpenMPImage is a class to manage a greyscale image using MPI
+*           between the processes, e.g. one per node or per socket, and
+*           OpenMP threads within every process. The image is shared
+*           between the processes as in MPIImage (replicated or distributed,
+*           same gather modes), then the part of every process is shared
+*           between its threads: the point filters, the flips, the
+*           neighbourhood filters and the statistics run the same kernels as
+*           OpenMPImage on the pixels of the process.
+*
+*           Only the master thread of every process calls MPI, outside the
+*           parallel regions: MPI must be initialised with MPI_Init_thread()
+*           and at least THREAD_SUPPORT.
+*/
+//==============================================================================
+class MPIOpenMPImage: public MPIImage
+//------------------------------------------------------------------------------
+{
+//******************************************************************************
+public:
+    /// Level of thread support required from MPI_Init_thread()
+    static const int THREAD_SUPPORT = MPI_THREAD_FUNNELED;
+
+
+    //--------------------------------------------------------------------------
+    /// Default constructor.
+    /**
+    * @param aNumberOfThreads: the number of threads of every process
+    *        (default: 4)
+    */
+    //--------------------------------------------------------------------------
+    MPIOpenMPImage(unsigned int aNumberOfThreads = 4);
+
+
+    //--------------------------------------------------------------------------
+    /// Copy constructor.
+    /**
+    * @param anImage: the image to copy
+    * @param aNumberOfThreads: the number of threads of every process
+    *        (default: 4)
+    */
+    //--------------------------------------------------------------------------
+    MPIOpenMPImage(const Image& anImage, unsigned int aNumberOfThreads = 4);
+
+
+    //--------------------------------------------------------------------------
+    /// Set the number of threads of every process.
+    /**
+    * @param aNumberOfThreads: the number of threads (at least 1)
+    */
+    //--------------------------------------------------------------------------
+    void setNumberOfThreads(unsigned int aNumberOfThreads);
+
+
+    //--------------------------------------------------------------------------
+    /// Get the number of threads of every process.
+    /**
+    * @return the number of threads
+    */
+    //--------------------------------------------------------------------------
+    unsigned int getNumberOfThreads() const;
+
+
+    //--------------------------------------------------------------------------
+    /// Negation operator. Create the negative image.
+    /**
+    * @return the negative image
+    */
+    //--------------------------------------------------------------------------
+    MPIOpenMPImage operator!() const;
+
+
+    //--------------------------------------------------------------------------
+    /// Add aShiftValue to every pixel, then multiply every pixel by aScaleValue
+    /**
+    * @param aShiftValue: the shift parameter of the filter
+    * @param aScaleValue: the scale parameter of the filter
+    * @return the new image
+    */
+    //--------------------------------------------------------------------------
+    MPIOpenMPImage shiftScaleFilter(float aShiftValue, float aScaleValue) const;
+
+
+    //--------------------------------------------------------------------------
+    /// Normalise the image between 0 and 1
+    /**
+    * @return the normalised image
+    */
+    //--------------------------------------------------------------------------
+    MPIOpenMPImage getNormalised() const;
+
+
+    //--------------------------------------------------------------------------
+    /// Normalize the image between 0 and 1
+    /**
+    * @return the normalized image
+    */
+    //--------------------------------------------------------------------------
+    MPIOpenMPImage getNormalized() const;
+
+
+    //--------------------------------------------------------------------------
+    /// Apply the log filter
+    /**
+    * @return the new image
+    */
+    //--------------------------------------------------------------------------
+    MPIOpenMPImage logFilter() const;
+
+
+    //--------------------------------------------------------------------------
+    /// Apply a point function to every pixel (see Image::PointFunction).
+    /**
+    * @param aFunction: the function
+    * @param aParameter: the parameter of the function, if any
+    * @return the new image
+    */
+    //--------------------------------------------------------------------------
+    MPIOpenMPImage applyPointFunction(PointFunction aFunction, float aParameter = 1.0) const;
+
+
+    //--------------------------------------------------------------------------
+    /// Look up the new value of every pixel in a table (see PointLUT).
+    /**
+    * @param aLUT: the lookup table
+    * @return the new image
+    */
+    //--------------------------------------------------------------------------
+    MPIOpenMPImage applyLUT(const PointLUT& aLUT) const;
+
+
+    //--------------------------------------------------------------------------
+    /// Replace every pixel by the average of its neighbourhood (see
+    /// MPIImage::boxFilter()).
+    /**
+    * @param aRadius: the radius of the neighbourhood
+    * @return the new image
+    */
+    //--------------------------------------------------------------------------
+    MPIOpenMPImage boxFilter(unsigned int aRadius) const;
+
+
+    //--------------------------------------------------------------------------
+    /// Flip the image horizontally
+    /**
+    * @return the new image
+    */
+    //--------------------------------------------------------------------------
+    MPIOpenMPImage flipHorizontally() const;
+
+
+    //--------------------------------------------------------------------------
+    /// Flip the image vertically
+    /**
+    * @return the new image
+    */
+    //--------------------------------------------------------------------------
+    MPIOpenMPImage flipVertically() const;
+
+
+//******************************************************************************
+private:
+    /// The output of a filter of MPIImage, computed with the threads of
+    /// this image, as an MPIOpenMPImage. Its pixels are not copied
+    MPIOpenMPImage toMPIOpenMPImage(MPIImage anImage) const;
+};
+
+
+#endif
@@ -0,0 +1,121 @@
+#ifndef __MPISharedBuffer_h
+#define __MPISharedBuffer_h
+
+
+/**
+********************************************************************************
+*
+*   @file       MPISharedBuffer.h
+*
+*   @brief      Class to handle an array of floats shared by the MPI processes
+*               of a node.
+*
+*   @version    1.0
+*
+*   @date       19/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//  Include
+//******************************************************************************
+#include <mpi.h> // Header file for MPI
+
+
+//==============================================================================
+/**
+*   @class  MPISharedBuffer
+*   @brief  MPISharedBuffer is an array of floats allocated once per node
+*           with MPI_Win_allocate_shared on the node communicator (see
+*           MPINodeTopology): the leader allocates it, and every process of
+*           the node accesses it directly with loads and stores.
+*
+*           The window is locked for the lifetime of the buffer (passive
+*           target, MPI_Win_lock_all), so the processes only have to call
+*           synchronise() between the writes of some processes and the reads
+*           of the others. The constructor and the destructor are collective
+*           over the node: all its processes must create and destroy their
+*           buffers in the same order, before MPI_Finalize().
+*/
+//==============================================================================
+class MPISharedBuffer
+//------------------------------------------------------------------------------
+{
+//******************************************************************************
+public:
+    //--------------------------------------------------------------------------
+    /// Constructor. All the processes of the node must call it.
+    /**
+    * @param aNumberOfElements: the number of floats
+    */
+    //--------------------------------------------------------------------------
+    MPISharedBuffer(unsigned int aNumberOfElements);
+
+
+    //--------------------------------------------------------------------------
+    /// Destructor. All the processes of the node must call it.
+    //--------------------------------------------------------------------------
+    ~MPISharedBuffer();
+
+
+    //--------------------------------------------------------------------------
+    /// Access the array.
+    /**
+    * @return the address of the first element in this process
+    */
+    //--------------------------------------------------------------------------
+    float* getData();
+
+
+    //--------------------------------------------------------------------------
+    /// Access the array.
+    /**
+    * @return the address of the first element in this process
+    */
+    //--------------------------------------------------------------------------
+    const float* getData() const;
+
+
+    //--------------------------------------------------------------------------
+    /// Number of elements.
+    /**
+    * @return the number of floats
+    */
+    //--------------------------------------------------------------------------
+    unsigned int size() const;
+
+
+    //--------------------------------------------------------------------------
+    /// Make the writes of every process of the node visible to the others:
+    /// memory barrier (MPI_Win_sync), barrier of the node, memory barrier.
+    /// All the processes of the node must call it.
+    //--------------------------------------------------------------------------
+    void synchronise() const;
+
+
+//******************************************************************************
+private:
+    /// A window cannot be copied
+    MPISharedBuffer(const MPISharedBuffer&) = delete;
+    MPISharedBuffer& operator=(const MPISharedBuffer&) = delete;
+
+
+    /// The window of the node
+    MPI_Win m_window;
+
+
+    /// The array in the address space of this process
+    float* m_p_data;
+
+
+    /// The number of floats
+    unsigned int m_size;
+};
+
+
+#endif
@@ -13,7 +13,8 @@ set output "flip_execution_time.png"
 
 plot "../LAB4/flip-pthread.csv" using 5:6 w l title "Phtreads", \
      "../LAB4/flip-openmp.csv"  using 5:6 w l title "OpenMP", \
-          "../LAB5/flip-MPI.csv"  using 5:6 w l title "MPI"
+          "../LAB5/flip-MPI.csv"  using 5:6 w l title "MPI", \
+      "../LAB5/flip-stdpar.csv"  using 5:6 w l title "C++17 parallel algorithms"
 
 
 set ylabel "Speedup factor"
@@ -23,4 +24,5 @@ set yrange[0:10]
 plot f(x) with l title "Theoretical", \
     "../LAB4/flip-pthread.csv" using 5:(serial_excution / $6) w l title "Phtreads", \
     "../LAB4/flip-openmp.csv"  using 5:(serial_excution / $6) w l title "OpenMP", \
-    "../LAB5/flip-MPI.csv"  using 5:(serial_excution / $6) w l title "MPI"
+    "../LAB5/flip-MPI.csv"  using 5:(serial_excution / $6) w l title "MPI", \
+    "../LAB5/flip-stdpar.csv"  using 5:(serial_excution / $6) w l title "C++17 parallel algorithms"
@@ -2,10 +2,13 @@
 INPUT_IMAGE="../LAB3/Airbus_Pleiades_50cm_8bit_grey_Yogyakarta.txt"
 
 # Header for the CSV files
-header="\"input_file\",implementation,number_of_processes_or_threads,duration_in_sec"
+# (the CPU topology is recorded to interpret the scaling curves)
+header="\"input_file\",\"output_file\",implementation,number_of_processes_or_threads,duration_in_sec,sockets,physical_cores,logical_cpus,allowed_cpus,isa"
 
 echo "Log_filter,"$header  > log-MPI.csv
 echo "Flip_filter,"$header > flip-MPI.csv
+echo "Log_filter,"$header  > log-stdpar.csv
+echo "Flip_filter,"$header > flip-stdpar.csv
 
 # Get the CPU name
 CPU=`lscpu | sed -nr '/Model name/ s/.*:\s*(.*) @ .*/\1/p'`
@@ -16,12 +19,13 @@ IFS=',' read -ra LOG_SERIAL <<< $TEMP
 
 # Store the results in the corresponding CSV files
 echo $TEMP >> log-MPI.csv
+echo $TEMP >> log-stdpar.csv
 
 # Create the corresponding gnuplot script
 # Set the title using the CPU name
 echo "set title 'Log filter on $CPU'" > temp_log.plt
 # Insert the runtime of the serial implementation
-echo "serial_excution=${LOG_SERIAL[-1]}" >> temp_log.plt
+echo "serial_excution=${LOG_SERIAL[5]}" >> temp_log.plt
 cat performanceLogFilter.plt >> temp_log.plt
 
 
@@ -32,12 +36,13 @@ IFS=',' read -ra FLIP_SERIAL <<< $TEMP
 # Store the results in the corresponding CSV files
 echo $TEMP >> flip-openmp.csv
 echo $TEMP >> flip-pthread.csv
+echo $TEMP >> flip-stdpar.csv
 
 # Create the corresponding gnuplot script
 # Set the title using the CPU name
 echo "set title 'Flip image on $CPU'" > temp_flip.plt
 # Insert the runtime of the serial implementation
-echo "serial_excution=${FLIP_SERIAL[-1]}" >> temp_flip.plt
+echo "serial_excution=${FLIP_SERIAL[5]}" >> temp_flip.plt
 cat performanceFlip.plt >> temp_flip.plt
 
 
@@ -47,6 +52,9 @@ for i in {1..40}
 do
     mpirun -np $i ./bin/log     -c MPI -i $INPUT_IMAGE -n $i >> log-MPI.csv
     mpirun -np $i ./bin/flip -H -c MPI -i $INPUT_IMAGE -n $i >> flip-MPI.csv
+
+    ./bin/log     -c stdpar -i $INPUT_IMAGE -n $i >> log-stdpar.csv
+    ./bin/flip -H -c stdpar -i $INPUT_IMAGE -n $i >> flip-stdpar.csv
 done
 
 # Remove old graphs
@@ -0,0 +1,536 @@
+/**
+********************************************************************************
+*
+*   @file       MPIBlockDecomposition.cxx
+*
+*   @brief      Decomposition of an image in 2-D blocks over a Cartesian grid
+*               of MPI processes, with a halo around every block for the
+*               filters that read the neighbouring pixels.
+*
+*   @version    1.0
+*
+*   @date       19/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//  Include
+//******************************************************************************
+#include <cstring> // Header file for memcpy
+#include <string>
+
+#include "MPIBlockDecomposition.h"
+#include "ParallelReduction.h"
+
+
+//******************************************************************************
+//  Constant variables
+//******************************************************************************
+namespace
+{
+    /// Position of every neighbour, (dx, dy): the neighbour in the opposite
+    /// direction of the neighbour i is the neighbour 7 - i
+    const int DIRECTION_SET[8][2] =
+    {
+        {-1, -1}, { 0, -1}, { 1, -1},
+        {-1,  0},           { 1,  0},
+        {-1,  1}, { 0,  1}, { 1,  1}
+    };
+
+
+    /// The neighbours along the edges
+    const int LEFT = 3;
+    const int RIGHT = 4;
+    const int TOP = 1;
+    const int BOTTOM = 6;
+
+
+    //--------------------------------------------------------------------------
+    /// Datatype of a rectangle of pixels in a 2-D array of floats
+    //--------------------------------------------------------------------------
+    MPI_Datatype createSubarray(unsigned int aWidth,
+                                unsigned int aHeight,
+                                unsigned int aFirstColumn,
+                                unsigned int aFirstRow,
+                                unsigned int aSubWidth,
+                                unsigned int aSubHeight)
+    {
+        int size_set[2] = {int(aHeight), int(aWidth)};
+        int sub_size_set[2] = {int(aSubHeight), int(aSubWidth)};
+        int start_set[2] = {int(aFirstRow), int(aFirstColumn)};
+
+        MPI_Datatype datatype;
+        MPI_Type_create_subarray(2, size_set, sub_size_set, start_set, MPI_ORDER_C, MPI_FLOAT, &datatype);
+        MPI_Type_commit(&datatype);
+
+        return datatype;
+    }
+
+
+    //--------------------------------------------------------------------------
+    /// First pixel and number of pixels of the part of a block sent to a
+    /// neighbour (aDirection = -1, 0 or 1 along an axis), or of its halo
+    /// received from the neighbour
+    //--------------------------------------------------------------------------
+    void getHaloRange(int aDirection,
+                      bool isReceived,
+                      unsigned int aBlockSize,
+                      unsigned int aHaloWidth,
+                      unsigned int& aStartID,
+                      unsigned int& aSize)
+    {
+        if (aDirection < 0)
+        {
+            aStartID = (isReceived) ? 0 : aHaloWidth;
+            aSize = aHaloWidth;
+        }
+        else if (aDirection > 0)
+        {
+            aStartID = (isReceived) ? aHaloWidth + aBlockSize : aBlockSize;
+            aSize = aHaloWidth;
+        }
+        else
+        {
+            aStartID = aHaloWidth;
+            aSize = aBlockSize;
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------
+MPIBlockDecomposition::MPIBlockDecomposition(unsigned int aWidth,
+                                             unsigned int aHeight,
+                                             unsigned int aHaloWidth):
+//--------------------------------------------------------------------
+        m_communicator(MPI_COMM_NULL),
+        m_width(aWidth),
+        m_height(aHeight),
+        m_halo_width(aHaloWidth)
+//--------------------------------------------------------------------
+{
+    int world_size;
+    int rank;
+
+    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+    // The most balanced grid, the longest axis of the image gets the
+    // largest number of processes
+    int dimension_set[2] = {0, 0};
+    MPI_Dims_create(world_size, 2, dimension_set);
+
+    m_number_of_columns = (aWidth >= aHeight) ? dimension_set[0] : dimension_set[1];
+    m_number_of_rows = (aWidth >= aHeight) ? dimension_set[1] : dimension_set[0];
+
+    // Every block needs at least one pixel
+    unsigned int min_block_width = aWidth / m_number_of_columns;
+    unsigned int min_block_height = aHeight / m_number_of_rows;
+
+    if (!min_block_width || !min_block_height)
+    {
+        throw std::string("The image (") + std::to_string(aWidth) + "x" + std::to_string(aHeight) +
+                ") is too small for " + std::to_string(world_size) + " processes";
+    }
+
+    // The halo can only come from the direct neighbours, if any
+    unsigned int min_block_size = std::min((m_number_of_columns > 1) ? min_block_width : aHaloWidth,
+                                           (m_number_of_rows > 1) ? min_block_height : aHaloWidth);
+
+    if (aHaloWidth > min_block_size)
+    {
+        throw std::string("The halo (") + std::to_string(aHaloWidth) +
+                " pixels) is wider than the smallest block (" + std::to_string(min_block_size) + " pixels)";
+    }
+
+    // The block of every process, the processes are numbered row by row,
+    // as in the Cartesian communicator
+    for (int i = 0; i < world_size; ++i)
+    {
+        unsigned int first_column, last_column;
+        unsigned int first_row, last_row;
+
+        getTaskRange(aWidth, m_number_of_columns, i % m_number_of_columns, first_column, last_column);
+        getTaskRange(aHeight, m_number_of_rows, i / m_number_of_columns, first_row, last_row);
+
+        m_first_column_set.push_back(first_column);
+        m_first_row_set.push_back(first_row);
+        m_width_set.push_back(last_column - first_column);
+        m_height_set.push_back(last_row - first_row);
+    }
+
+    m_block_width = m_width_set[rank];
+    m_block_height = m_height_set[rank];
+    m_padded_width = m_block_width + 2 * m_halo_width;
+    m_padded_height = m_block_height + 2 * m_halo_width;
+
+    // The Cartesian communicator, without periodicity nor reordering
+    int grid_size_set[2] = {m_number_of_rows, m_number_of_columns};
+    int period_set[2] = {0, 0};
+    MPI_Cart_create(MPI_COMM_WORLD, 2, grid_size_set, period_set, 0, &m_communicator);
+
+    int coordinate_set[2];
+    MPI_Cart_coords(m_communicator, rank, 2, coordinate_set);
+
+    // The neighbours, and the parts of the padded buffer exchanged with them
+    for (int i = 0; i < NUMBER_OF_NEIGHBOURS; ++i)
+    {
+        int dx = DIRECTION_SET[i][0];
+        int dy = DIRECTION_SET[i][1];
+
+        int neighbour_coordinate_set[2] = {coordinate_set[0] + dy, coordinate_set[1] + dx};
+
+        m_p_neighbour_set[i] = MPI_PROC_NULL;
+        if (neighbour_coordinate_set[0] >= 0 && neighbour_coordinate_set[0] < m_number_of_rows &&
+                neighbour_coordinate_set[1] >= 0 && neighbour_coordinate_set[1] < m_number_of_columns)
+        {
+            MPI_Cart_rank(m_communicator, neighbour_coordinate_set, &m_p_neighbour_set[i]);
+        }
+
+        m_p_send_type_set[i] = MPI_DATATYPE_NULL;
+        m_p_receive_type_set[i] = MPI_DATATYPE_NULL;
+
+        // No halo, nothing to exchange
+        if (!m_halo_width)
+        {
+            continue;
+        }
+
+        unsigned int x, y, width, height;
+
+        getHaloRange(dx, false, m_block_width, m_halo_width, x, width);
+        getHaloRange(dy, false, m_block_height, m_halo_width, y, height);
+        m_p_send_type_set[i] = createSubarray(m_padded_width, m_padded_height, x, y, width, height);
+
+        getHaloRange(dx, true, m_block_width, m_halo_width, x, width);
+        getHaloRange(dy, true, m_block_height, m_halo_width, y, height);
+        m_p_receive_type_set[i] = createSubarray(m_padded_width, m_padded_height, x, y, width, height);
+    }
+}
+
+
+//---------------------------------------------
+MPIBlockDecomposition::~MPIBlockDecomposition()
+//---------------------------------------------
+{
+    for (int i = 0; i < NUMBER_OF_NEIGHBOURS; ++i)
+    {
+        if (m_p_send_type_set[i] != MPI_DATATYPE_NULL)
+        {
+            MPI_Type_free(&m_p_send_type_set[i]);
+        }
+
+        if (m_p_receive_type_set[i] != MPI_DATATYPE_NULL)
+        {
+            MPI_Type_free(&m_p_receive_type_set[i]);
+        }
+    }
+
+    if (m_communicator != MPI_COMM_NULL)
+    {
+        MPI_Comm_free(&m_communicator);
+    }
+}
+
+
+//-----------------------------------------------------
+MPI_Comm MPIBlockDecomposition::getCommunicator() const
+//-----------------------------------------------------
+{
+    return m_communicator;
+}
+
+
+//-----------------------------------------------------------------------------------------
+void MPIBlockDecomposition::getProcessGrid(int& aNumberOfColumns, int& aNumberOfRows) const
+//-----------------------------------------------------------------------------------------
+{
+    aNumberOfColumns = m_number_of_columns;
+    aNumberOfRows = m_number_of_rows;
+}
+
+
+//---------------------------------------------------------------
+void MPIBlockDecomposition::getBlock(int aRank,
+                                     unsigned int& aFirstColumn,
+                                     unsigned int& aFirstRow,
+                                     unsigned int& aWidth,
+                                     unsigned int& aHeight) const
+//---------------------------------------------------------------
+{
+    aFirstColumn = m_first_column_set[aRank];
+    aFirstRow = m_first_row_set[aRank];
+    aWidth = m_width_set[aRank];
+    aHeight = m_height_set[aRank];
+}
+
+
+//-------------------------------------------------------
+unsigned int MPIBlockDecomposition::getBlockWidth() const
+//-------------------------------------------------------
+{
+    return m_block_width;
+}
+
+
+//--------------------------------------------------------
+unsigned int MPIBlockDecomposition::getBlockHeight() const
+//--------------------------------------------------------
+{
+    return m_block_height;
+}
+
+
+//------------------------------------------------------
+unsigned int MPIBlockDecomposition::getHaloWidth() const
+//------------------------------------------------------
+{
+    return m_halo_width;
+}
+
+
+//--------------------------------------------------------
+unsigned int MPIBlockDecomposition::getPaddedWidth() const
+//--------------------------------------------------------
+{
+    return m_padded_width;
+}
+
+
+//-------------------------------------------------------
+unsigned int MPIBlockDecomposition::getPaddedSize() const
+//-------------------------------------------------------
+{
+    return m_padded_width * m_padded_height;
+}
+
+
+//-------------------------------------------------------------------------------------
+void MPIBlockDecomposition::copyBlock(const float* apImage, float* apPaddedBlock) const
+//-------------------------------------------------------------------------------------
+{
+    int rank;
+    MPI_Comm_rank(m_communicator, &rank);
+
+    for (unsigned int y = 0; y < m_block_height; ++y)
+    {
+        std::memcpy(apPaddedBlock + (y + m_halo_width) * m_padded_width + m_halo_width,
+                    apImage + (m_first_row_set[rank] + y) * m_width + m_first_column_set[rank],
+                    m_block_width * sizeof(float));
+    }
+}
+
+
+//-----------------------------------------------------------------
+void MPIBlockDecomposition::rowsToBlock(const float* apRows,
+                                        unsigned int aFirstRow,
+                                        unsigned int aNumberOfRows,
+                                        float* apPaddedBlock) const
+//-----------------------------------------------------------------
+{
+    std::vector<MPI_Datatype> row_type_set;
+    std::vector<MPI_Datatype> block_type_set;
+    createRowTypes(aFirstRow, aNumberOfRows, m_halo_width, row_type_set, block_type_set);
+
+    // One element of the datatype per process, or nothing
+    std::vector<int> send_count_set;
+    std::vector<int> receive_count_set;
+    std::vector<int> displacement_set(row_type_set.size(), 0);
+
+    for (unsigned int i = 0; i < row_type_set.size(); ++i)
+    {
+        send_count_set.push_back(row_type_set[i] != MPI_FLOAT);
+        receive_count_set.push_back(block_type_set[i] != MPI_FLOAT);
+    }
+
+    MPI_Alltoallw(apRows, send_count_set.data(), displacement_set.data(), row_type_set.data(),
+                  apPaddedBlock, receive_count_set.data(), displacement_set.data(), block_type_set.data(),
+                  m_communicator);
+
+    for (unsigned int i = 0; i < row_type_set.size(); ++i)
+    {
+        if (row_type_set[i] != MPI_FLOAT) MPI_Type_free(&row_type_set[i]);
+        if (block_type_set[i] != MPI_FLOAT) MPI_Type_free(&block_type_set[i]);
+    }
+}
+
+
+//-----------------------------------------------------------------------
+void MPIBlockDecomposition::blockToRows(const float* apBlock,
+                                        float* apRows,
+                                        unsigned int aFirstRow,
+                                        unsigned int aNumberOfRows) const
+//-----------------------------------------------------------------------
+{
+    std::vector<MPI_Datatype> row_type_set;
+    std::vector<MPI_Datatype> block_type_set;
+    createRowTypes(aFirstRow, aNumberOfRows, 0, row_type_set, block_type_set);
+
+    // One element of the datatype per process, or nothing
+    std::vector<int> send_count_set;
+    std::vector<int> receive_count_set;
+    std::vector<int> displacement_set(row_type_set.size(), 0);
+
+    for (unsigned int i = 0; i < row_type_set.size(); ++i)
+    {
+        send_count_set.push_back(block_type_set[i] != MPI_FLOAT);
+        receive_count_set.push_back(row_type_set[i] != MPI_FLOAT);
+    }
+
+    MPI_Alltoallw(apBlock, send_count_set.data(), displacement_set.data(), block_type_set.data(),
+                  apRows, receive_count_set.data(), displacement_set.data(), row_type_set.data(),
+                  m_communicator);
+
+    for (unsigned int i = 0; i < row_type_set.size(); ++i)
+    {
+        if (row_type_set[i] != MPI_FLOAT) MPI_Type_free(&row_type_set[i]);
+        if (block_type_set[i] != MPI_FLOAT) MPI_Type_free(&block_type_set[i]);
+    }
+}
+
+
+//-----------------------------------------------------------------
+void MPIBlockDecomposition::startHaloExchange(float* apPaddedBlock)
+//-----------------------------------------------------------------
+{
+    m_request_set.clear();
+
+    // No halo, nothing to exchange
+    if (!m_halo_width)
+    {
+        return;
+    }
+
+    m_request_set.resize(2 * NUMBER_OF_NEIGHBOURS, MPI_REQUEST_NULL);
+
+    // The message sent towards the neighbour i has the tag i, the one
+    // received from it was sent towards the opposite direction. Nothing is
+    // exchanged with MPI_PROC_NULL
+    for (int i = 0; i < NUMBER_OF_NEIGHBOURS; ++i)
+    {
+        MPI_Irecv(apPaddedBlock, 1, m_p_receive_type_set[i], m_p_neighbour_set[i],
+                  NUMBER_OF_NEIGHBOURS - 1 - i, m_communicator, &m_request_set[i]);
+    }
+
+    for (int i = 0; i < NUMBER_OF_NEIGHBOURS; ++i)
+    {
+        MPI_Isend(apPaddedBlock, 1, m_p_send_type_set[i], m_p_neighbour_set[i],
+                  i, m_communicator, &m_request_set[NUMBER_OF_NEIGHBOURS + i]);
+    }
+}
+
+
+//------------------------------------------------------------------
+void MPIBlockDecomposition::finishHaloExchange(float* apPaddedBlock)
+//------------------------------------------------------------------
+{
+    MPI_Waitall(m_request_set.size(), m_request_set.data(), MPI_STATUSES_IGNORE);
+    m_request_set.clear();
+
+    // No halo
+    if (!m_halo_width)
+    {
+        return;
+    }
+
+    // Outside the image, repeat the nearest column over all the rows of
+    // the padded buffer, including the halo received from the top and
+    // bottom neighbours, then the nearest row over the whole width, so that
+    // the corners are right whichever neighbours exist
+    if (m_p_neighbour_set[LEFT] == MPI_PROC_NULL)
+    {
+        for (unsigned int y = 0; y < m_padded_height; ++y)
+        {
+            float* p_row = apPaddedBlock + y * m_padded_width;
+            std::fill(p_row, p_row + m_halo_width, p_row[m_halo_width]);
+        }
+    }
+
+    if (m_p_neighbour_set[RIGHT] == MPI_PROC_NULL)
+    {
+        for (unsigned int y = 0; y < m_padded_height; ++y)
+        {
+            float* p_row = apPaddedBlock + y * m_padded_width;
+            std::fill(p_row + m_halo_width + m_block_width, p_row + m_padded_width,
+                      p_row[m_halo_width + m_block_width - 1]);
+        }
+    }
+
+    if (m_p_neighbour_set[TOP] == MPI_PROC_NULL)
+    {
+        for (unsigned int y = 0; y < m_halo_width; ++y)
+        {
+            std::memcpy(apPaddedBlock + y * m_padded_width,
+                        apPaddedBlock + m_halo_width * m_padded_width,
+                        m_padded_width * sizeof(float));
+        }
+    }
+
+    if (m_p_neighbour_set[BOTTOM] == MPI_PROC_NULL)
+    {
+        for (unsigned int y = m_halo_width + m_block_height; y < m_padded_height; ++y)
+        {
+            std::memcpy(apPaddedBlock + y * m_padded_width,
+                        apPaddedBlock + (m_halo_width + m_block_height - 1) * m_padded_width,
+                        m_padded_width * sizeof(float));
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------------------
+void MPIBlockDecomposition::createRowTypes(unsigned int aFirstRow,
+                                           unsigned int aNumberOfRows,
+                                           unsigned int aHaloWidth,
+                                           std::vector<MPI_Datatype>& aRowTypeSet,
+                                           std::vector<MPI_Datatype>& aBlockTypeSet) const
+//----------------------------------------------------------------------------------------
+{
+    int world_size;
+    int rank;
+
+    MPI_Comm_size(m_communicator, &world_size);
+    MPI_Comm_rank(m_communicator, &rank);
+
+    // The rows of every process, they are not always in rank order
+    unsigned int row_range[2] = {aFirstRow, aNumberOfRows};
+    std::vector<unsigned int> row_range_set(2 * world_size);
+
+    MPI_Allgather(row_range, 2, MPI_UNSIGNED, row_range_set.data(), 2, MPI_UNSIGNED, m_communicator);
+
+    aRowTypeSet.assign(world_size, MPI_FLOAT);
+    aBlockTypeSet.assign(world_size, MPI_FLOAT);
+
+    unsigned int block_first_row = m_first_row_set[rank];
+    unsigned int block_last_row = block_first_row + m_block_height;
+
+    for (int i = 0; i < world_size; ++i)
+    {
+        // The rows of this process in the block of the process i
+        unsigned int first_row = std::max(aFirstRow, m_first_row_set[i]);
+        unsigned int last_row = std::min(aFirstRow + aNumberOfRows, m_first_row_set[i] + m_height_set[i]);
+
+        if (first_row < last_row)
+        {
+            aRowTypeSet[i] = createSubarray(m_width, aNumberOfRows,
+                                            m_first_column_set[i], first_row - aFirstRow,
+                                            m_width_set[i], last_row - first_row);
+        }
+
+        // The rows of the process i in the block of this process
+        first_row = std::max(row_range_set[2 * i], block_first_row);
+        last_row = std::min(row_range_set[2 * i] + row_range_set[2 * i + 1], block_last_row);
+
+        if (first_row < last_row)
+        {
+            aBlockTypeSet[i] = createSubarray(m_block_width + 2 * aHaloWidth, m_block_height + 2 * aHaloWidth,
+                                              aHaloWidth, first_row - block_first_row + aHaloWidth,
+                                              m_block_width, last_row - first_row);
+        }
+    }
+}
@@ -22,17 +22,329 @@
 //******************************************************************************
 //  Include
 //******************************************************************************
-#include <cmath> // Header file for abs and log
+#include <cmath> // Header file for abs, log and sqrt
+#include <cctype> // Header file for tolower
+#include <algorithm> // Header file for transform, swap_ranges, min and max
 #include <limits>
+#include <cstring> // Header file for memcpy
+#include <exception>
+#include <utility> // Header file for pair
 #include <mpi.h> // Header file for MPI
 
 #include "MPIImage.h"
+#include "MPIBlockDecomposition.h"
+#include "MPINodeTopology.h"
+#include "ImageKernels.h"
+#include "ParallelReduction.h"
+#include "PointLUT.h"
+
+
+//******************************************************************************
+//  Local functions
+//******************************************************************************
+namespace
+{
+    /// Tag of the chunks of PIPELINED, the tags 0 to 2 are used by
+    /// POINT_TO_POINT_GATHER
+    const int CHUNK_TAG = 3;
+
+
+    /// Tag of the first tile of DYNAMIC, the tag of a tile is TILE_TAG plus
+    /// its index
+    const int TILE_TAG = 4;
+
+
+    /// Statistics of a part of the image, in double precision so that the
+    /// merges do not lose the accuracy of the partial results
+    struct PartialStatistics
+    {
+        double number_of_pixels;
+        double min_value;
+        double max_value;
+        double mean;
+
+        /// Sum of the squared differences to the mean
+        double m2;
+    };
+
+
+    //--------------------------------------------------------------------------
+    /// Merge the statistics of two parts (Chan, Golub and LeVeque):
+    /// aStatistics += anInput
+    //--------------------------------------------------------------------------
+    void mergeStatistics(const PartialStatistics& anInput, PartialStatistics& aStatistics)
+    {
+        const PartialStatistics& a = anInput;
+        PartialStatistics& b = aStatistics;
+
+        // One of the parts is empty
+        if (!a.number_of_pixels) return;
+
+        if (!b.number_of_pixels)
+        {
+            b = a;
+            return;
+        }
+
+        double number_of_pixels = a.number_of_pixels + b.number_of_pixels;
+        double delta = b.mean - a.mean;
+
+        b.m2 = a.m2 + b.m2 + delta * delta * a.number_of_pixels * b.number_of_pixels / number_of_pixels;
+        b.mean = a.mean + delta * b.number_of_pixels / number_of_pixels;
+        b.number_of_pixels = number_of_pixels;
+        b.min_value = std::min(a.min_value, b.min_value);
+        b.max_value = std::max(a.max_value, b.max_value);
+    }
+
+
+    //--------------------------------------------------------------------------
+    /// The user-defined operation of MPI_Allreduce that merges statistics,
+    /// apInOut[i] += apInput[i]
+    //--------------------------------------------------------------------------
+    void mergeStatistics(void* apInput, void* apInOut, int* apLength, MPI_Datatype*)
+    {
+        const PartialStatistics* p_input = static_cast<const PartialStatistics*>(apInput);
+        PartialStatistics* p_in_out = static_cast<PartialStatistics*>(apInOut);
+
+        for (int i = 0; i < *apLength; ++i)
+        {
+            mergeStatistics(p_input[i], p_in_out[i]);
+        }
+    }
+}
+
+
+//******************************************************************************
+//  Static members
+//******************************************************************************
+MPIImage::GatherMode MPIImage::m_gather_mode = MPIImage::GATHERV;
+MPIImage::DistributionMode MPIImage::m_distribution_mode = MPIImage::REPLICATED;
+MPIImage::CollectiveMode MPIImage::m_collective_mode = MPIImage::FLAT;
+unsigned int MPIImage::m_chunk_size = 65536;
+double MPIImage::m_compute_time = 0.0;
+double MPIImage::m_wait_time = 0.0;
+unsigned long long MPIImage::m_number_of_computed_pixels = 0;
+
+
+//--------------------------------------------
+void MPIImage::setGatherMode(GatherMode aMode)
+//--------------------------------------------
+{
+    m_gather_mode = aMode;
+}
+
+
+//--------------------------------------------
+MPIImage::GatherMode MPIImage::getGatherMode()
+//--------------------------------------------
+{
+    return m_gather_mode;
+}
+
+
+//--------------------------------------------------------------------
+MPIImage::GatherMode MPIImage::getGatherMode(const std::string& aName)
+//--------------------------------------------------------------------
+{
+    std::string name(aName);
+    std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+
+    if (name == "p2p") return POINT_TO_POINT_GATHER;
+    if (name == "gatherv") return GATHERV;
+    if (name == "allgatherv") return ALLGATHERV;
+    if (name == "pipelined") return PIPELINED;
+    if (name == "dynamic") return DYNAMIC;
+
+    throw std::string("Unknown gather mode: ") + aName + " (valid modes are p2p, gatherv, allgatherv, pipelined and dynamic)";
+}
+
+
+//-------------------------------------------------------
+std::string MPIImage::getGatherModeName(GatherMode aMode)
+//-------------------------------------------------------
+{
+    if (aMode == POINT_TO_POINT_GATHER) return "p2p";
+    if (aMode == ALLGATHERV) return "allgatherv";
+    if (aMode == PIPELINED) return "pipelined";
+    if (aMode == DYNAMIC) return "dynamic";
+    return "gatherv";
+}
+
+
+//-------------------------------------------------------
+void MPIImage::setChunkSize(unsigned int aNumberOfPixels)
+//-------------------------------------------------------
+{
+    if (!aNumberOfPixels)
+    {
+        throw "The chunk size must be at least one pixel";
+    }
+
+    m_chunk_size = aNumberOfPixels;
+}
+
+
+//-----------------------------------
+unsigned int MPIImage::getChunkSize()
+//-----------------------------------
+{
+    return m_chunk_size;
+}
+
+
+//--------------------------------------------------------------------
+void MPIImage::getGatherTimes(double& aComputeTime, double& aWaitTime)
+//--------------------------------------------------------------------
+{
+    double time_set[2] = {m_compute_time, m_wait_time};
+    MPI_Allreduce(MPI_IN_PLACE, time_set, 2, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+
+    aComputeTime = time_set[0];
+    aWaitTime = time_set[1];
+}
+
+
+//-------------------------------------
+double MPIImage::getOverlapEfficiency()
+//-------------------------------------
+{
+    double compute_time;
+    double wait_time;
+    getGatherTimes(compute_time, wait_time);
+
+    // Nothing has been assembled
+    if (compute_time + wait_time <= 0.0)
+    {
+        return 1.0;
+    }
+
+    return compute_time / (compute_time + wait_time);
+}
+
+
+//-------------------------------------------------------------------------------------
+void MPIImage::getWorkDistribution(std::vector<unsigned long long>& aNumberOfPixelsSet,
+                                   std::vector<double>& anIdleTimeSet)
+//-------------------------------------------------------------------------------------
+{
+    int world_size;
+    int rank;
+
+    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+    aNumberOfPixelsSet.resize((rank == ROOT) ? world_size : 0);
+    anIdleTimeSet.resize((rank == ROOT) ? world_size : 0);
+
+    MPI_Gather(&m_number_of_computed_pixels, 1, MPI_UNSIGNED_LONG_LONG,
+               aNumberOfPixelsSet.data(), 1, MPI_UNSIGNED_LONG_LONG,
+               ROOT, MPI_COMM_WORLD);
+
+    MPI_Gather(&m_wait_time, 1, MPI_DOUBLE,
+               anIdleTimeSet.data(), 1, MPI_DOUBLE,
+               ROOT, MPI_COMM_WORLD);
+}
+
+
+//-------------------------------
+void MPIImage::resetGatherTimes()
+//-------------------------------
+{
+    m_compute_time = 0.0;
+    m_wait_time = 0.0;
+    m_number_of_computed_pixels = 0;
+}
+
+
+//--------------------------------------------------------
+void MPIImage::setDistributionMode(DistributionMode aMode)
+//--------------------------------------------------------
+{
+    m_distribution_mode = aMode;
+}
+
+
+//--------------------------------------------------------
+MPIImage::DistributionMode MPIImage::getDistributionMode()
+//--------------------------------------------------------
+{
+    return m_distribution_mode;
+}
+
+
+//--------------------------------------------------------------------------------
+MPIImage::DistributionMode MPIImage::getDistributionMode(const std::string& aName)
+//--------------------------------------------------------------------------------
+{
+    std::string name(aName);
+    std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+
+    if (name == "replicated") return REPLICATED;
+    if (name == "scattered") return SCATTERED;
+    if (name == "shared") return SHARED;
+
+    throw std::string("Unknown distribution mode: ") + aName + " (valid modes are replicated, scattered and shared)";
+}
+
+
+//-------------------------------------------------------------------
+std::string MPIImage::getDistributionModeName(DistributionMode aMode)
+//-------------------------------------------------------------------
+{
+    if (aMode == SCATTERED) return "scattered";
+    if (aMode == SHARED) return "shared";
+    return "replicated";
+}
+
+
+//----------------------------------------------------
+void MPIImage::setCollectiveMode(CollectiveMode aMode)
+//----------------------------------------------------
+{
+    m_collective_mode = aMode;
+}
+
+
+//----------------------------------------------------
+MPIImage::CollectiveMode MPIImage::getCollectiveMode()
+//----------------------------------------------------
+{
+    return m_collective_mode;
+}
+
+
+//----------------------------------------------------------------------------
+MPIImage::CollectiveMode MPIImage::getCollectiveMode(const std::string& aName)
+//----------------------------------------------------------------------------
+{
+    std::string name(aName);
+    std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+
+    if (name == "flat") return FLAT;
+    if (name == "hierarchical") return HIERARCHICAL;
+
+    throw std::string("Unknown collective mode: ") + aName + " (valid modes are flat and hierarchical)";
+}
+
+
+//---------------------------------------------------------------
+std::string MPIImage::getCollectiveModeName(CollectiveMode aMode)
+//---------------------------------------------------------------
+{
+    if (aMode == HIERARCHICAL) return "hierarchical";
+    return "flat";
+}
 
 
 //-------------------
 MPIImage::MPIImage():
 //-------------------
-        Image()
+        Image(),
+        m_thread_number(1),
+        m_is_distributed(false),
+        m_first_row(0),
+        m_number_of_rows(0),
+        m_part_element_size(0)
 //-------------------
 {}
 
@@ -40,17 +352,42 @@ MPIImage::MPIImage():
 //---------------------------------------
 MPIImage::MPIImage(const Image& anImage):
 //---------------------------------------
-        Image(anImage)
+        Image(anImage),
+        m_thread_number(1),
+        m_is_distributed(false),
+        m_first_row(0),
+        m_number_of_rows(anImage.getHeight()),
+        m_part_element_size(0)
 //---------------------------------------
 {}
 
 
+//------------------------------------------
+MPIImage::MPIImage(const MPIImage& anImage):
+//------------------------------------------
+        Image(),
+        m_thread_number(anImage.m_thread_number),
+        m_is_distributed(false),
+        m_first_row(0),
+        m_number_of_rows(0),
+        m_part_element_size(0)
+//------------------------------------------
+{
+    copyImage(anImage);
+}
+
+
 //---------------------------------------
 MPIImage::MPIImage(const float* apData,
                    unsigned int aWidth,
                    unsigned int aHeight):
 //---------------------------------------
-        Image(apData, aWidth, aHeight)
+        Image(apData, aWidth, aHeight),
+        m_thread_number(1),
+        m_is_distributed(false),
+        m_first_row(0),
+        m_number_of_rows(aHeight),
+        m_part_element_size(0)
 //---------------------------------------
 {}
 
@@ -60,11 +397,92 @@ MPIImage::MPIImage(unsigned int aWidth,
                    unsigned int aHeight,
                    float aDefaultValue):
 //-------------------------------------------
-        Image(aWidth, aHeight, aDefaultValue)
+        Image(aWidth, aHeight, aDefaultValue),
+        m_thread_number(1),
+        m_is_distributed(false),
+        m_first_row(0),
+        m_number_of_rows(aHeight),
+        m_part_element_size(0)
 //-------------------------------------------
 {}
 
 
+//--------------------------------------
+MPIImage::MPIImage(unsigned int aWidth,
+                   unsigned int aHeight,
+                   NoInit aTag):
+//--------------------------------------
+        Image(aWidth, aHeight, aTag),
+        m_thread_number(1),
+        m_is_distributed(false),
+        m_first_row(0),
+        m_number_of_rows(aHeight),
+        m_part_element_size(0)
+//--------------------------------------
+{}
+
+
+//-----------------------------------------------------------
+MPIImage::MPIImage(const MPIImage& anImage, NoInit /*aTag*/):
+//-----------------------------------------------------------
+        Image(),
+        m_thread_number(anImage.m_thread_number),
+        m_is_distributed(anImage.m_is_distributed),
+        m_first_row(anImage.m_first_row),
+        m_number_of_rows(anImage.m_number_of_rows),
+        m_part_element_size(0)
+//-----------------------------------------------------------
+{
+    m_width = anImage.m_width;
+    m_height = anImage.m_height;
+
+    // One buffer per node, or the pixels of this process
+    if (anImage.isShared())
+    {
+        m_p_shared_buffer.reset(new MPISharedBuffer(m_width * m_height));
+    }
+    else
+    {
+        m_p_image = PixelVector(anImage.m_p_image.size());
+    }
+}
+
+
+//----------------------------------------------------
+MPIImage& MPIImage::operator=(const MPIImage& anImage)
+//----------------------------------------------------
+{
+    // The images different
+    if (this != &anImage)
+    {
+        m_thread_number = anImage.m_thread_number;
+        copyImage(anImage);
+    }
+
+    // Return the instance
+    return (*this);
+}
+
+
+//--------------------------------------------
+void MPIImage::loadPGM(const char* aFileName)
+//--------------------------------------------
+{
+    load([aFileName](Image& anImage)
+    {
+        anImage.loadPGM(aFileName);
+    });
+}
+
+
+//---------------------------------------------------
+void MPIImage::loadPGM(const std::string& aFileName)
+//---------------------------------------------------
+{
+    loadPGM(aFileName.data());
+}
+
+
 //-------------------------------------------
 void MPIImage::savePGM(const char* aFileName)
 //-------------------------------------------
@@ -73,348 +491,1907 @@ void MPIImage::savePGM(const char* aFileName)
     int rank;
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
 
+    // Assemble the blocks of a distributed image on the master, or copy
+    // the buffer of a shared image
+    if (m_is_distributed || isShared())
+    {
+        Image whole_image;
+        gatherImage(whole_image);
+
+        if (rank == ROOT)
+        {
+            whole_image.savePGM(aFileName);
+        }
+    }
     // Only the master is allowed to save
-    if (rank == ROOT)
+    else if (rank == ROOT)
     {
         Image::savePGM(aFileName);
     }
 }
 
 
-//---------------------------------------------
-void MPIImage::saveASCII(const char* aFileName)
-//---------------------------------------------
+//--------------------------------------------------
+void MPIImage::savePGM(const std::string& aFileName)
+//--------------------------------------------------
+{
+    savePGM(aFileName.data());
+}
+
+
+//----------------------------------------------
+void MPIImage::loadASCII(const char* aFileName)
+//----------------------------------------------
+{
+    load([aFileName](Image& anImage)
+    {
+        anImage.loadASCII(aFileName);
+    });
+}
+
+
+//-----------------------------------------------------
+void MPIImage::loadASCII(const std::string& aFileName)
+//-----------------------------------------------------
+{
+    loadASCII(aFileName.data());
+}
+
+
+//---------------------------------------------
+void MPIImage::saveASCII(const char* aFileName)
+//---------------------------------------------
+{
+    // Get the process' rank
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+    // Assemble the blocks of a distributed image on the master, or copy
+    // the buffer of a shared image
+    if (m_is_distributed || isShared())
+    {
+        Image whole_image;
+        gatherImage(whole_image);
+
+        if (rank == ROOT)
+        {
+            whole_image.saveASCII(aFileName);
+        }
+    }
+    // Only the master is allowed to save
+    else if (rank == ROOT)
+    {
+        Image::saveASCII(aFileName);
+    }
+}
+
+
+//----------------------------------------------------
+void MPIImage::saveASCII(const std::string& aFileName)
+//----------------------------------------------------
+{
+    saveASCII(aFileName.data());
+}
+
+
+//----------------------------------
+bool MPIImage::isDistributed() const
+//----------------------------------
+{
+    return m_is_distributed;
+}
+
+
+//-----------------------------
+bool MPIImage::isShared() const
+//-----------------------------
+{
+    return (m_p_shared_buffer != nullptr);
+}
+
+
+//-----------------------------------------
+unsigned int MPIImage::getFirstRow() const
+//-----------------------------------------
+{
+    return m_first_row;
+}
+
+
+//---------------------------------------------
+unsigned int MPIImage::getNumberOfRows() const
+//---------------------------------------------
+{
+    return m_number_of_rows;
+}
+
+
+//----------------------------------------------
+void MPIImage::gatherImage(Image& anImage) const
+//----------------------------------------------
+{
+    // Get the process' rank
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+    // The filters have already assembled the image in the buffer of every
+    // node, only the master copies it
+    if (isShared())
+    {
+        if (rank == ROOT)
+        {
+            anImage = Image(getData(), m_width, m_height);
+        }
+        return;
+    }
+
+    // The filters have already assembled the image
+    if (!m_is_distributed)
+    {
+        anImage = *this;
+        return;
+    }
+
+    if (rank != ROOT)
+    {
+        gatherRows(nullptr);
+    }
+    else
+    {
+        // Reuse the memory of the image if it has the right size
+        if (anImage.getWidth() != m_width || anImage.getHeight() != m_height)
+        {
+            anImage = Image(m_width, m_height, NO_INIT);
+        }
+
+        gatherRows((m_width * m_height) ? &anImage[0] : nullptr);
+    }
+}
+
+
+//---------------------------------
+float MPIImage::getMinValue() const
+//---------------------------------
+{
+    float min_value, max_value;
+    getMinMaxValues(min_value, max_value);
+    return (min_value);
+}
+
+
+//---------------------------------
+float MPIImage::getMaxValue() const
+//---------------------------------
+{
+    float min_value, max_value;
+    getMinMaxValues(min_value, max_value);
+    return (max_value);
+}
+
+
+//-----------------------------------------------------------------------
+void MPIImage::getMinMaxValues(float& aMinValue, float& aMaxValue) const
+//-----------------------------------------------------------------------
+{
+    // The image is empty
+    if (!(m_width * m_height))
+    {
+        throw "Empty image";
+    }
+
+    // Only the master has the whole image (see gather()), it is sent to
+    // the other processes first
+    if (!hasLocalPart(1))
+    {
+        getWholeImage().getMinMaxValues(aMinValue, aMaxValue);
+        return;
+    }
+
+    // Get the work load
+    unsigned int pixel_start_id = 0;
+    unsigned int number_of_pixels = 0;
+    getLocalPixels(pixel_start_id, number_of_pixels);
+
+    // One (min, max) pair per thread
+    ParallelReduction<std::pair<float, float> > reduction(m_thread_number,
+            std::make_pair(std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity()));
+
+#pragma omp parallel for num_threads(reduction.size()) schedule(static)
+    for (unsigned int task_id = 0; task_id < reduction.size(); ++task_id)
+    {
+        unsigned int start_id, end_id;
+        reduction.getRange(number_of_pixels, task_id, start_id, end_id);
+
+        getImageKernels().getMinMax(getData() + pixel_start_id + start_id, end_id - start_id,
+                                    reduction[task_id].first, reduction[task_id].second);
+    }
+
+    std::pair<float, float> min_max = reduction.combine([](const std::pair<float, float>& a,
+                                                           const std::pair<float, float>& b)
+    {
+        return std::make_pair(std::min(a.first, b.first), std::max(a.second, b.second));
+    });
+
+    // Partial result, the max is negated so that both are reduced with
+    // MPI_MIN in a single call
+    float partial_set[2] = {min_max.first, -min_max.second};
+
+    float result_set[2];
+    allReduce(partial_set, result_set, 2, MPI_FLOAT, MPI_MIN);
+
+    aMinValue = result_set[0];
+    aMaxValue = -result_set[1];
+}
+
+
+//----------------------------
+float MPIImage::getSum() const
+//----------------------------
+{
+    // Only the master has the whole image (see gather()), it is sent to
+    // the other processes first
+    if (!hasLocalPart(1))
+    {
+        return (getWholeImage().getSum());
+    }
+
+    // Get the work load
+    unsigned int pixel_start_id = 0;
+    unsigned int number_of_pixels = 0;
+    getLocalPixels(pixel_start_id, number_of_pixels);
+
+    const float* p_input = getData() + pixel_start_id;
+
+    // Exact partial sums, the result does not depend on the number of
+    // processes and threads
+    if (m_summation_mode == REPRODUCIBLE_SUMMATION)
+    {
+        ParallelReduction<ReproducibleAccumulator> reduction(m_thread_number, ReproducibleAccumulator());
+
+#pragma omp parallel for num_threads(reduction.size()) schedule(static)
+        for (unsigned int task_id = 0; task_id < reduction.size(); ++task_id)
+        {
+            unsigned int start_id, end_id;
+            reduction.getRange(number_of_pixels, task_id, start_id, end_id);
+
+            getImageKernels().accumulate(p_input + start_id, end_id - start_id, reduction[task_id]);
+        }
+
+        return (allReduceSum(reduction.combine(std::plus<ReproducibleAccumulator>())));
+    }
+
+    // One partial sum per thread
+    ParallelReduction<float> reduction(m_thread_number, 0.0f);
+
+#pragma omp parallel for num_threads(reduction.size()) schedule(static)
+    for (unsigned int task_id = 0; task_id < reduction.size(); ++task_id)
+    {
+        unsigned int start_id, end_id;
+        reduction.getRange(number_of_pixels, task_id, start_id, end_id);
+
+        reduction[task_id] = getImageKernels().getSum(p_input + start_id, end_id - start_id);
+    }
+
+    return (allReduceSum(reduction.combine(std::plus<float>())));
+}
+
+
+//--------------------------------
+float MPIImage::getAverage() const
+//--------------------------------
+{
+    return (getSum() / (m_width * m_height));
+}
+
+
+//-----------------------------
+float MPIImage::getMean() const
+//-----------------------------
+{
+    return (getAverage());
+}
+
+
+//---------------------------------
+float MPIImage::getVariance() const
+//---------------------------------
+{
+    // Only the master has the whole image (see gather()), it is sent to
+    // the other processes first
+    if (!hasLocalPart(1))
+    {
+        return (getWholeImage().getVariance());
+    }
+
+    // A single collective
+    if (m_summation_mode == FAST_SUMMATION)
+    {
+        float min_value, max_value, average, variance;
+        getStatistics(min_value, max_value, average, variance);
+        return (variance);
+    }
+
+    float mean = getAverage();
+
+    // Get the work load
+    unsigned int pixel_start_id = 0;
+    unsigned int number_of_pixels = 0;
+    getLocalPixels(pixel_start_id, number_of_pixels);
+
+    // Exact partial sums, the result does not depend on the number of
+    // processes and threads
+    ParallelReduction<ReproducibleAccumulator> reduction(m_thread_number, ReproducibleAccumulator());
+
+#pragma omp parallel for num_threads(reduction.size()) schedule(static)
+    for (unsigned int task_id = 0; task_id < reduction.size(); ++task_id)
+    {
+        unsigned int start_id, end_id;
+        reduction.getRange(number_of_pixels, task_id, start_id, end_id);
+
+        getImageKernels().accumulateSquaredDifferences(getData() + pixel_start_id + start_id,
+                                                       end_id - start_id,
+                                                       mean,
+                                                       reduction[task_id]);
+    }
+
+    return (allReduceSum(reduction.combine(std::plus<ReproducibleAccumulator>())) / (m_width * m_height));
+}
+
+
+//-------------------------------
+float MPIImage::getStdDev() const
+//-------------------------------
+{
+    return (std::sqrt(getVariance()));
+}
+
+
+//-------------------------------------------------------
+void MPIImage::getStatistics(float& aMinValue,
+                             float& aMaxValue,
+                             float& anAverage,
+                             float& aVariance) const
+//-------------------------------------------------------
+{
+    // The image is empty
+    if (!(m_width * m_height))
+    {
+        throw "Empty image";
+    }
+
+    // Only the master has the whole image (see gather()), it is sent to
+    // the other processes first
+    if (!hasLocalPart(1))
+    {
+        getWholeImage().getStatistics(aMinValue, aMaxValue, anAverage, aVariance);
+        return;
+    }
+
+    // Get the work load
+    unsigned int pixel_start_id = 0;
+    unsigned int number_of_pixels = 0;
+    getLocalPixels(pixel_start_id, number_of_pixels);
+
+    // Statistics of the part of every thread, then of the process
+    const ImageKernels& kernels = getImageKernels();
+    const float* p_input = getData() + pixel_start_id;
+
+    PartialStatistics empty_statistics = {0.0,
+                                          std::numeric_limits<float>::infinity(),
+                                          -std::numeric_limits<float>::infinity(),
+                                          0.0,
+                                          0.0};
+
+    ParallelReduction<PartialStatistics> reduction(m_thread_number, empty_statistics);
+
+#pragma omp parallel for num_threads(reduction.size()) schedule(static)
+    for (unsigned int task_id = 0; task_id < reduction.size(); ++task_id)
+    {
+        unsigned int start_id, end_id;
+        reduction.getRange(number_of_pixels, task_id, start_id, end_id);
+
+        unsigned int size = end_id - start_id;
+        PartialStatistics& statistics = reduction[task_id];
+
+        float min_value, max_value;
+        kernels.getMinMax(p_input + start_id, size, min_value, max_value);
+
+        statistics.number_of_pixels = size;
+        statistics.min_value = min_value;
+        statistics.max_value = max_value;
+
+        if (size)
+        {
+            float mean = kernels.getSum(p_input + start_id, size) / size;
+
+            statistics.mean = mean;
+            statistics.m2 = kernels.getSumOfSquaredDifferences(p_input + start_id, size, mean);
+        }
+    }
+
+    PartialStatistics partial_statistics = reduction.combine([](const PartialStatistics& a,
+                                                                const PartialStatistics& b)
+    {
+        PartialStatistics statistics = b;
+        mergeStatistics(a, statistics);
+        return statistics;
+    });
+
+    // Merge the statistics of all the processes in one collective
+    MPI_Datatype statistics_type;
+    MPI_Op merge_operation;
+    checkMPIError(MPI_Type_contiguous(sizeof(PartialStatistics) / sizeof(double), MPI_DOUBLE, &statistics_type));
+    checkMPIError(MPI_Type_commit(&statistics_type));
+    checkMPIError(MPI_Op_create(mergeStatistics, 1, &merge_operation));
+
+    PartialStatistics statistics;
+    try
+    {
+        allReduce(&partial_statistics, &statistics, 1, statistics_type, merge_operation);
+    }
+    catch (...)
+    {
+        MPI_Op_free(&merge_operation);
+        MPI_Type_free(&statistics_type);
+        throw;
+    }
+
+    MPI_Op_free(&merge_operation);
+    MPI_Type_free(&statistics_type);
+
+    aMinValue = statistics.min_value;
+    aMaxValue = statistics.max_value;
+    anAverage = statistics.mean;
+    aVariance = statistics.m2 / statistics.number_of_pixels;
+}
+
+
+//-------------------------------------------------------------------
+unsigned int MPIImage::findFirstMismatch(const Image& anImage,
+                                         float aTolerance,
+                                         float& aMaxDifference) const
+//-------------------------------------------------------------------
+{
+    if (m_width != anImage.getWidth() || m_height != anImage.getHeight())
+    {
+        throw "The images have different sizes";
+    }
+
+    // Only the master has the whole image (see gather()), it is sent to
+    // the other processes first
+    if (!hasLocalPart(1))
+    {
+        return (getWholeImage().findFirstMismatch(anImage, aTolerance, aMaxDifference));
+    }
+
+    unsigned int number_of_pixels = m_width * m_height;
+
+    // Get the work load
+    unsigned int local_start_id = 0;
+    unsigned int number_of_local_pixels = 0;
+    getLocalPixels(local_start_id, number_of_local_pixels);
+
+    // Index of the first pixel of the part in the whole image
+    unsigned int pixel_start_id = m_first_row * m_width + local_start_id;
+
+    // Every process stops at the first mismatch of its part
+    float max_difference;
+    unsigned int mismatch_id = getImageKernels().compare(getData() + local_start_id,
+                                                         &anImage[0] + pixel_start_id,
+                                                         number_of_local_pixels,
+                                                         aTolerance, max_difference);
+
+    unsigned int partial_mismatch = (mismatch_id < number_of_local_pixels) ?
+            pixel_start_id + mismatch_id : number_of_pixels;
+
+    unsigned int first_mismatch;
+    allReduce(&partial_mismatch, &first_mismatch, 1, MPI_UNSIGNED, MPI_MIN);
+
+    // The parts after the first mismatch are ignored
+    if (pixel_start_id > first_mismatch)
+    {
+        max_difference = 0.0f;
+    }
+
+    allReduce(&max_difference, &aMaxDifference, 1, MPI_FLOAT, MPI_MAX);
+
+    return (first_mismatch);
+}
+
+
+//---------------------------------------------------
+bool MPIImage::operator==(const Image& anImage) const
+//---------------------------------------------------
+{
+    if (m_width != anImage.getWidth())
+    {
+        return (false);
+    }
+
+    if (m_height != anImage.getHeight())
+    {
+        return (false);
+    }
+
+    float max_difference;
+    return (findFirstMismatch(anImage, 1.0e-6, max_difference) == m_width * m_height);
+}
+
+
+//---------------------------------------------------
+bool MPIImage::operator!=(const Image& anImage) const
+//---------------------------------------------------
+{
+    return (!(operator==(anImage)));
+}
+
+
+//----------------------------------
+MPIImage MPIImage::operator!() const
+//----------------------------------
+{
+    // Only the master has the whole image (see gather()), it is sent to
+    // the other processes first
+    if (!hasLocalPart(1))
+    {
+        return (!getWholeImage());
+    }
+
+    float min_value, max_value;
+    getMinMaxValues(min_value, max_value);
+    float range(max_value - min_value);
+
+    // Process every pixel of the sub-image, taking care to preserve the
+    // dynamic of the image
+    void (*negate_kernel)(const float*, float*, unsigned int, float, float) = getImageKernels().negate;
+
+    return applyPointOperator([negate_kernel, min_value, range](const float* apInput, float* apOutput, unsigned int aSize)
+    {
+        negate_kernel(apInput, apOutput, aSize, min_value, range);
+    });
+}
+
+
+//----------------------------------------------------------
+MPIImage MPIImage::shiftScaleFilter(float aShiftValue,
+                                    float aScaleValue) const
+//----------------------------------------------------------
+{
+    // Apply the shift/scale filter to every pixel of the sub-image
+    void (*shift_scale_kernel)(const float*, float*, unsigned int, float, float) = getImageKernels().shiftScale;
+
+    return applyPointOperator([shift_scale_kernel, aShiftValue, aScaleValue](const float* apInput, float* apOutput, unsigned int aSize)
+    {
+        shift_scale_kernel(apInput, apOutput, aSize, aShiftValue, aScaleValue);
+    });
+}
+
+
+//--------------------------------------
+MPIImage MPIImage::getNormalised() const
+//--------------------------------------
+{
+    // Only the master has the whole image (see gather()), it is sent to
+    // the other processes first
+    if (!hasLocalPart(1))
+    {
+        return (getWholeImage().getNormalised());
+    }
+
+    float min_value, max_value;
+    getMinMaxValues(min_value, max_value);
+    return shiftScaleFilter(-min_value, 1.0 / (max_value - min_value));
+}
+
+
+//--------------------------------------
+MPIImage MPIImage::getNormalized() const
+//--------------------------------------
+{
+    return (getNormalised());
+}
+
+
+//----------------------------------
+MPIImage MPIImage::logFilter() const
+//----------------------------------
+{
+    // Apply the log filter to every pixel of the sub-image
+    const ImageKernels& kernels = getImageKernels();
+    void (*log_kernel)(const float*, float*, unsigned int) =
+            (m_log_mode == FAST_LOG) ? kernels.fastLog : kernels.log;
+
+    return applyPointOperator([log_kernel](const float* apInput, float* apOutput, unsigned int aSize)
+    {
+        log_kernel(apInput, apOutput, aSize);
+    });
+}
+
+
+//------------------------------------------------------------------------------------
+MPIImage MPIImage::applyPointFunction(PointFunction aFunction, float aParameter) const
+//------------------------------------------------------------------------------------
+{
+    // Apply the function to every pixel of the sub-image
+    return applyPointOperator([aFunction, aParameter](const float* apInput, float* apOutput, unsigned int aSize)
+    {
+        Image::applyPointFunction(aFunction, aParameter, apInput, apOutput, aSize);
+    });
+}
+
+
+//-----------------------------------------------------
+MPIImage MPIImage::applyLUT(const PointLUT& aLUT) const
+//-----------------------------------------------------
+{
+    // Look up the new value of every pixel of the sub-image
+    void (*lut_kernel)(const float*, float*, unsigned int, const float*, unsigned int) = getImageKernels().applyLUT;
+    const float* p_table = aLUT.getTable().data();
+    unsigned int number_of_entries = aLUT.getNumberOfEntries();
+
+    return applyPointOperator([lut_kernel, p_table, number_of_entries](const float* apInput, float* apOutput, unsigned int aSize)
+    {
+        lut_kernel(apInput, apOutput, aSize, p_table, number_of_entries);
+    });
+}
+
+
+//----------------------------------
+PointLUT MPIImage::createLUT() const
+//----------------------------------
+{
+    // Only the master has the whole image (see gather()), it is sent to
+    // the other processes first
+    if (!hasLocalPart(1))
+    {
+        return (getWholeImage().createLUT());
+    }
+
+    // Get the work load
+    unsigned int pixel_start_id = 0;
+    unsigned int number_of_pixels = 0;
+    getLocalPixels(pixel_start_id, number_of_pixels);
+
+    // Every process records the values of its part
+    std::vector<char> occurrence_set;
+    int is_valid = 1;
+
+    try
+    {
+        occurrence_set = PointLUT::getOccurrenceSet(getData() + pixel_start_id, number_of_pixels);
+    }
+    catch (const char*)
+    {
+        occurrence_set.assign(PointLUT::UINT16_SIZE, 0);
+        is_valid = 0;
+    }
+
+    // Every process must have valid values
+    int are_all_valid;
+    allReduce(&is_valid, &are_all_valid, 1, MPI_INT, MPI_MIN);
+
+    if (!are_all_valid)
+    {
+        throw "The pixel values are not integers in [0, 65535], a lookup table cannot be used";
+    }
+
+    // The values that occur in any part
+    allReduce(MPI_IN_PLACE, occurrence_set.data(), occurrence_set.size(), MPI_SIGNED_CHAR, MPI_MAX);
+
+    return PointLUT(occurrence_set);
+}
+
+
+//------------------------------------------------------
+MPIImage MPIImage::boxFilter(unsigned int aRadius) const
+//------------------------------------------------------
+{
+    // Average of the neighbourhood of every pixel, row by row
+    int radius = aRadius;
+    float scale = 1.0f / ((2 * radius + 1) * (2 * radius + 1));
+
+    return applyNeighbourhoodOperator(aRadius, [radius, scale](const float* apInput,
+                                                               unsigned int aStride,
+                                                               float* apOutput,
+                                                               unsigned int aSize)
+    {
+        for (unsigned int x = 0; x < aSize; ++x)
+        {
+            float sum = 0.0f;
+
+            for (int dy = -radius; dy <= radius; ++dy)
+            {
+                const float* p_row = apInput + x + dy * int(aStride);
+
+                for (int dx = -radius; dx <= radius; ++dx)
+                {
+                    sum += p_row[dx];
+                }
+            }
+
+            apOutput[x] = sum * scale;
+        }
+    });
+}
+
+
+//-----------------------------------------
+MPIImage MPIImage::flipHorizontally() const
+//-----------------------------------------
+{
+    // Only the master has the whole image (see gather()), it is sent to
+    // the other processes first, unless they have their rows
+    if (!hasLocalPart(m_width))
+    {
+        return (getWholeImage().flipHorizontally());
+    }
+
+    // Create an image of the right size, or a block of the same rows if
+    // the image is distributed. Every process writes its sub-image below,
+    // then the sub-images of a replicated image are assembled
+    MPIImage temp(*this, NO_INIT);
+
+    // Reverse every row of a set of rows, shared between the threads
+    auto reverse_rows = [this, &temp](unsigned int aStartID, unsigned int aNumberOfRows)
+    {
+        forEachTask(aStartID, aNumberOfRows, [this, &temp](unsigned int aTaskStartID, unsigned int aTaskSize)
+        {
+            for (unsigned int y = aTaskStartID; y < aTaskStartID + aTaskSize; ++y)
+            {
+                getImageKernels().reverseRow(getData() + y * m_width, temp.getData() + y * m_width, m_width);
+            }
+        });
+    };
+
+    // The whole block of the process
+    if (m_is_distributed)
+    {
+        reverse_rows(0, m_number_of_rows);
+    }
+    // The part of the process, whole rows are given to every process, then
+    // the sub-images are assembled
+    else
+    {
+        computeAndGather(temp, m_height, m_width, reverse_rows);
+    }
+
+    return temp;
+}
+
+
+//---------------------------------------
+MPIImage MPIImage::flipVertically() const
+//---------------------------------------
+{
+    // Only the master has the whole image (see gather()), it is sent to
+    // the other processes first: the mirrored rows are read
+    if (!hasLocalPart(0))
+    {
+        return (getWholeImage().flipVertically());
+    }
+
+    // Create an image of the right size, or a block of the same size if
+    // the image is distributed. Every process writes its sub-image below,
+    // then the sub-images of a replicated image are assembled
+    MPIImage temp(*this, NO_INIT);
+
+    // The output block of a distributed image holds the mirrored rows of
+    // the input block, so no pixel is exchanged between the processes
+    if (m_is_distributed)
+    {
+        temp.m_first_row = m_height - m_first_row - m_number_of_rows;
+    }
+
+    // Copy every row of a set of rows from its mirrored position, shared
+    // between the threads. The row y of the output is the row
+    // m_height - 1 - y of the whole image, both are shifted by the first
+    // row of their block
+    auto copy_mirrored_rows = [this, &temp](unsigned int aStartID, unsigned int aNumberOfRows)
+    {
+        forEachTask(aStartID, aNumberOfRows, [this, &temp](unsigned int aTaskStartID, unsigned int aTaskSize)
+        {
+            for (unsigned int y = aTaskStartID; y < aTaskStartID + aTaskSize; ++y)
+            {
+                unsigned int mirrored_y = m_height - 1 - (temp.m_first_row + y) - m_first_row;
+
+                std::memcpy(temp.getData() + y * m_width,
+                            getData() + mirrored_y * m_width,
+                            m_width * sizeof(float));
+            }
+        });
+    };
+
+    // The whole block of the process
+    if (m_is_distributed)
+    {
+        copy_mirrored_rows(0, m_number_of_rows);
+    }
+    // The part of the process, whole rows are given to every process, then
+    // the sub-images are assembled
+    else
+    {
+        computeAndGather(temp, m_height, m_width, copy_mirrored_rows);
+    }
+
+    return temp;
+}
+
+
+//-------------------------------------------
+MPIImage& MPIImage::flipHorizontallyInPlace()
+//-------------------------------------------
+{
+    // Every process reverses its rows in the buffer of its node, once the
+    // other processes have stopped reading it, then the node leaders
+    // exchange the rows of their nodes
+    if (isShared())
+    {
+        m_p_shared_buffer->synchronise();
+
+        std::vector<int> count_set;
+        std::vector<int> displacement_set;
+        getWorkloads(m_height, 1, count_set, displacement_set);
+
+        int process_id = getWorkloadID();
+
+        for (int y = displacement_set[process_id]; y < displacement_set[process_id] + count_set[process_id]; ++y)
+        {
+            getImageKernels().reverseRowInPlace(getData() + y * m_width, m_width);
+        }
+
+        exchangeNodeParts(m_height, m_width);
+        return *this;
+    }
+
+    // Every process holds the whole image, once the master has sent it if
+    // only the master has it (see gather())
+    if (!m_is_distributed)
+    {
+        if (!hasLocalPart(m_width))
+        {
+            broadcast(getData(), m_width * m_height);
+            m_part_element_size = 0;
+        }
+
+        Image::flipHorizontallyInPlace();
+        return *this;
+    }
+
+    // Reverse every row of the block
+    for (unsigned int y = 0; y < m_number_of_rows; ++y)
+    {
+        getImageKernels().reverseRowInPlace(m_p_image.data() + y * m_width, m_width);
+    }
+
+    return *this;
+}
+
+
+//-----------------------------------------
+MPIImage& MPIImage::flipVerticallyInPlace()
+//-----------------------------------------
+{
+    // The rows of the other processes are read, so the output is written
+    // in a new buffer
+    if (isShared())
+    {
+        MPIImage temp = flipVertically();
+        swapImage(temp);
+        return *this;
+    }
+
+    // Every process holds the whole image, once the master has sent it if
+    // only the master has it (see gather())
+    if (!m_is_distributed)
+    {
+        if (!hasLocalPart(0))
+        {
+            broadcast(getData(), m_width * m_height);
+            m_part_element_size = 0;
+        }
+
+        Image::flipVerticallyInPlace();
+        return *this;
+    }
+
+    // The block becomes the mirrored block: its rows are reversed, no
+    // pixel is exchanged between the processes
+    for (unsigned int y = 0; y < m_number_of_rows / 2; ++y)
+    {
+        std::swap_ranges(m_p_image.begin() + y * m_width,
+                         m_p_image.begin() + (y + 1) * m_width,
+                         m_p_image.begin() + (m_number_of_rows - y - 1) * m_width);
+    }
+
+    m_first_row = m_height - m_first_row - m_number_of_rows;
+
+    return *this;
+}
+
+
+//-----------------------------------------------------
+void MPIImage::workload(unsigned int aNumberOfElements,
+                        unsigned int& aStartID,
+                        unsigned int& aEndID) const
+//-----------------------------------------------------
+{
+    int world_size;
+    int rank;
+
+    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+    int last_element = -1;
+    unsigned int element_per_task = aNumberOfElements / world_size;
+    unsigned int remainder = aNumberOfElements % world_size;
+
+    for (int i = 0; i < world_size; ++i)
+    {
+        aStartID = ++last_element;
+        aEndID = last_element + element_per_task - 1;
+
+        if (remainder > 0)
+        {
+            aEndID++;
+            --remainder;
+        }
+        last_element = aEndID;
+
+        // Exit the method
+        if (rank == i) return;
+    }
+}
+
+
+//---------------------------------------------------------------
+void MPIImage::getLocalPixels(unsigned int& aStartID,
+                              unsigned int& aNumberOfPixels) const
+//---------------------------------------------------------------
+{
+    // The whole block of the process
+    if (m_is_distributed)
+    {
+        aStartID = 0;
+        aNumberOfPixels = m_p_image.size();
+    }
+    // The part of the process, the parts of the processes of a node are
+    // consecutive if the image is shared
+    else if (isShared())
+    {
+        std::vector<int> count_set;
+        std::vector<int> displacement_set;
+        getWorkloads(m_width * m_height, 1, count_set, displacement_set);
+
+        aStartID = displacement_set[getWorkloadID()];
+        aNumberOfPixels = count_set[getWorkloadID()];
+    }
+    // The part of the process
+    else
+    {
+        unsigned int end_id = 0;
+        workload(m_width * m_height, aStartID, end_id);
+        aNumberOfPixels = end_id - aStartID + 1;
+    }
+}
+
+
+//---------------------------------
+int MPIImage::getWorkloadID() const
+//---------------------------------
+{
+    if (isShared())
+    {
+        return MPINodeTopology::getInstance().getProcessIndex();
+    }
+
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    return rank;
+}
+
+
+//------------------------------------------------------------
+bool MPIImage::hasLocalPart(unsigned int anElementSize) const
+//------------------------------------------------------------
+{
+    return (!m_part_element_size || m_part_element_size == anElementSize);
+}
+
+
+//--------------------------------------
+MPIImage MPIImage::getWholeImage() const
+//--------------------------------------
+{
+    MPIImage temp(*this);
+    broadcast(temp.getData(), m_width * m_height);
+    temp.m_part_element_size = 0;
+
+    return temp;
+}
+
+
+//-------------------------------------------------------------------
+void MPIImage::getWorkloads(unsigned int aNumberOfElements,
+                            unsigned int anElementSize,
+                            std::vector<int>& aCountSet,
+                            std::vector<int>& aDisplacementSet) const
+//-------------------------------------------------------------------
+{
+    int world_size;
+    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+
+    unsigned int element_per_task = aNumberOfElements / world_size;
+    unsigned int remainder = aNumberOfElements % world_size;
+
+    aCountSet.resize(world_size);
+    aDisplacementSet.resize(world_size);
+
+    // The first processes get one more element, as in workload()
+    unsigned int start_id = 0;
+    for (int i = 0; i < world_size; ++i)
+    {
+        unsigned int number_of_elements = element_per_task + (unsigned(i) < remainder ? 1 : 0);
+
+        aCountSet[i] = number_of_elements * anElementSize;
+        aDisplacementSet[i] = start_id * anElementSize;
+
+        start_id += number_of_elements;
+    }
+}
+
+
+//-----------------------------------------------------
+void MPIImage::gather(MPIImage& anImage,
+                      unsigned int aNumberOfElements,
+                      unsigned int anElementSize) const
+//-----------------------------------------------------
+{
+    // Get the process' rank
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+    // The sub-image of every process
+    std::vector<int> count_set;
+    std::vector<int> displacement_set;
+    getWorkloads(aNumberOfElements, anElementSize, count_set, displacement_set);
+
+    float* p_data = anImage.m_p_image.data();
+
+    // Only the master has the whole image, except with ALLGATHERV and
+    // DYNAMIC: the other processes have the part of this workload
+    anImage.m_part_element_size = (m_gather_mode == ALLGATHERV || m_gather_mode == DYNAMIC) ? 0 : anElementSize;
+
+    bool is_collective = (m_gather_mode == GATHERV ||
+                          m_gather_mode == PIPELINED ||
+                          m_gather_mode == ALLGATHERV ||
+                          m_gather_mode == DYNAMIC);
+
+    // The sub-images reach the master node by node, then every process gets
+    // the whole image with ALLGATHERV, as with DYNAMIC
+    if (is_collective && m_collective_mode == HIERARCHICAL)
+    {
+        MPINodeTopology::getInstance().gatherv(p_data + displacement_set[rank], count_set[rank],
+                                               p_data, count_set.data(), displacement_set.data());
+
+        if (m_gather_mode == ALLGATHERV || m_gather_mode == DYNAMIC)
+        {
+            broadcast(p_data, aNumberOfElements * anElementSize);
+        }
+    }
+    // A single collective, the sub-image of the process is already in place.
+    // A sub-image computed at once is also sent in one piece by PIPELINED
+    else if (m_gather_mode == GATHERV || m_gather_mode == PIPELINED)
+    {
+        if (rank == ROOT)
+        {
+            checkMPIError(MPI_Gatherv(MPI_IN_PLACE, 0, MPI_FLOAT,
+                                      p_data, count_set.data(), displacement_set.data(), MPI_FLOAT,
+                                      ROOT, MPI_COMM_WORLD));
+        }
+        else
+        {
+            checkMPIError(MPI_Gatherv(p_data + displacement_set[rank], count_set[rank], MPI_FLOAT,
+                                      nullptr, nullptr, nullptr, MPI_FLOAT,
+                                      ROOT, MPI_COMM_WORLD));
+        }
+    }
+    // The same, and every process gets the whole image, as with DYNAMIC
+    else if (m_gather_mode == ALLGATHERV || m_gather_mode == DYNAMIC)
+    {
+        checkMPIError(MPI_Allgatherv(MPI_IN_PLACE, 0, MPI_FLOAT,
+                                     p_data, count_set.data(), displacement_set.data(), MPI_FLOAT,
+                                     MPI_COMM_WORLD));
+    }
+    // Master gather results from all the processes
+    else if (rank == ROOT)
+    {
+        int world_size;
+        MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+
+        for (int i = 1; i < world_size; ++i)
+        {
+            int pixel_start_id;
+            int pixel_end_id;
+
+            MPI_Status status;
+
+            checkMPIError(MPI_Recv(&pixel_start_id, 1, MPI_INT, i, 0, MPI_COMM_WORLD, &status));
+            checkMPIError(MPI_Recv(&pixel_end_id, 1, MPI_INT, i, 1, MPI_COMM_WORLD, &status));
+            checkMPIError(MPI_Recv(p_data + pixel_start_id, pixel_end_id - pixel_start_id + 1, MPI_FLOAT, i, 2, MPI_COMM_WORLD, &status));
+        }
+    }
+    // Other processes send the data to the master
+    else
+    {
+        int pixel_start_id = displacement_set[rank];
+        int pixel_end_id = displacement_set[rank] + count_set[rank] - 1;
+
+        checkMPIError(MPI_Send(&pixel_start_id, 1, MPI_INT, ROOT, 0, MPI_COMM_WORLD));
+        checkMPIError(MPI_Send(&pixel_end_id,   1, MPI_INT, ROOT, 1, MPI_COMM_WORLD));
+        checkMPIError(MPI_Send(p_data + pixel_start_id, count_set[rank], MPI_FLOAT, ROOT, 2, MPI_COMM_WORLD));
+    }
+}
+
+
+//---------------------------------------------
+void MPIImage::gatherRows(float* apImage) const
+//---------------------------------------------
+{
+    int world_size;
+    int rank;
+
+    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+    // The index of the first pixel and the number of pixels of every block,
+    // the blocks are not always in rank order (see flipVertically())
+    int block[2] = {int(m_first_row * m_width), int(m_p_image.size())};
+    std::vector<int> block_set(rank == ROOT ? 2 * world_size : 0);
+
+    checkMPIError(MPI_Gather(block, 2, MPI_INT, block_set.data(), 2, MPI_INT, ROOT, MPI_COMM_WORLD));
+
+    std::vector<int> count_set;
+    std::vector<int> displacement_set;
+
+    for (unsigned int i = 0; i < block_set.size(); i += 2)
+    {
+        displacement_set.push_back(block_set[i]);
+        count_set.push_back(block_set[i + 1]);
+    }
+
+    if (m_collective_mode == HIERARCHICAL)
+    {
+        MPINodeTopology::getInstance().gatherv(m_p_image.data(), m_p_image.size(),
+                                               apImage, count_set.data(), displacement_set.data());
+    }
+    else
+    {
+        checkMPIError(MPI_Gatherv(m_p_image.data(), m_p_image.size(), MPI_FLOAT,
+                                  apImage, count_set.data(), displacement_set.data(), MPI_FLOAT,
+                                  ROOT, MPI_COMM_WORLD));
+    }
+}
+
+
+//------------------------------------------------
+void MPIImage::allReduce(const void* apInput,
+                         void* apOutput,
+                         int aCount,
+                         MPI_Datatype aType,
+                         MPI_Op anOperation) const
+//------------------------------------------------
+{
+    if (m_collective_mode == HIERARCHICAL)
+    {
+        MPINodeTopology::getInstance().allReduce(apInput, apOutput, aCount, aType, anOperation);
+    }
+    else
+    {
+        checkMPIError(MPI_Allreduce(apInput, apOutput, aCount, aType, anOperation, MPI_COMM_WORLD));
+    }
+}
+
+
+//----------------------------------------------------------------
+void MPIImage::broadcast(float* apData, unsigned int aCount) const
+//----------------------------------------------------------------
+{
+    if (m_collective_mode == HIERARCHICAL)
+    {
+        MPINodeTopology::getInstance().broadcast(apData, aCount);
+    }
+    else
+    {
+        checkMPIError(MPI_Bcast(apData, aCount, MPI_FLOAT, ROOT, MPI_COMM_WORLD));
+    }
+}
+
+
+//----------------------------------------------------------
+template<typename TaskOperation>
+void MPIImage::forEachTask(unsigned int aStartID,
+                           unsigned int aNumberOfElements,
+                           TaskOperation anOperation) const
+//----------------------------------------------------------
+{
+    // A single thread, no parallel region
+    if (m_thread_number <= 1)
+    {
+        anOperation(aStartID, aNumberOfElements);
+        return;
+    }
+
+    // Consecutive elements per thread. MPI is only called outside the
+    // parallel regions (MPI_THREAD_FUNNELED)
+#pragma omp parallel for num_threads(m_thread_number) schedule(static)
+    for (unsigned int task_id = 0; task_id < m_thread_number; ++task_id)
+    {
+        unsigned int start_id, end_id;
+        getTaskRange(aNumberOfElements, m_thread_number, task_id, start_id, end_id);
+
+        if (end_id > start_id)
+        {
+            anOperation(aStartID + start_id, end_id - start_id);
+        }
+    }
+}
+
+
+//---------------------------------------------
+template<typename LoadFunction>
+void MPIImage::load(LoadFunction aLoadFunction)
+//---------------------------------------------
+{
+    // Every process loads the whole image
+    if (m_distribution_mode == REPLICATED)
+    {
+        m_p_shared_buffer.reset();
+        aLoadFunction(*this);
+
+        m_is_distributed = false;
+        m_first_row = 0;
+        m_part_element_size = 0;
+        m_number_of_rows = m_height;
+        return;
+    }
+
+    // Get the process' rank
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+    // Only the master reads the file, an error is sent to the other
+    // processes as an empty image
+    Image whole_image;
+    std::string error;
+
+    if (rank == ROOT)
+    {
+        try
+        {
+            aLoadFunction(whole_image);
+        }
+        catch (const std::exception& anError)
+        {
+            error = anError.what();
+        }
+        catch (const std::string& anError)
+        {
+            error = anError;
+        }
+        catch (const char* apError)
+        {
+            error = apError;
+        }
+    }
+
+    unsigned int size_set[2] = {whole_image.getWidth(), whole_image.getHeight()};
+    checkMPIError(MPI_Bcast(size_set, 2, MPI_UNSIGNED, ROOT, MPI_COMM_WORLD));
+
+    if (!(size_set[0] * size_set[1]))
+    {
+        if (rank == ROOT && error.size())
+        {
+            throw error;
+        }
+
+        throw (rank == ROOT) ? "Empty image" : "The master process could not load the image";
+    }
+
+    destroy();
+    PixelVector().swap(m_p_image);
+    m_p_shared_buffer.reset();
+    m_width = size_set[0];
+    m_height = size_set[1];
+
+    // One copy per node: the master copies the image in the buffer of its
+    // node, then broadcasts it to the other node leaders only
+    if (m_distribution_mode == SHARED)
+    {
+        m_p_shared_buffer.reset(new MPISharedBuffer(m_width * m_height));
+
+        m_is_distributed = false;
+        m_first_row = 0;
+        m_part_element_size = 0;
+        m_number_of_rows = m_height;
+
+        if (rank == ROOT)
+        {
+            std::memcpy(getData(), &whole_image[0], m_width * m_height * sizeof(float));
+        }
+
+        const MPINodeTopology& topology = MPINodeTopology::getInstance();
+
+        if (topology.isLeader())
+        {
+            checkMPIError(MPI_Bcast(getData(), m_width * m_height, MPI_FLOAT, ROOT, topology.getLeaderCommunicator()));
+        }
+
+        // The other processes of the node can read the image
+        m_p_shared_buffer->synchronise();
+        return;
+    }
+
+    // Blocks of whole rows, in the same order as workload()
+    std::vector<int> count_set;
+    std::vector<int> displacement_set;
+    getWorkloads(m_height, m_width, count_set, displacement_set);
+
+    m_p_image = PixelVector(count_set[rank]);
+
+    m_is_distributed = true;
+    m_part_element_size = 0;
+    m_first_row = displacement_set[rank] / m_width;
+    m_number_of_rows = count_set[rank] / m_width;
+
+    // Every process receives only its rows
+    checkMPIError(MPI_Scatterv((rank == ROOT) ? &whole_image[0] : nullptr,
+                               count_set.data(), displacement_set.data(), MPI_FLOAT,
+                               m_p_image.data(), count_set[rank], MPI_FLOAT,
+                               ROOT, MPI_COMM_WORLD));
+}
+
+
+//------------------------------------------------------------------------
+template<typename BlockOperation>
+MPIImage MPIImage::applyPointOperator(BlockOperation anOperation) const
+//------------------------------------------------------------------------
 {
-    // Get the process' rank
-    int rank;
-    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    // Only the master has the whole image (see gather()), it is sent to
+    // the other processes first
+    if (!hasLocalPart(1))
+    {
+        return (getWholeImage().applyPointOperator(anOperation));
+    }
 
-    // Only the master is allowed to save
-    if (rank == ROOT)
+    // Create an image of the right size, or a block of the same rows if
+    // the image is distributed. Every process writes its sub-image below,
+    // then the sub-images of a replicated image are assembled
+    MPIImage temp(*this, NO_INIT);
+
+    // Apply the operator to a range of pixels, shared between the threads
+    auto apply_operator = [this, &temp, &anOperation](unsigned int aStartID, unsigned int aNumberOfPixels)
     {
-        Image::saveASCII(aFileName);
+        forEachTask(aStartID, aNumberOfPixels, [this, &temp, &anOperation](unsigned int aTaskStartID,
+                                                                           unsigned int aTaskSize)
+        {
+            anOperation(getData() + aTaskStartID, temp.getData() + aTaskStartID, aTaskSize);
+        });
+    };
+
+    // The whole block of the process
+    if (m_is_distributed)
+    {
+        apply_operator(0, m_p_image.size());
+    }
+    // The part of the process, then the sub-images are assembled
+    else
+    {
+        computeAndGather(temp, m_width * m_height, 1, apply_operator);
     }
+
+    return temp;
 }
 
 
-//----------------------------------
-MPIImage MPIImage::operator!() const
-//----------------------------------
+//--------------------------------------------------------------------------------------
+template<typename NeighbourhoodOperation>
+MPIImage MPIImage::applyNeighbourhoodOperator(unsigned int aRadius,
+                                              NeighbourhoodOperation anOperation) const
+//--------------------------------------------------------------------------------------
 {
-    // Create an image of the right size
-    MPIImage temp(getWidth(), getHeight(), 0.0);
+    // Only the master has the whole image (see gather()), it is sent to
+    // the other processes first: the halo is read
+    if (!hasLocalPart(0))
+    {
+        return (getWholeImage().applyNeighbourhoodOperator(aRadius, anOperation));
+    }
 
-    float min_value(getMinValue());
-    float max_value(getMaxValue());
-    float range(max_value - min_value);
+    // Create an image of the right size, or a block of the same rows if
+    // the image is distributed
+    MPIImage temp(*this, NO_INIT);
 
-    // Get the work load
-    unsigned int pixel_start_id = 0;
-    unsigned int pixel_end_id = 0;
-    workload(m_width * m_height, pixel_start_id, pixel_end_id);
+    // The 2-D block of this process and its halo
+    MPIBlockDecomposition decomposition(m_width, m_height, aRadius);
 
-    // Process every pixel of the sub-image
-    for (unsigned int i = pixel_start_id; i <= pixel_end_id; ++i)
+    PixelVector padded_block(decomposition.getPaddedSize());
+    PixelVector output_block(decomposition.getBlockWidth() * decomposition.getBlockHeight());
+
+    // Every process has the whole image, or only its rows
+    if (m_is_distributed)
+    {
+        decomposition.rowsToBlock(m_p_image.data(), m_first_row, m_number_of_rows, padded_block.data());
+    }
+    else
     {
-        // Take care to preserve the dynamic of the image
-        temp[i] = min_value + range * (1.0 - (m_p_image[i] - min_value) / range);
+        decomposition.copyBlock(getData(), padded_block.data());
     }
 
-    // Get the process' rank
-    int rank;
-    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    // The inner pixels are computed during the exchange of the halo, the
+    // rows are shared between the threads
+    decomposition.apply(padded_block.data(), output_block.data(), anOperation, m_thread_number);
 
-    // Master gather results from all the processes
-    if (rank == ROOT)
+    // The output keeps the rows of the input
+    if (m_is_distributed)
     {
-        int world_size;
-        MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+        decomposition.blockToRows(output_block.data(), temp.m_p_image.data(), temp.m_first_row, temp.m_number_of_rows);
+    }
+    // The part of every process (see workload()), then the parts are
+    // assembled as the ones of the other filters, or exchanged between the
+    // nodes if the image is shared
+    else
+    {
+        int process_id = getWorkloadID();
 
-        for (int i = 1; i < world_size; ++i)
-        {
-            int pixel_start_id;
-            int pixel_end_id;
+        std::vector<int> count_set;
+        std::vector<int> displacement_set;
+        getWorkloads(m_height, m_width, count_set, displacement_set);
 
-            MPI_Status status;
+        decomposition.blockToRows(output_block.data(),
+                                  temp.getData() + displacement_set[process_id],
+                                  displacement_set[process_id] / m_width,
+                                  count_set[process_id] / m_width);
 
-            checkMPIError(MPI_Recv(&pixel_start_id, 1, MPI_INT, i, 0, MPI_COMM_WORLD, &status));
-            checkMPIError(MPI_Recv(&pixel_end_id, 1, MPI_INT, i, 1, MPI_COMM_WORLD, &status));
-            checkMPIError(MPI_Recv(&temp[pixel_start_id], pixel_end_id - pixel_start_id + 1, MPI_FLOAT, i, 2, MPI_COMM_WORLD, &status));
+        if (isShared())
+        {
+            temp.exchangeNodeParts(m_height, m_width);
+        }
+        else
+        {
+            gather(temp, m_height, m_width);
         }
-    }
-    // Other processes send the data to the master
-    else
-    {
-        checkMPIError(MPI_Send(&pixel_start_id, 1, MPI_INT, ROOT, 0, MPI_COMM_WORLD));
-        checkMPIError(MPI_Send(&pixel_end_id,   1, MPI_INT, ROOT, 1, MPI_COMM_WORLD));
-        checkMPIError(MPI_Send(&temp[pixel_start_id], pixel_end_id - pixel_start_id + 1, MPI_FLOAT, ROOT, 2, MPI_COMM_WORLD));
     }
 
     return temp;
 }
 
 
-//----------------------------------------------------------
-MPIImage MPIImage::shiftScaleFilter(float aShiftValue,
-                                    float aScaleValue) const
-//----------------------------------------------------------
+//-------------------------------------------------------------------
+template<typename ChunkOperation>
+void MPIImage::computeAndGather(MPIImage& anImage,
+                                unsigned int aNumberOfElements,
+                                unsigned int anElementSize,
+                                ChunkOperation anOperation) const
+//-------------------------------------------------------------------
 {
-    // Create an image of the right size
-    MPIImage temp(getWidth(), getHeight(), 0.0);
-
-    // Get the work load
-    unsigned int pixel_start_id = 0;
-    unsigned int pixel_end_id = 0;
-    workload(m_width * m_height, pixel_start_id, pixel_end_id);
-
-    // Process every pixel of the sub-image
-    for (unsigned int i = pixel_start_id; i <= pixel_end_id; ++i)
+    // The sub-images are not fixed, every process takes tiles from a
+    // counter held by the master
+    if (m_gather_mode == DYNAMIC && !isShared())
     {
-        // Apply the shilft/scale filter
-        temp[i] = (m_p_image[i] + aShiftValue) * aScaleValue;
+        computeTiles(anImage, aNumberOfElements, anElementSize, anOperation);
+        return;
     }
 
     // Get the process' rank
+    int world_size;
     int rank;
+
+    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
 
-    // Master gather results from all the processes
-    if (rank == ROOT)
-    {
-        int world_size;
-        MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+    // The sub-image of every process
+    std::vector<int> count_set;
+    std::vector<int> displacement_set;
+    getWorkloads(aNumberOfElements, anElementSize, count_set, displacement_set);
 
-        for (int i = 1; i < world_size; ++i)
-        {
-            int pixel_start_id;
-            int pixel_end_id;
+    int process_id = getWorkloadID();
+    unsigned int element_start_id = displacement_set[process_id] / anElementSize;
+    unsigned int number_of_elements = count_set[process_id] / anElementSize;
 
-            MPI_Status status;
+    double start = MPI_Wtime();
 
-            checkMPIError(MPI_Recv(&pixel_start_id, 1, MPI_INT, i, 0, MPI_COMM_WORLD, &status));
-            checkMPIError(MPI_Recv(&pixel_end_id, 1, MPI_INT, i, 1, MPI_COMM_WORLD, &status));
-            checkMPIError(MPI_Recv(&temp[pixel_start_id], pixel_end_id - pixel_start_id + 1, MPI_FLOAT, i, 2, MPI_COMM_WORLD, &status));
-        }
-    }
-    // Other processes send the data to the master
-    else
+    // Compute the whole sub-image, then assemble the sub-images. The
+    // processes of a node write a shared output directly, only the parts
+    // of the nodes are exchanged
+    if (m_gather_mode != PIPELINED || isShared())
     {
+        anOperation(element_start_id, number_of_elements);
+        m_number_of_computed_pixels += number_of_elements * anElementSize;
 
-        checkMPIError(MPI_Send(&pixel_start_id, 1, MPI_INT, ROOT, 0, MPI_COMM_WORLD));
-        checkMPIError(MPI_Send(&pixel_end_id,   1, MPI_INT, ROOT, 1, MPI_COMM_WORLD));
-        checkMPIError(MPI_Send(&temp[pixel_start_id], pixel_end_id - pixel_start_id + 1, MPI_FLOAT, ROOT, 2, MPI_COMM_WORLD));
-    }
+        double end = MPI_Wtime();
 
-    return temp;
-}
+        if (isShared())
+        {
+            anImage.exchangeNodeParts(aNumberOfElements, anElementSize);
+        }
+        else
+        {
+            gather(anImage, aNumberOfElements, anElementSize);
+        }
 
+        m_compute_time += end - start;
+        m_wait_time += MPI_Wtime() - end;
+        return;
+    }
 
-//----------------------------------
-MPIImage MPIImage::logFilter() const
-//----------------------------------
-{
-    // Create an image of the right size
-    MPIImage temp(getWidth(), getHeight(), 0.0);
+    // Number of elements per chunk, at least one
+    unsigned int chunk_size = std::max(1u, m_chunk_size / anElementSize);
 
-    // Get the work load
-    unsigned int pixel_start_id = 0;
-    unsigned int pixel_end_id = 0;
-    workload(m_width * m_height, pixel_start_id, pixel_end_id);
+    float* p_data = anImage.m_p_image.data();
+    std::vector<MPI_Request> request_set;
 
-    // Process every pixel of the sub-image
-    for (unsigned int i = pixel_start_id; i <= pixel_end_id; ++i)
+    // The master receives every chunk of the other processes directly in
+    // place. The chunks of a process are matched in the order they are sent
+    if (rank == ROOT)
     {
-        // Apply the log filter
-        temp[i] = log(m_p_image[i]);
+        for (int i = 0; i < world_size; ++i)
+        {
+            if (i == ROOT) continue;
+
+            unsigned int first_element = displacement_set[i] / anElementSize;
+            unsigned int last_element = first_element + count_set[i] / anElementSize;
+
+            for (unsigned int j = first_element; j < last_element; j += chunk_size)
+            {
+                unsigned int size = std::min(chunk_size, last_element - j) * anElementSize;
+
+                request_set.push_back(MPI_REQUEST_NULL);
+                checkMPIError(MPI_Irecv(p_data + j * anElementSize, size, MPI_FLOAT,
+                                        i, CHUNK_TAG, MPI_COMM_WORLD, &request_set.back()));
+            }
+        }
     }
 
-    // Get the process' rank
-    int rank;
-    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    // Compute the chunks of the process, every chunk of the other processes
+    // is sent as soon as it is computed. The completed receives of the
+    // master are drained between its chunks, which also lets MPI progress
+    double compute_time = 0.0;
 
-    // Master gather results from all the processes
-    if (rank == ROOT)
+    std::vector<int> index_set(request_set.size());
+    int number_of_completed_requests;
+
+    for (unsigned int j = element_start_id; j < element_start_id + number_of_elements; j += chunk_size)
     {
-        int world_size;
-        MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+        unsigned int size = std::min(chunk_size, element_start_id + number_of_elements - j);
 
-        for (int i = 1; i < world_size; ++i)
-        {
-            int pixel_start_id;
-            int pixel_end_id;
+        double chunk_start = MPI_Wtime();
+        anOperation(j, size);
+        compute_time += MPI_Wtime() - chunk_start;
+        m_number_of_computed_pixels += size * anElementSize;
 
-            MPI_Status status;
+        if (rank == ROOT)
+        {
+            checkMPIError(MPI_Testsome(request_set.size(), request_set.data(),
+                                       &number_of_completed_requests, index_set.data(),
+                                       MPI_STATUSES_IGNORE));
+        }
+        else
+        {
+            request_set.push_back(MPI_REQUEST_NULL);
+            checkMPIError(MPI_Isend(p_data + j * anElementSize, size * anElementSize, MPI_FLOAT,
+                                    ROOT, CHUNK_TAG, MPI_COMM_WORLD, &request_set.back()));
+        }
+    }
 
-            checkMPIError(MPI_Recv(&pixel_start_id, 1, MPI_INT, i, 0, MPI_COMM_WORLD, &status));
-            checkMPIError(MPI_Recv(&pixel_end_id, 1, MPI_INT, i, 1, MPI_COMM_WORLD, &status));
-            checkMPIError(MPI_Recv(&temp[pixel_start_id], pixel_end_id - pixel_start_id + 1, MPI_FLOAT, i, 2, MPI_COMM_WORLD, &status));
+    // The master drains the remaining receives as they complete
+    if (rank == ROOT)
+    {
+        do
+        {
+            checkMPIError(MPI_Waitsome(request_set.size(), request_set.data(),
+                                       &number_of_completed_requests, index_set.data(),
+                                       MPI_STATUSES_IGNORE));
         }
+        while (number_of_completed_requests != MPI_UNDEFINED);
     }
-    // Other processes send the data to the master
+    // The other processes wait for their sends
     else
     {
-        checkMPIError(MPI_Send(&pixel_start_id, 1, MPI_INT, ROOT, 0, MPI_COMM_WORLD));
-        checkMPIError(MPI_Send(&pixel_end_id,   1, MPI_INT, ROOT, 1, MPI_COMM_WORLD));
-        checkMPIError(MPI_Send(&temp[pixel_start_id], pixel_end_id - pixel_start_id + 1, MPI_FLOAT, ROOT, 2, MPI_COMM_WORLD));
+        checkMPIError(MPI_Waitall(request_set.size(), request_set.data(), MPI_STATUSES_IGNORE));
     }
 
-    return temp;
+    // Only the master has the whole image
+    anImage.m_part_element_size = anElementSize;
+
+    // The time left is spent posting and waiting for the messages
+    m_compute_time += compute_time;
+    m_wait_time += MPI_Wtime() - start - compute_time;
 }
 
 
-//-----------------------------------------
-MPIImage MPIImage::flipHorizontally() const
-//-----------------------------------------
+//-----------------------------------------------------------
+template<typename ChunkOperation>
+void MPIImage::computeTiles(MPIImage& anImage,
+                            unsigned int aNumberOfElements,
+                            unsigned int anElementSize,
+                            ChunkOperation anOperation) const
+//-----------------------------------------------------------
 {
-    // Create an image of the right size
-    MPIImage temp(getWidth(), getHeight(), 0.0);
+    // Get the process' rank
+    int world_size;
+    int rank;
 
-    // Get the work load
-    unsigned int pixel_start_id = 0;
-    unsigned int pixel_end_id = 0;
-    workload(m_width * m_height, pixel_start_id, pixel_end_id);
+    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
 
-    // Process every pixel of the sub-image
-    for (unsigned int i = pixel_start_id; i <= pixel_end_id; ++i)
-    {
-        // Retrieve the 2D index (x, y) from i
+    double start = MPI_Wtime();
 
-        // % is the "modulo operator", the remainder of i / m_width
-        int x = i % m_width;
+    // Number of elements per tile, at least one. The tag of a tile is
+    // TILE_TAG plus its index, so the tiles are larger if there are more
+    // tiles than tags
+    int* p_tag_upper_bound;
+    int is_defined;
+    checkMPIError(MPI_Comm_get_attr(MPI_COMM_WORLD, MPI_TAG_UB, &p_tag_upper_bound, &is_defined));
 
-        // where "/" is an integer division
-        int y = i / m_width;
+    unsigned int max_number_of_tiles = *p_tag_upper_bound - TILE_TAG + 1;
+    unsigned int tile_size = std::max(1u, m_chunk_size / anElementSize);
+    tile_size = std::max(tile_size, (aNumberOfElements + max_number_of_tiles - 1) / max_number_of_tiles);
 
-        // Get the pixel
-        temp(x, y) = getPixel(m_width - x - 1, y);
-    }
+    int number_of_tiles = (aNumberOfElements + tile_size - 1) / tile_size;
 
-    // Get the process' rank
-    int rank;
-    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    // Every process starts with the tile of its rank, then the counter of
+    // the master gives the index of the next free tile
+    int counter = world_size;
+    MPI_Win window;
+    checkMPIError(MPI_Win_create(&counter, (rank == ROOT) ? sizeof(int) : 0, sizeof(int),
+                                 MPI_INFO_NULL, MPI_COMM_WORLD, &window));
 
-    // Master gather results from all the processes
-    if (rank == ROOT)
+    float* p_data = anImage.m_p_image.data();
+    std::vector<MPI_Request> request_set;
+
+    double compute_time = 0.0;
+    int number_of_assembled_tiles = 0;
+
+    // The master receives a tile directly in place, its tag gives its index
+    auto receive_tile = [&](const MPI_Status& aStatus)
     {
-        int world_size;
-        MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+        unsigned int first_element = (aStatus.MPI_TAG - TILE_TAG) * tile_size;
+        unsigned int size = std::min(tile_size, aNumberOfElements - first_element) * anElementSize;
 
-        for (int i = 1; i < world_size; ++i)
+        checkMPIError(MPI_Recv(p_data + first_element * anElementSize, size, MPI_FLOAT,
+                               aStatus.MPI_SOURCE, aStatus.MPI_TAG, MPI_COMM_WORLD, MPI_STATUS_IGNORE));
+        ++number_of_assembled_tiles;
+    };
+
+    const int increment = 1;
+    int tile_id = rank;
+
+    while (tile_id < number_of_tiles)
+    {
+        unsigned int first_element = tile_id * tile_size;
+        unsigned int size = std::min(tile_size, aNumberOfElements - first_element);
+
+        double tile_start = MPI_Wtime();
+        anOperation(first_element, size);
+        compute_time += MPI_Wtime() - tile_start;
+        m_number_of_computed_pixels += size * anElementSize;
+
+        // The master keeps its tile, and receives the tiles that have
+        // arrived in the meantime, which also lets MPI progress the
+        // requests of the counter
+        if (rank == ROOT)
         {
-            int pixel_start_id;
-            int pixel_end_id;
+            ++number_of_assembled_tiles;
+
+            int is_arrived = 1;
+            while (is_arrived)
+            {
+                MPI_Status status;
+                checkMPIError(MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &is_arrived, &status));
+
+                if (is_arrived)
+                {
+                    receive_tile(status);
+                }
+            }
+        }
+        // The other processes send it as soon as it is computed
+        else
+        {
+            request_set.push_back(MPI_REQUEST_NULL);
+            checkMPIError(MPI_Isend(p_data + first_element * anElementSize, size * anElementSize, MPI_FLOAT,
+                                    ROOT, TILE_TAG + tile_id, MPI_COMM_WORLD, &request_set.back()));
+        }
 
-            MPI_Status status;
+        // Take the next free tile
+        checkMPIError(MPI_Win_lock(MPI_LOCK_SHARED, ROOT, 0, window));
+        checkMPIError(MPI_Fetch_and_op(&increment, &tile_id, MPI_INT, ROOT, 0, MPI_SUM, window));
+        checkMPIError(MPI_Win_unlock(ROOT, window));
+    }
 
-            checkMPIError(MPI_Recv(&pixel_start_id, 1, MPI_INT, i, 0, MPI_COMM_WORLD, &status));
-            checkMPIError(MPI_Recv(&pixel_end_id, 1, MPI_INT, i, 1, MPI_COMM_WORLD, &status));
-            checkMPIError(MPI_Recv(&temp[pixel_start_id], pixel_end_id - pixel_start_id + 1, MPI_FLOAT, i, 2, MPI_COMM_WORLD, &status));
+    // The master receives the remaining tiles as they arrive
+    if (rank == ROOT)
+    {
+        while (number_of_assembled_tiles < number_of_tiles)
+        {
+            MPI_Status status;
+            checkMPIError(MPI_Probe(MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &status));
+            receive_tile(status);
         }
     }
-    // Other processes send the data to the master
+    // The other processes wait for their sends
     else
     {
-        checkMPIError(MPI_Send(&pixel_start_id, 1, MPI_INT, ROOT, 0, MPI_COMM_WORLD));
-        checkMPIError(MPI_Send(&pixel_end_id,   1, MPI_INT, ROOT, 1, MPI_COMM_WORLD));
-        checkMPIError(MPI_Send(&temp[pixel_start_id], pixel_end_id - pixel_start_id + 1, MPI_FLOAT, ROOT, 2, MPI_COMM_WORLD));
+        checkMPIError(MPI_Waitall(request_set.size(), request_set.data(), MPI_STATUSES_IGNORE));
     }
 
-    return temp;
+    checkMPIError(MPI_Win_free(&window));
+
+    // As with ALLGATHERV, every process has the whole output: the tiles of
+    // the next filter of a chain may be anywhere in the image
+    broadcast(p_data, aNumberOfElements * anElementSize);
+
+    // The time left is spent waiting for a tile or for the messages
+    m_compute_time += compute_time;
+    m_wait_time += MPI_Wtime() - start - compute_time;
 }
 
 
-//---------------------------------------
-MPIImage MPIImage::flipVertically() const
-//---------------------------------------
+//-----------------------------------------------------
+float MPIImage::allReduceSum(float aPartialSum) const
+//-----------------------------------------------------
 {
-    // Create an image of the right size
-    MPIImage temp(getWidth(), getHeight(), 0.0);
+    float sum;
+    allReduce(&aPartialSum, &sum, 1, MPI_FLOAT, MPI_SUM);
+    return sum;
+}
 
-    // Get the work load
-    unsigned int pixel_start_id = 0;
-    unsigned int pixel_end_id = 0;
-    workload(m_width * m_height, pixel_start_id, pixel_end_id);
 
-    // Process every pixel of the sub-image
-    for (unsigned int i = pixel_start_id; i <= pixel_end_id; ++i)
-    {
-        // Retrieve the 2D index (x, y) from i
+//------------------------------------------------------------------------------
+float MPIImage::allReduceSum(const ReproducibleAccumulator& aPartialSum) const
+//------------------------------------------------------------------------------
+{
+    // Normalised states can be added as integers without overflow
+    ReproducibleAccumulator partial_sum(aPartialSum);
+    partial_sum.normalise();
+
+    ReproducibleAccumulator sum;
+    allReduce(partial_sum.getState(),
+              sum.getState(),
+              ReproducibleAccumulator::STATE_SIZE,
+              MPI_INT64_T,
+              MPI_SUM);
+
+    return sum.getSum();
+}
+
+
+//--------------------------------------------
+void MPIImage::swapImage(MPIImage& anImage)
+//--------------------------------------------
+{
+    std::swap(m_width, anImage.m_width);
+    std::swap(m_height, anImage.m_height);
+    m_p_image.swap(anImage.m_p_image);
+
+    std::swap(m_is_distributed, anImage.m_is_distributed);
+    std::swap(m_first_row, anImage.m_first_row);
+    std::swap(m_number_of_rows, anImage.m_number_of_rows);
+    std::swap(m_part_element_size, anImage.m_part_element_size);
+    m_p_shared_buffer.swap(anImage.m_p_shared_buffer);
+}
 
-        // % is the "modulo operator", the remainder of i / m_width
-        int x = i % m_width;
 
-        // where "/" is an integer division
-        int y = i / m_width;
+//------------------------
+float* MPIImage::getData()
+//------------------------
+{
+    return isShared() ? m_p_shared_buffer->getData() : m_p_image.data();
+}
 
-        // Get the pixel
-        temp(x, y) = getPixel(x, m_height - y - 1);
-    }
 
-    // Get the process' rank
-    int rank;
-    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+//------------------------------------
+const float* MPIImage::getData() const
+//------------------------------------
+{
+    return isShared() ? m_p_shared_buffer->getData() : m_p_image.data();
+}
 
-    // Master gather results from all the processes
-    if (rank == ROOT)
-    {
-        int world_size;
-        MPI_Comm_size(MPI_COMM_WORLD, &world_size);
 
-        for (int i = 1; i < world_size; ++i)
-        {
-            int pixel_start_id;
-            int pixel_end_id;
+//-----------------------------------------------
+void MPIImage::copyImage(const MPIImage& anImage)
+//-----------------------------------------------
+{
+    m_is_distributed = anImage.m_is_distributed;
+    m_first_row = anImage.m_first_row;
+    m_number_of_rows = anImage.m_number_of_rows;
+    m_part_element_size = anImage.m_part_element_size;
 
-            MPI_Status status;
+    // The pixels of this process
+    if (!anImage.isShared())
+    {
+        m_p_shared_buffer.reset();
+        Image::operator=(anImage);
+        return;
+    }
 
-            checkMPIError(MPI_Recv(&pixel_start_id, 1, MPI_INT, i, 0, MPI_COMM_WORLD, &status));
-            checkMPIError(MPI_Recv(&pixel_end_id, 1, MPI_INT, i, 1, MPI_COMM_WORLD, &status));
-            checkMPIError(MPI_Recv(&temp[pixel_start_id], pixel_end_id - pixel_start_id + 1, MPI_FLOAT, i, 2, MPI_COMM_WORLD, &status));
-        }
+    destroy();
+    PixelVector().swap(m_p_image);
+    m_width = anImage.m_width;
+    m_height = anImage.m_height;
+
+    // A buffer of the same size is reused once the other processes of the
+    // node have stopped reading it
+    if (isShared() && m_p_shared_buffer->size() == m_width * m_height)
+    {
+        m_p_shared_buffer->synchronise();
     }
-    // Other processes send the data to the master
     else
     {
-        checkMPIError(MPI_Send(&pixel_start_id, 1, MPI_INT, ROOT, 0, MPI_COMM_WORLD));
-        checkMPIError(MPI_Send(&pixel_end_id,   1, MPI_INT, ROOT, 1, MPI_COMM_WORLD));
-        checkMPIError(MPI_Send(&temp[pixel_start_id], pixel_end_id - pixel_start_id + 1, MPI_FLOAT, ROOT, 2, MPI_COMM_WORLD));
+        m_p_shared_buffer.reset(new MPISharedBuffer(m_width * m_height));
     }
 
-    return temp;
+    // The whole image is copied in the buffer of every node, the processes
+    // of the node share the copy
+    const MPINodeTopology& topology = MPINodeTopology::getInstance();
+
+    unsigned int start_id, end_id;
+    getTaskRange(m_width * m_height, topology.getNodeSize(), topology.getNodeRank(), start_id, end_id);
+
+    std::memcpy(getData() + start_id, anImage.getData() + start_id, (end_id - start_id) * sizeof(float));
+
+    m_p_shared_buffer->synchronise();
 }
 
 
-//-----------------------------------------------------
-void MPIImage::workload(unsigned int aNumberOfElements,
-                        unsigned int& aStartID,
-                        unsigned int& aEndID) const
-//-----------------------------------------------------
+//--------------------------------------------------------------
+void MPIImage::exchangeNodeParts(unsigned int aNumberOfElements,
+                                 unsigned int anElementSize)
+//--------------------------------------------------------------
 {
-    int world_size;
-    int rank;
+    // The parts written by the processes of the node are visible to its
+    // leader
+    m_p_shared_buffer->synchronise();
 
-    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
-    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    const MPINodeTopology& topology = MPINodeTopology::getInstance();
+    int number_of_nodes = topology.getNumberOfNodes();
 
-    int last_element = -1;
-    unsigned int element_per_task = aNumberOfElements / world_size;
-    unsigned int remainder = aNumberOfElements % world_size;
+    // A single node, the output is complete
+    if (number_of_nodes == 1)
+    {
+        return;
+    }
 
-    for (int i = 0; i < world_size; ++i)
+    // The leaders exchange the consecutive parts of their processes
+    if (topology.isLeader())
     {
-        aStartID = ++last_element;
-        aEndID = last_element + element_per_task - 1;
+        std::vector<int> count_set;
+        std::vector<int> displacement_set;
+        getWorkloads(aNumberOfElements, anElementSize, count_set, displacement_set);
 
-        if (remainder > 0)
+        std::vector<int> node_count_set(number_of_nodes, 0);
+        std::vector<int> node_displacement_set(number_of_nodes, 0);
+
+        for (int i = 0; i < number_of_nodes; ++i)
         {
-            aEndID++;
-            --remainder;
+            int first_process;
+            int number_of_processes;
+            topology.getNodeProcesses(i, first_process, number_of_processes);
+
+            node_displacement_set[i] = displacement_set[first_process];
+
+            for (int j = first_process; j < first_process + number_of_processes; ++j)
+            {
+                node_count_set[i] += count_set[j];
+            }
         }
-        last_element = aEndID;
 
-        // Exit the method
-        if (rank == i) return;
+        checkMPIError(MPI_Allgatherv(MPI_IN_PLACE, 0, MPI_FLOAT,
+                                     getData(), node_count_set.data(), node_displacement_set.data(), MPI_FLOAT,
+                                     topology.getLeaderCommunicator()));
     }
+
+    // The parts of the other nodes are visible to all the processes
+    m_p_shared_buffer->synchronise();
 }
 
 
@@ -0,0 +1,343 @@
+/**
+********************************************************************************
+*
+*   @file       MPINodeTopology.cxx
+*
+*   @brief      Class to group the MPI processes by node: a communicator per
+*               node, a communicator of the node leaders, and hierarchical
+*               collectives over them.
+*
+*   @version    1.0
+*
+*   @date       19/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//  Include
+//******************************************************************************
+#include "MPINodeTopology.h"
+
+
+//******************************************************************************
+//  Constant variables
+//******************************************************************************
+namespace
+{
+    /// Tag of the messages of the leaders to the master in gatherv()
+    const int GATHER_TAG = 0;
+}
+
+
+//---------------------------------------------------
+const MPINodeTopology& MPINodeTopology::getInstance()
+//---------------------------------------------------
+{
+    static MPINodeTopology topology;
+    return topology;
+}
+
+
+//---------------------------------
+MPINodeTopology::MPINodeTopology():
+//---------------------------------
+        m_node_communicator(MPI_COMM_NULL),
+        m_leader_communicator(MPI_COMM_NULL),
+        m_node_id(0),
+        m_node_rank(0)
+//---------------------------------
+{
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+    // The processes that can share memory, in rank order: the master is
+    // the first process of its node
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &m_node_communicator);
+    MPI_Comm_rank(m_node_communicator, &m_node_rank);
+
+    int node_size;
+    MPI_Comm_size(m_node_communicator, &node_size);
+
+    // The first process of every node
+    MPI_Comm_split(MPI_COMM_WORLD, (m_node_rank == 0) ? 0 : MPI_UNDEFINED, rank, &m_leader_communicator);
+
+    // The leaders know the size of every node
+    int number_of_nodes = 0;
+    if (m_leader_communicator != MPI_COMM_NULL)
+    {
+        MPI_Comm_rank(m_leader_communicator, &m_node_id);
+        MPI_Comm_size(m_leader_communicator, &number_of_nodes);
+
+        m_number_of_processes_set.resize(number_of_nodes);
+        MPI_Allgather(&node_size, 1, MPI_INT,
+                      m_number_of_processes_set.data(), 1, MPI_INT,
+                      m_leader_communicator);
+    }
+
+    // Then every process of their node
+    MPI_Bcast(&m_node_id, 1, MPI_INT, 0, m_node_communicator);
+    MPI_Bcast(&number_of_nodes, 1, MPI_INT, 0, m_node_communicator);
+
+    m_number_of_processes_set.resize(number_of_nodes);
+    MPI_Bcast(m_number_of_processes_set.data(), number_of_nodes, MPI_INT, 0, m_node_communicator);
+
+    // The processes are numbered node by node
+    m_first_process_set.resize(number_of_nodes);
+    for (int i = 0, first_process = 0; i < number_of_nodes; ++i)
+    {
+        m_first_process_set[i] = first_process;
+        first_process += m_number_of_processes_set[i];
+    }
+
+    // The rank of every process of the node, then of every process
+    std::vector<int> node_rank_set(node_size);
+    MPI_Allgather(&rank, 1, MPI_INT, node_rank_set.data(), 1, MPI_INT, m_node_communicator);
+
+    m_rank_set.resize(m_first_process_set.back() + m_number_of_processes_set.back());
+    if (m_leader_communicator != MPI_COMM_NULL)
+    {
+        MPI_Allgatherv(node_rank_set.data(), node_size, MPI_INT,
+                       m_rank_set.data(), m_number_of_processes_set.data(), m_first_process_set.data(), MPI_INT,
+                       m_leader_communicator);
+    }
+    MPI_Bcast(m_rank_set.data(), m_rank_set.size(), MPI_INT, 0, m_node_communicator);
+}
+
+
+//---------------------------------------------------
+MPI_Comm MPINodeTopology::getNodeCommunicator() const
+//---------------------------------------------------
+{
+    return m_node_communicator;
+}
+
+
+//-----------------------------------------------------
+MPI_Comm MPINodeTopology::getLeaderCommunicator() const
+//-----------------------------------------------------
+{
+    return m_leader_communicator;
+}
+
+
+//------------------------------------
+bool MPINodeTopology::isLeader() const
+//------------------------------------
+{
+    return (m_node_rank == 0);
+}
+
+
+//-------------------------------------------
+int MPINodeTopology::getNumberOfNodes() const
+//-------------------------------------------
+{
+    return m_first_process_set.size();
+}
+
+
+//------------------------------------
+int MPINodeTopology::getNodeID() const
+//------------------------------------
+{
+    return m_node_id;
+}
+
+
+//--------------------------------------
+int MPINodeTopology::getNodeRank() const
+//--------------------------------------
+{
+    return m_node_rank;
+}
+
+
+//--------------------------------------
+int MPINodeTopology::getNodeSize() const
+//--------------------------------------
+{
+    return m_number_of_processes_set[m_node_id];
+}
+
+
+//------------------------------------------
+int MPINodeTopology::getProcessIndex() const
+//------------------------------------------
+{
+    return m_first_process_set[m_node_id] + m_node_rank;
+}
+
+
+//-------------------------------------------------------------------
+void MPINodeTopology::getNodeProcesses(int aNodeID,
+                                       int& aFirstProcessIndex,
+                                       int& aNumberOfProcesses) const
+//-------------------------------------------------------------------
+{
+    aFirstProcessIndex = m_first_process_set[aNodeID];
+    aNumberOfProcesses = m_number_of_processes_set[aNodeID];
+}
+
+
+//---------------------------------------------------
+int MPINodeTopology::getRank(int aProcessIndex) const
+//---------------------------------------------------
+{
+    return m_rank_set[aProcessIndex];
+}
+
+
+//---------------------------------------------------------------
+void MPINodeTopology::gatherv(const float* apSendBuffer,
+                              int aSendCount,
+                              float* apReceiveBuffer,
+                              const int* apCountSet,
+                              const int* apDisplacementSet) const
+//---------------------------------------------------------------
+{
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+    int node_size = getNodeSize();
+    int first_process = m_first_process_set[m_node_id];
+
+    // The leader knows the number of elements of every process of its node
+    std::vector<int> count_set(node_size);
+    MPI_Gather(&aSendCount, 1, MPI_INT, count_set.data(), 1, MPI_INT, 0, m_node_communicator);
+
+    // The node of the master: the arrays go directly to their place
+    if (m_node_id == 0)
+    {
+        std::vector<int> displacement_set(node_size);
+        const void* p_send_buffer = apSendBuffer;
+
+        if (rank == 0)
+        {
+            for (int i = 0; i < node_size; ++i)
+            {
+                displacement_set[i] = apDisplacementSet[m_rank_set[first_process + i]];
+            }
+
+            if (apSendBuffer == apReceiveBuffer + apDisplacementSet[0])
+            {
+                p_send_buffer = MPI_IN_PLACE;
+            }
+        }
+
+        MPI_Gatherv(p_send_buffer, aSendCount, MPI_FLOAT,
+                    apReceiveBuffer, count_set.data(), displacement_set.data(), MPI_FLOAT,
+                    0, m_node_communicator);
+    }
+    // The other nodes: the leader packs the arrays of its node in the order
+    // of their rank in the node, and sends them to the master
+    else
+    {
+        std::vector<int> displacement_set(node_size);
+        int number_of_elements = 0;
+        for (int i = 0; i < node_size; ++i)
+        {
+            displacement_set[i] = number_of_elements;
+            number_of_elements += count_set[i];
+        }
+
+        std::vector<float> node_buffer(isLeader() ? number_of_elements : 0);
+        MPI_Gatherv(apSendBuffer, aSendCount, MPI_FLOAT,
+                    node_buffer.data(), count_set.data(), displacement_set.data(), MPI_FLOAT,
+                    0, m_node_communicator);
+
+        if (isLeader())
+        {
+            MPI_Send(node_buffer.data(), number_of_elements, MPI_FLOAT,
+                     0, GATHER_TAG, m_leader_communicator);
+        }
+    }
+
+    // The master receives one message per node, unpacked by the datatype
+    if (rank == 0)
+    {
+        int number_of_nodes = getNumberOfNodes();
+        std::vector<MPI_Datatype> type_set(number_of_nodes - 1);
+        std::vector<MPI_Request> request_set(number_of_nodes - 1);
+
+        for (int node_id = 1; node_id < number_of_nodes; ++node_id)
+        {
+            int first = m_first_process_set[node_id];
+            int number_of_processes = m_number_of_processes_set[node_id];
+
+            std::vector<int> block_length_set(number_of_processes);
+            std::vector<int> block_displacement_set(number_of_processes);
+            for (int i = 0; i < number_of_processes; ++i)
+            {
+                int process_rank = m_rank_set[first + i];
+                block_length_set[i] = apCountSet[process_rank];
+                block_displacement_set[i] = apDisplacementSet[process_rank];
+            }
+
+            MPI_Datatype& type = type_set[node_id - 1];
+            MPI_Type_indexed(number_of_processes,
+                             block_length_set.data(), block_displacement_set.data(),
+                             MPI_FLOAT, &type);
+            MPI_Type_commit(&type);
+
+            MPI_Irecv(apReceiveBuffer, 1, type, node_id, GATHER_TAG,
+                      m_leader_communicator, &request_set[node_id - 1]);
+        }
+
+        MPI_Waitall(request_set.size(), request_set.data(), MPI_STATUSES_IGNORE);
+
+        for (auto& type : type_set)
+        {
+            MPI_Type_free(&type);
+        }
+    }
+}
+
+
+//--------------------------------------------------------------
+void MPINodeTopology::broadcast(float* apData, int aCount) const
+//--------------------------------------------------------------
+{
+    // From the master to the leaders
+    if (m_leader_communicator != MPI_COMM_NULL)
+    {
+        MPI_Bcast(apData, aCount, MPI_FLOAT, 0, m_leader_communicator);
+    }
+
+    // Then in every node
+    MPI_Bcast(apData, aCount, MPI_FLOAT, 0, m_node_communicator);
+}
+
+
+//-------------------------------------------------------
+void MPINodeTopology::allReduce(const void* apInput,
+                                void* apOutput,
+                                int aCount,
+                                MPI_Datatype aType,
+                                MPI_Op anOperation) const
+//-------------------------------------------------------
+{
+    // In every node, to its leader
+    if (isLeader())
+    {
+        MPI_Reduce(apInput, apOutput, aCount, aType, anOperation, 0, m_node_communicator);
+    }
+    else
+    {
+        const void* p_input = (apInput == MPI_IN_PLACE) ? apOutput : apInput;
+        MPI_Reduce(p_input, nullptr, aCount, aType, anOperation, 0, m_node_communicator);
+    }
+
+    // Between the leaders
+    if (m_leader_communicator != MPI_COMM_NULL)
+    {
+        MPI_Allreduce(MPI_IN_PLACE, apOutput, aCount, aType, anOperation, m_leader_communicator);
+    }
+
+    // Then in every node
+    MPI_Bcast(apOutput, aCount, aType, 0, m_node_communicator);
+}
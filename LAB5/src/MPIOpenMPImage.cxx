@@ -0,0 +1,153 @@
+/**
+********************************************************************************
+*
+*   @file       MPIOpenMPImage.cxx
+*
+*   @brief      Class to handle a greyscale image using MPI between the
+*               processes and OpenMP within every process.
+*
+*   @version    1.0
+*
+*   @date       19/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//  Include
+//******************************************************************************
+#include <algorithm> // Header file for max
+
+#include "MPIOpenMPImage.h"
+
+
+//------------------------------------------------------------
+MPIOpenMPImage::MPIOpenMPImage(unsigned int aNumberOfThreads):
+//------------------------------------------------------------
+        MPIImage()
+//------------------------------------------------------------
+{
+    setNumberOfThreads(aNumberOfThreads);
+}
+
+
+//------------------------------------------------------------
+MPIOpenMPImage::MPIOpenMPImage(const Image& anImage,
+                               unsigned int aNumberOfThreads):
+//------------------------------------------------------------
+        MPIImage(anImage)
+//------------------------------------------------------------
+{
+    setNumberOfThreads(aNumberOfThreads);
+}
+
+
+//--------------------------------------------------------------------
+void MPIOpenMPImage::setNumberOfThreads(unsigned int aNumberOfThreads)
+//--------------------------------------------------------------------
+{
+    m_thread_number = std::max(1u, aNumberOfThreads);
+}
+
+
+//-----------------------------------------------------
+unsigned int MPIOpenMPImage::getNumberOfThreads() const
+//-----------------------------------------------------
+{
+    return m_thread_number;
+}
+
+
+//----------------------------------------------
+MPIOpenMPImage MPIOpenMPImage::operator!() const
+//----------------------------------------------
+{
+    return toMPIOpenMPImage(MPIImage::operator!());
+}
+
+
+//----------------------------------------------------------------------
+MPIOpenMPImage MPIOpenMPImage::shiftScaleFilter(float aShiftValue,
+                                                float aScaleValue) const
+//----------------------------------------------------------------------
+{
+    return toMPIOpenMPImage(MPIImage::shiftScaleFilter(aShiftValue, aScaleValue));
+}
+
+
+//--------------------------------------------------
+MPIOpenMPImage MPIOpenMPImage::getNormalised() const
+//--------------------------------------------------
+{
+    return toMPIOpenMPImage(MPIImage::getNormalised());
+}
+
+
+//--------------------------------------------------
+MPIOpenMPImage MPIOpenMPImage::getNormalized() const
+//--------------------------------------------------
+{
+    return (getNormalised());
+}
+
+
+//----------------------------------------------
+MPIOpenMPImage MPIOpenMPImage::logFilter() const
+//----------------------------------------------
+{
+    return toMPIOpenMPImage(MPIImage::logFilter());
+}
+
+
+//------------------------------------------------------------------------------------------------
+MPIOpenMPImage MPIOpenMPImage::applyPointFunction(PointFunction aFunction, float aParameter) const
+//------------------------------------------------------------------------------------------------
+{
+    return toMPIOpenMPImage(MPIImage::applyPointFunction(aFunction, aParameter));
+}
+
+
+//-----------------------------------------------------------------
+MPIOpenMPImage MPIOpenMPImage::applyLUT(const PointLUT& aLUT) const
+//-----------------------------------------------------------------
+{
+    return toMPIOpenMPImage(MPIImage::applyLUT(aLUT));
+}
+
+
+//------------------------------------------------------------------
+MPIOpenMPImage MPIOpenMPImage::boxFilter(unsigned int aRadius) const
+//------------------------------------------------------------------
+{
+    return toMPIOpenMPImage(MPIImage::boxFilter(aRadius));
+}
+
+
+//-----------------------------------------------------
+MPIOpenMPImage MPIOpenMPImage::flipHorizontally() const
+//-----------------------------------------------------
+{
+    return toMPIOpenMPImage(MPIImage::flipHorizontally());
+}
+
+
+//---------------------------------------------------
+MPIOpenMPImage MPIOpenMPImage::flipVertically() const
+//---------------------------------------------------
+{
+    return toMPIOpenMPImage(MPIImage::flipVertically());
+}
+
+
+//---------------------------------------------------------------------
+MPIOpenMPImage MPIOpenMPImage::toMPIOpenMPImage(MPIImage anImage) const
+//---------------------------------------------------------------------
+{
+    MPIOpenMPImage temp(m_thread_number);
+    temp.swapImage(anImage);
+    return temp;
+}
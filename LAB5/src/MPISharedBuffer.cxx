@@ -0,0 +1,99 @@
+/**
+********************************************************************************
+*
+*   @file       MPISharedBuffer.cxx
+*
+*   @brief      Class to handle an array of floats shared by the MPI processes
+*               of a node.
+*
+*   @version    1.0
+*
+*   @date       19/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//  Include
+//******************************************************************************
+#include "MPISharedBuffer.h"
+#include "MPINodeTopology.h"
+
+
+//---------------------------------------------------------------
+MPISharedBuffer::MPISharedBuffer(unsigned int aNumberOfElements):
+//---------------------------------------------------------------
+        m_window(MPI_WIN_NULL),
+        m_p_data(nullptr),
+        m_size(aNumberOfElements)
+//---------------------------------------------------------------
+{
+    const MPINodeTopology& topology = MPINodeTopology::getInstance();
+
+    // Only the leader allocates the memory, one copy per node
+    MPI_Aint local_size = topology.isLeader() ? MPI_Aint(m_size) * sizeof(float) : 0;
+
+    float* p_local_data = nullptr;
+    int error_code = MPI_Win_allocate_shared(local_size, sizeof(float), MPI_INFO_NULL,
+                                             topology.getNodeCommunicator(), &p_local_data, &m_window);
+
+    if (error_code != MPI_SUCCESS)
+    {
+        throw "MPI_Win_allocate_shared failed, the image cannot be shared by the processes of the node";
+    }
+
+    // The address of the memory of the leader in this process
+    MPI_Aint size;
+    int displacement_unit;
+    MPI_Win_shared_query(m_window, 0, &size, &displacement_unit, &m_p_data);
+
+    // Passive target for the lifetime of the buffer
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, m_window);
+}
+
+
+//---------------------------------
+MPISharedBuffer::~MPISharedBuffer()
+//---------------------------------
+{
+    MPI_Win_unlock_all(m_window);
+    MPI_Win_free(&m_window);
+}
+
+
+//-------------------------------
+float* MPISharedBuffer::getData()
+//-------------------------------
+{
+    return m_p_data;
+}
+
+
+//-------------------------------------------
+const float* MPISharedBuffer::getData() const
+//-------------------------------------------
+{
+    return m_p_data;
+}
+
+
+//----------------------------------------
+unsigned int MPISharedBuffer::size() const
+//----------------------------------------
+{
+    return m_size;
+}
+
+
+//---------------------------------------
+void MPISharedBuffer::synchronise() const
+//---------------------------------------
+{
+    MPI_Win_sync(m_window);
+    MPI_Barrier(MPINodeTopology::getInstance().getNodeCommunicator());
+    MPI_Win_sync(m_window);
+}
@@ -27,6 +27,7 @@
 #include <cctype>
 #include <algorithm>
 #include <locale>         // locale, toupper
+#include <vector>
 #include <chrono>   // To measure durations
 
 #include <getopt.h>
@@ -37,7 +38,14 @@
 #include "Image.h"
 #include "PthreadImage.h"
 #include "OpenMPImage.h"
+#include "StdParImage.h"
 #include "MPIImage.h"
+#include "MPIOpenMPImage.h"
+#include "ImageKernels.h"
+#include "PointLUT.h"
+#include "HalfImage.h"
+#include "CostModel.h"
+#include "CpuTopology.h"
 
 
 //******************************************************************************
@@ -60,12 +68,30 @@ string output_file;
 string implementation;
 int number_of_threads = 0;
 bool is_MPI_initialised = false;
+int force_calibration = 0;
+int physical_cores_only = 0;
+string isa;
+string output_type;
+string gather_mode;
+string distribution_mode;
+string collective_mode;
+string chunk_size;
+int fast_log = 0;
+int use_lut = 0;
+bool is_auto_selected = false;
+Image preloaded_input;
 
 
 void parseCommandLine(int& argc, char** argv);
 void printHelp();
 void checkInputParameters();
 string toUpper(const string& aString);
+void selectImplementation(const string& anOperation);
+void saveOutput(Image& anOutput);
+template<typename T> void loadInput(T& anImage);
+PointLUT createLUT(const Image& anImage);
+PointLUT createLUT(const MPIImage& anImage);
+template<typename T> T applyFilter(const T& anImage, float aMinValue, float aMaxValue);
 
 
 //-----------------------------
@@ -86,6 +112,40 @@ int main(int argc, char** argv)
         cout << "Implementation: " << implementation << endl;
         cout << "Number of processes/threads: " << number_of_threads << endl;*/
 
+        // Make sure SMT siblings are not used if only physical cores are
+        if (physical_cores_only)
+        {
+            CpuTopology::getInstance().bindToPhysicalCores();
+        }
+
+        // Use the kernels of a given instruction set instead of the widest one
+        if (isa.size())
+        {
+            setImageKernelISA(isa);
+        }
+
+        // Use the SIMD log kernel instead of libm
+        if (fast_log)
+        {
+            Image::setLogMode(Image::FAST_LOG);
+        }
+
+        // Select the implementation and the number of threads automatically
+        if (toUpper(implementation) == "AUTO")
+        {
+            selectImplementation(use_lut ? "lut_log" : (fast_log ? "fast_log" : "log"));
+        }
+
+        // Resolve the number of threads against the CPU topology. The
+        // hybrid implementation uses all the CPUs allowed to every process
+        // by default
+        if (toUpper(implementation) != "MPI" &&
+            (number_of_threads > 0 || toUpper(implementation) == "HYBRID") &&
+            !is_auto_selected)
+        {
+            number_of_threads = CpuTopology::getInstance().resolveNumberOfThreads(number_of_threads, physical_cores_only);
+        }
+
         // Output image
         Image output;
 
@@ -100,11 +160,13 @@ int main(int argc, char** argv)
             Image input;
 
             // Load the image
-            input.loadASCII(input_file);
+            loadInput(input);
 
-            // Filter the image
+            // Find the range and filter the image
             start = chrono::high_resolution_clock::now();
-            output = input.getNormalised().logFilter();
+            float min_value, max_value;
+            input.getMinMaxValues(min_value, max_value);
+            output = applyFilter(input, min_value, max_value);
             end = chrono::high_resolution_clock::now();
         }
         else if (toUpper(implementation) == "PTHREAD" ||
@@ -114,11 +176,13 @@ int main(int argc, char** argv)
             PthreadImage input(number_of_threads);
 
             // Load the image
-            input.loadASCII(input_file);
+            loadInput(input);
 
-            // Filter the image
+            // Find the range and filter the image
             start = chrono::high_resolution_clock::now();
-            output = input.getNormalised().logFilter();
+            float min_value, max_value;
+            input.getMinMaxValues(min_value, max_value);
+            output = applyFilter(input, min_value, max_value);
             end = chrono::high_resolution_clock::now();
         }
         else if (toUpper(implementation) == "OPENMP" ||
@@ -128,11 +192,28 @@ int main(int argc, char** argv)
             OpenMPImage input(number_of_threads);
 
             // Load the image
-            input.loadASCII(input_file);
+            loadInput(input);
 
-            // Filter the image
+            // Find the range and filter the image
             start = chrono::high_resolution_clock::now();
-            output = input.getNormalised().logFilter();
+            float min_value, max_value;
+            input.getMinMaxValues(min_value, max_value);
+            output = applyFilter(input, min_value, max_value);
+            end = chrono::high_resolution_clock::now();
+        }
+        else if (toUpper(implementation) == "STDPAR")
+        {
+            // Declaration
+            StdParImage input(number_of_threads);
+
+            // Load the image
+            loadInput(input);
+
+            // Find the range and filter the image
+            start = chrono::high_resolution_clock::now();
+            float min_value, max_value;
+            input.getMinMaxValues(min_value, max_value);
+            output = applyFilter(input, min_value, max_value);
             end = chrono::high_resolution_clock::now();
         }
         /*else if (toUpper(implementation) == "CUDA")
@@ -148,63 +229,170 @@ int main(int argc, char** argv)
             output = input.getNormalised().logFilter();
             end = chrono::high_resolution_clock::now();
         }*/
-        else if (toUpper(implementation) == "MPI")
+        else if (toUpper(implementation) == "MPI" ||
+                 toUpper(implementation) == "HYBRID")
         {
-            // Initialise MPI
-            MPI_Init(&argc, &argv);
-            is_MPI_initialised = true;
+            // Initialise MPI. Only the master thread of every process calls
+            // MPI in the hybrid implementation
+            if (toUpper(implementation) == "HYBRID")
+            {
+                int thread_support;
+                MPI_Init_thread(&argc, &argv, MPIOpenMPImage::THREAD_SUPPORT, &thread_support);
+                is_MPI_initialised = true;
 
-            // Declaration
-            MPIImage input;
+                if (thread_support < MPIOpenMPImage::THREAD_SUPPORT)
+                {
+                    throw "The MPI library does not support MPI_THREAD_FUNNELED, the hybrid implementation cannot be used.";
+                }
+            }
+            else
+            {
+                MPI_Init(&argc, &argv);
+                is_MPI_initialised = true;
+            }
 
-            // Load the image
-            input.loadASCII(input_file);
+            // Assemble the results with point-to-point messages,
+            // MPI_Gatherv or MPI_Allgatherv
+            if (gather_mode.size())
+            {
+                MPIImage::setGatherMode(MPIImage::getGatherMode(gather_mode));
+            }
 
-            // Filter the image
-            start = chrono::high_resolution_clock::now();
-            output = input.logFilter();
-            end = chrono::high_resolution_clock::now();
+            // Size of the chunks sent as soon as they are computed
+            if (chunk_size.size())
+            {
+                MPIImage::setChunkSize(atoi(chunk_size.c_str()));
+            }
+
+            // Load the whole image in every process, or scatter its rows
+            if (distribution_mode.size())
+            {
+                MPIImage::setDistributionMode(MPIImage::getDistributionMode(distribution_mode));
+            }
+
+            // Collectives over all the processes, or node by node
+            if (collective_mode.size())
+            {
+                MPIImage::setCollectiveMode(MPIImage::getCollectiveMode(collective_mode));
+            }
+
+            // MPI processes, and OpenMP threads within every process
+            if (toUpper(implementation) == "HYBRID")
+            {
+                // Declaration
+                MPIOpenMPImage input(number_of_threads);
+
+                // Load the image
+                input.loadASCII(input_file);
+
+                // Find the range, filter the image, then assemble it on the master
+                start = chrono::high_resolution_clock::now();
+                float min_value, max_value;
+                input.getMinMaxValues(min_value, max_value);
+                applyFilter(input, min_value, max_value).gatherImage(output);
+                end = chrono::high_resolution_clock::now();
+            }
+            // MPI processes only
+            else
+            {
+                // Declaration
+                MPIImage input;
+
+                // Load the image
+                input.loadASCII(input_file);
+
+                // Find the range, filter the image, then assemble it on the master
+                start = chrono::high_resolution_clock::now();
+                float min_value, max_value;
+                input.getMinMaxValues(min_value, max_value);
+                applyFilter(input, min_value, max_value).gatherImage(output);
+                end = chrono::high_resolution_clock::now();
+            }
         }
 
         // Special attention is given to MPI
-        if (toUpper(implementation) == "MPI")
+        if (toUpper(implementation) == "MPI" ||
+            toUpper(implementation) == "HYBRID")
         {
-            // Get the process' rank
+            // Get the number of processes and the process' rank
+            int world_size;
             int rank;
+            MPI_Comm_size(MPI_COMM_WORLD, &world_size);
             MPI_Comm_rank(MPI_COMM_WORLD, &rank);
 
+            // The hybrid implementation records the number of processes and
+            // the number of threads of every process, then the total number
+            // of threads
+            string layout;
+            if (toUpper(implementation) == "HYBRID")
+            {
+                layout = ":" + to_string(world_size) + "x" + to_string(number_of_threads);
+                number_of_threads *= world_size;
+            }
+
+            // How well the transfers of the output are hidden by the
+            // computations of the filter, summed over all the processes
+            if (gather_mode.size())
+            {
+                double compute_time;
+                double wait_time;
+                MPIImage::getGatherTimes(compute_time, wait_time);
+
+                double overlap_efficiency = MPIImage::getOverlapEfficiency();
+
+                // The balance of the work between the processes
+                vector<unsigned long long> number_of_pixels_set;
+                vector<double> idle_time_set;
+                MPIImage::getWorkDistribution(number_of_pixels_set, idle_time_set);
+
+                if (rank == MPIImage::ROOT)
+                {
+                    cerr << "Gather " << MPIImage::getGatherModeName(MPIImage::getGatherMode()) <<
+                        ": overlap efficiency " << overlap_efficiency <<
+                        ", compute time " << compute_time << " s" <<
+                        ", wait time " << wait_time << " s" << endl;
+
+                    for (unsigned int i = 0; i < number_of_pixels_set.size(); ++i)
+                    {
+                        cerr << "Process " << i << ": " << number_of_pixels_set[i] << " pixels" <<
+                            ", idle time " << idle_time_set[i] << " s" << endl;
+                    }
+                }
+            }
+
             // Only the master is allowed to save
             if (rank == MPIImage::ROOT)
             {
-                cout << "Flip_filter," <<
+                cout << (use_lut ? "LUT_" : "") << (fast_log ? "Fast_log_filter," : "Log_filter,") <<
                     "\"" << input_file << "\"" << "," <<
                     "\"" << output_file << "\"" << "," <<
-                    implementation << "," <<
+                    (is_auto_selected ? "auto:" : "") << implementation << layout <<
+                    (gather_mode.size() ? ":" + MPIImage::getGatherModeName(MPIImage::getGatherMode()) : "") <<
+                    (distribution_mode.size() ? ":" + MPIImage::getDistributionModeName(MPIImage::getDistributionMode()) : "") <<
+                    (collective_mode.size() ? ":" + MPIImage::getCollectiveModeName(MPIImage::getCollectiveMode()) : "") << "," <<
                     number_of_threads << "," <<
-                    chrono::duration<double>(end - start).count() << endl;
+                    chrono::duration<double>(end - start).count() << "," <<
+                    CpuTopology::getInstance().toCSV() << "," <<
+                    getImageKernelISA() << endl;
 
                 // Save the output
-                if (output_file.size())
-                {
-                    output.saveASCII(output_file);
-                }
+                saveOutput(output);
             }
         }
         // Not using MPI implementation
         else
         {
-            cout << "Flip_filter," <<
+            cout << (use_lut ? "LUT_" : "") << (fast_log ? "Fast_log_filter," : "Log_filter,") <<
                 "\"" << input_file << "\"" << "," <<
                 "\"" << output_file << "\"" << "," <<
-                implementation << "," <<
+                (is_auto_selected ? "auto:" : "") << implementation << "," <<
                 number_of_threads << "," <<
-                chrono::duration<double>(end - start).count() << endl;
+                chrono::duration<double>(end - start).count() << "," <<
+                CpuTopology::getInstance().toCSV() << "," <<
+                getImageKernelISA() << endl;
 
             // Save the output
-            if (output_file.size())
-            {
-                    output.saveASCII(output_file);
-            }
+            saveOutput(output);
         }
     }
     // An error occured
@@ -254,6 +442,16 @@ void parseCommandLine(int& argc, char** argv)
             {"implementation",  required_argument, nullptr,            'c'},
             {"inputFile",       required_argument, nullptr,            'i'},
             {"outputFile",      required_argument, nullptr,            'o'},
+            {"calibrate",       no_argument,       &force_calibration, 1},
+            {"physicalCores",   no_argument,       &physical_cores_only, 1},
+            {"fastLog",         no_argument,       &fast_log,          1},
+            {"lut",             no_argument,       &use_lut,           1},
+            {"isa",             required_argument, nullptr,            's'},
+            {"outputType",      required_argument, nullptr,            't'},
+            {"gather",          required_argument, nullptr,            'g'},
+            {"distribution",    required_argument, nullptr,            'd'},
+            {"chunkSize",       required_argument, nullptr,            'k'},
+            {"collectives",     required_argument, nullptr,            'l'},
             {"help",            no_argument,       nullptr,            'h'},
             {nullptr,           no_argument,       nullptr,            0}
         };
@@ -297,6 +495,30 @@ void parseCommandLine(int& argc, char** argv)
             output_file = optarg;
             break;
 
+        case 's':
+            isa = optarg;
+            break;
+
+        case 't':
+            output_type = optarg;
+            break;
+
+        case 'g':
+            gather_mode = optarg;
+            break;
+
+        case 'd':
+            distribution_mode = optarg;
+            break;
+
+        case 'k':
+            chunk_size = optarg;
+            break;
+
+        case 'l':
+            collective_mode = optarg;
+            break;
+
         case 'h':
             printHelp();
             break;
@@ -319,10 +541,52 @@ void printHelp()
     cout << "Usage: log -- Apply a log filter on all the pixels of the input image" << endl <<
         "--num <n>" << endl <<
         "-n <n>" << endl <<
-            "\tNumber of threads/processes" << endl << endl <<
+            "\tNumber of threads/processes. With hybrid, the number of threads of" << endl <<
+            "\tevery MPI process (default: the CPUs allowed to the process), the" << endl <<
+            "\tnumber of processes is given to mpirun" << endl << endl <<
         "--implementation <string>" << endl <<
         "-c <string>" << endl <<
-            "\tChoose implementation: serial|pthread|openmp|cuda|mpi" << endl << endl <<
+            "\tChoose implementation: serial|pthread|openmp|stdpar|cuda|mpi|hybrid|auto" << endl <<
+            "\tauto selects the implementation and the number of threads" << endl <<
+            "\t(at most <n> if given) using the cost models of this machine" << endl << endl <<
+        "--calibrate" << endl <<
+            "\tMeasure the cost models used by auto again" << endl << endl <<
+        "--physicalCores" << endl <<
+            "\tUse at most one thread per physical core (no SMT sibling)" << endl << endl <<
+        "--isa <string>" << endl <<
+            "\tInstruction set of the kernels: scalar|avx2|avx512|auto (default: auto," << endl <<
+            "\tthe widest one supported by this CPU, i.e. " << getImageKernelISA() << ")" << endl << endl <<
+        "--outputType <string>" << endl <<
+            "\tStorage of the output: float|fp16|bf16 (default: float). With fp16" << endl <<
+            "\tor bf16, the input is also filtered in 16 bits (serial), its runtime" << endl <<
+            "\tand its error against the float output are printed" << endl << endl <<
+        "--fastLog" << endl <<
+            "\tUse the SIMD log kernel (" << getImageKernelISA() << ", at most " <<
+            FAST_LOG_MAX_ULP_ERROR << " ULP of error) instead of the C library" << endl << endl <<
+        "--lut" << endl <<
+            "\tFilter a lookup table instead of every pixel (8-bit or 16-bit" << endl <<
+            "\tinput only, same output)" << endl << endl <<
+        "--gather <string>" << endl <<
+            "\tHow the MPI processes assemble the output:" << endl <<
+            "\tp2p|gatherv|allgatherv|pipelined|dynamic (default: gatherv). p2p sends" << endl <<
+            "\tthree messages per process to the master, allgatherv gives the whole" << endl <<
+            "\toutput to every process, pipelined sends every chunk as soon as it is" << endl <<
+            "\tcomputed, dynamic gives the next free tile to the first process that" << endl <<
+            "\tasks for it. The overlap efficiency of the transfers, and the number" << endl <<
+            "\tof pixels and the idle time of every process are printed" << endl << endl <<
+        "--chunkSize <n>" << endl <<
+            "\tNumber of pixels of the chunks sent by pipelined and of the tiles of" << endl <<
+            "\tdynamic (default: " << MPIImage::getChunkSize() << ")" << endl << endl <<
+        "--distribution <string>" << endl <<
+            "\tHow the MPI processes hold the image: replicated|scattered|shared" << endl <<
+            "\t(default: replicated). With scattered, only the master loads the" << endl <<
+            "\timage and every process holds its rows of the input and of the" << endl <<
+            "\toutput. With shared, the input and the output are held once per" << endl <<
+            "\tnode, in memory shared by the processes of the node" << endl << endl <<
+        "--collectives <string>" << endl <<
+            "\tHow the MPI processes assemble the output and reduce the statistics:" << endl <<
+            "\tflat|hierarchical (default: flat). hierarchical gathers and reduces" << endl <<
+            "\tin every node first, then between one process per node" << endl << endl <<
         "--inputFile <fname>" << endl <<
         "-i <fname>" << endl <<
             "\tInput file to process" << endl << endl <<
@@ -351,6 +615,36 @@ void checkInputParameters()
         cerr << "No output file to save the result." << endl;
     }
 
+    // Throw an exception if the 16-bit format is unknown
+    if (output_type.size() && toUpper(output_type) != "FLOAT")
+    {
+        HalfImage::getFormat(output_type);
+    }
+
+    // Throw an exception if the gather mode is unknown
+    if (gather_mode.size())
+    {
+        MPIImage::getGatherMode(gather_mode);
+    }
+
+    // Throw an exception if the chunk size is not a positive number
+    if (chunk_size.size() && atoi(chunk_size.c_str()) <= 0)
+    {
+        throw "The chunk size must be at least one pixel";
+    }
+
+    // Throw an exception if the distribution mode is unknown
+    if (distribution_mode.size())
+    {
+        MPIImage::getDistributionMode(distribution_mode);
+    }
+
+    // Throw an exception if the collective mode is unknown
+    if (collective_mode.size())
+    {
+        MPIImage::getCollectiveMode(collective_mode);
+    }
+
     if (!implementation.size())
     {
         implementation = "serial";
@@ -362,9 +656,12 @@ void checkInputParameters()
         if (toUpper(implementation) != "PTHREADS")
         if (toUpper(implementation) != "OPENMP")
         if (toUpper(implementation) != "OMP")
+        if (toUpper(implementation) != "STDPAR")
         if (toUpper(implementation) != "CUDA")
         if (toUpper(implementation) != "MPI")
-            throw "Invalid implementation. Valid options are serial, pthread, openmp, cuda, or mpi.";
+        if (toUpper(implementation) != "HYBRID")
+        if (toUpper(implementation) != "AUTO")
+            throw "Invalid implementation. Valid options are serial, pthread, openmp, stdpar, cuda, mpi, hybrid, or auto.";
 
         if (toUpper(implementation) == "CUDA")
             throw "CUDA implementation not supported as yet.";
@@ -386,3 +683,137 @@ string toUpper(const string& aString)
 
     return temp;
 }
+
+
+//--------------------------------------------------
+void selectImplementation(const string& anOperation)
+//--------------------------------------------------
+{
+    // The image size is needed to choose
+    preloaded_input.loadASCII(input_file);
+    unsigned int number_of_pixels = preloaded_input.getWidth() * preloaded_input.getHeight();
+
+    // Use at most the number of threads given by the user,
+    // or all the CPUs (physical cores) allowed
+    unsigned int max_number_of_threads =
+        CpuTopology::getInstance().resolveNumberOfThreads(number_of_threads, physical_cores_only);
+
+    // Measure the cost models once per machine
+    CostModel cost_model;
+    cost_model.loadOrCalibrate(max_number_of_threads, force_calibration);
+
+    CostModelChoice choice = cost_model.choose(anOperation,
+                                               number_of_pixels,
+                                               max_number_of_threads);
+
+    implementation = choice.implementation;
+    number_of_threads = choice.number_of_threads;
+    is_auto_selected = true;
+
+    // MPI is not considered as the number of processes is set by mpirun
+    cerr << "auto: " << anOperation << " on " << number_of_pixels <<
+        " pixels -> " << implementation;
+
+    if (number_of_threads)
+    {
+        cerr << " with " << number_of_threads << " threads";
+    }
+
+    cerr << " (" << choice.reason << ")" << endl;
+}
+
+
+//----------------------------------------------
+template<typename T> void loadInput(T& anImage)
+//----------------------------------------------
+{
+    // The image has already been loaded to select the implementation
+    if (preloaded_input.getWidth() * preloaded_input.getHeight())
+    {
+        anImage = preloaded_input;
+    }
+    else
+    {
+        anImage.loadASCII(input_file);
+    }
+}
+
+
+//---------------------------------------
+PointLUT createLUT(const Image& anImage)
+//---------------------------------------
+{
+    return PointLUT(anImage);
+}
+
+
+//------------------------------------------
+PointLUT createLUT(const MPIImage& anImage)
+//------------------------------------------
+{
+    // Every process records the values of its part only
+    return anImage.createLUT();
+}
+
+
+//------------------------------------------------------------------------------------
+template<typename T> T applyFilter(const T& anImage, float aMinValue, float aMaxValue)
+//------------------------------------------------------------------------------------
+{
+    // Filter the 256 or 65536 entries of a lookup table, then look up every pixel
+    if (use_lut)
+    {
+        return anImage.applyLUT(createLUT(anImage).shiftScaleFilter(-aMinValue, 1.0 / (aMaxValue - aMinValue)).logFilter());
+    }
+    // Filter every pixel
+    else
+    {
+        return anImage.shiftScaleFilter(-aMinValue, 1.0 / (aMaxValue - aMinValue)).logFilter();
+    }
+}
+
+
+//-------------------------------
+void saveOutput(Image& anOutput)
+//-------------------------------
+{
+    // Single precision
+    if (!output_type.size() || toUpper(output_type) == "FLOAT")
+    {
+        if (output_file.size())
+        {
+            anOutput.saveASCII(output_file);
+        }
+    }
+    // The filter is applied again to the input stored in 16-bit
+    // floating-point numbers, the result is compared with the
+    // single-precision output
+    else
+    {
+        Image input;
+        loadInput(input);
+        HalfImage half_input(input, HalfImage::getFormat(output_type));
+
+        // Filter the image
+        timestamp start = chrono::high_resolution_clock::now();
+        // Find the range, then filter every pixel
+        float min_value, max_value;
+        half_input.getMinMaxValues(min_value, max_value);
+        HalfImage half_output = half_input.shiftScaleFilter(-min_value, 1.0 / (max_value - min_value)).logFilter();
+        timestamp end = chrono::high_resolution_clock::now();
+
+        float max_absolute_error;
+        float max_relative_error;
+        half_output.getError(anOutput, max_absolute_error, max_relative_error);
+
+        cerr << "Output type " << HalfImage::getFormatName(half_output.getFormat()) <<
+            ": " << chrono::duration<double>(end - start).count() << " sec (serial)" <<
+            ", max absolute error " << max_absolute_error <<
+            ", max relative error " << max_relative_error << endl;
+
+        if (output_file.size())
+        {
+            half_output.saveASCII(output_file);
+        }
+    }
+}
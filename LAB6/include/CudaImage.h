@@ -89,6 +89,20 @@ public:
                 float aDefaultValue = 0.0);
 
 
+    //------------------------------------------------------------------------
+    /// Constructor to build an image whose pixels are not initialised
+    /// (see Image::NO_INIT).
+    /**
+    * @param aWidth: the width of the image
+    * @param aHeight: the height of the image
+    * @param aTag: NO_INIT
+    */
+    //------------------------------------------------------------------------
+    CudaImage(unsigned int aWidth,
+              unsigned int aHeight,
+              NoInit aTag);
+
+
     //--------------------------------------------------------------------------
     /// Destructor.
     //--------------------------------------------------------------------------
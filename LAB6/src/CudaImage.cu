@@ -215,6 +215,27 @@ CudaImage::CudaImage(unsigned int aWidth,
 }
 
 
+//-------------------------------------
+CudaImage::CudaImage(unsigned int aWidth,
+                     unsigned int aHeight,
+                     NoInit aTag):
+//-------------------------------------
+        Image(aWidth, aHeight, aTag),
+        m_p_device_memory(0),
+        m_computing_time(0),
+        m_host_to_device_transfer(0),
+        m_device_to_host_transfer(0),
+        m_device_to_device_transfer(0)
+//-------------------------------------
+{
+    getNumberOfDevices();
+
+    // Allocate the memory on device, there is nothing to copy
+    cudaMalloc((void**) &m_p_device_memory, sizeof(float) * m_width * m_height);
+    checkCudaError(__FILE__, __FUNCTION__, __LINE__);
+}
+
+
 //---------------------
 CudaImage::~CudaImage()
 //---------------------
@@ -348,8 +369,8 @@ void CudaImage::saveASCII(const std::string& aFileName)
 CudaImage CudaImage::operator!()
 //------------------------------
 {
-    // Create an image of the right size
-    CudaImage temp(getWidth(), getHeight(), 0.0);
+    // Create an image of the right size, every pixel is written on the device below
+    CudaImage temp(getWidth(), getHeight(), NO_INIT);
 
     // Configure the kernel
     unsigned int image_size = m_width * m_height;
@@ -406,8 +427,8 @@ CudaImage CudaImage::shiftScaleFilter(float aShiftValue,
                                       float aScaleValue)
 //------------------------------------------------------
 {
-    // Create an image of the right size
-    CudaImage temp(getWidth(), getHeight(), 0.0);
+    // Create an image of the right size, every pixel is written on the device below
+    CudaImage temp(getWidth(), getHeight(), NO_INIT);
 
     // Configure the kernel
     unsigned int image_size = m_width * m_height;
@@ -477,8 +498,8 @@ CudaImage CudaImage::getNormalized()
 CudaImage CudaImage::logFilter()
 //------------------------------
 {
-    // Create an image of the right size
-    CudaImage temp(getWidth(), getHeight(), 0.0);
+    // Create an image of the right size, every pixel is written on the device below
+    CudaImage temp(getWidth(), getHeight(), NO_INIT);
 
     // Configure the kernel
     unsigned int image_size = m_width * m_height;
@@ -532,8 +553,8 @@ CudaImage CudaImage::logFilter()
 CudaImage CudaImage::flipHorizontally()
 //-------------------------------------
 {
-    // Create an image of the right size
-    CudaImage temp(getWidth(), getHeight(), 0.0);
+    // Create an image of the right size, every pixel is written on the device below
+    CudaImage temp(getWidth(), getHeight(), NO_INIT);
 
     // Configure the kernel
     unsigned int image_size = m_width * m_height;
@@ -587,8 +608,8 @@ CudaImage CudaImage::flipHorizontally()
 CudaImage CudaImage::flipVertically()
 //-----------------------------------
 {
-    // Create an image of the right size
-    CudaImage temp(getWidth(), getHeight(), 0.0);
+    // Create an image of the right size, every pixel is written on the device below
+    CudaImage temp(getWidth(), getHeight(), NO_INIT);
 
     // Configure the kernel
     unsigned int image_size = m_width * m_height;